@@ -804,14 +804,16 @@ int spawnfd(int flags, pid_t *ppid, const char *path, const posix_spawn_file_act
     if (create_pipe(death_pipe, flags) == -1)
         goto err_free; /* failed to create the pipes, pass errno */
 
-    /* start the process */
+    /* start the process; posix_spawn returns the error instead of setting errno */
     if (flags & FFD_SPAWN_SEARCH_PATH) {
         /* use posix_spawnp */
-        if (posix_spawnp(&pid, path, file_actions, attrp, argv, envp) != 0)
-            goto err_close;
+        ret = posix_spawnp(&pid, path, file_actions, attrp, argv, envp);
     } else {
-        if (posix_spawn(&pid, path, file_actions, attrp, argv, envp) != 0)
-            goto err_close;
+        ret = posix_spawn(&pid, path, file_actions, attrp, argv, envp);
+    }
+    if (ret != 0) {
+        errno = ret;
+        goto err_close;
     }
 
     if (ppid)
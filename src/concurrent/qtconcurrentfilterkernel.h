@@ -158,20 +158,64 @@ template <typename ReducedResultType,
                                           typename qValueType<Iterator>::value_type> >
 class FilteredReducedKernel : public IterateKernel<Iterator, ReducedResultType>
 {
+    typedef std::is_same<ReducedResultType,
+                         typename qValueType<Iterator>::value_type> CanReduceInParallel;
+
     ReducedResultType reducedResult;
     KeepFunctor keep;
     ReduceFunctor reduce;
     Reducer reducer;
+    ParallelReducer<ReduceFunctor, ReducedResultType> parallelReducer;
+    bool parallelReduce;
     typedef IterateKernel<Iterator, ReducedResultType> IterateKernelType;
 
+    bool runParallelIterations(Iterator sequenceBeginIterator, int begin, int end, std::true_type)
+    {
+        Iterator it = sequenceBeginIterator;
+        std::advance(it, begin);
+        ReducedResultType partial = ReducedResultType();
+        bool kept = false;
+        for (int i = begin; i < end; ++i, std::advance(it, 1)) {
+            if (keep(*it)) {
+                reduce(partial, *it);
+                kept = true;
+            }
+        }
+        if (kept)
+            parallelReducer.reduceInto(reduce, begin / this->chunkSize, partial);
+        return false;
+    }
+
+    bool runParallelIterations(Iterator, int, int, std::false_type)
+    {
+        Q_UNREACHABLE();
+        return false;
+    }
+
+    void finishParallel(std::true_type)
+    {
+        parallelReducer.finish(reduce, reducedResult);
+    }
+
+    void finishParallel(std::false_type) { }
+
 public:
     FilteredReducedKernel(Iterator begin,
                           Iterator end,
                           KeepFunctor _keep,
                           ReduceFunctor _reduce,
                           ReduceOptions reduceOption)
-        : IterateKernelType(begin, end), reducedResult(), keep(_keep), reduce(_reduce), reducer(reduceOption)
-    { }
+        : IterateKernelType(begin, end), reducedResult(), keep(_keep), reduce(_reduce), reducer(reduceOption),
+          parallelReduce(false)
+    {
+        if (CanReduceInParallel::value && (reduceOption & ParallelReduce)) {
+            const int chunkCount = this->enableStaticPartitioning();
+            if (chunkCount > 0) {
+                parallelReducer.setChunkCount(chunkCount);
+                parallelReduce = true;
+            }
+        }
+    }
 
 #if 0
     FilteredReducedKernel(ReducedResultType initialValue,
@@ -197,6 +241,9 @@ public:
 
     bool runIterations(Iterator sequenceBeginIterator, int begin, int end, ReducedResultType *) override
     {
+        if (parallelReduce)
+            return runParallelIterations(sequenceBeginIterator, begin, end, CanReduceInParallel());
+
         IntermediateResults<typename qValueType<Iterator>::value_type> results;
         results.begin = begin;
         results.end = end;
@@ -216,7 +263,10 @@ public:
 
     void finish() override
     {
-        reducer.finish(reduce, reducedResult);
+        if (parallelReduce)
+            finishParallel(CanReduceInParallel());
+        else
+            reducer.finish(reduce, reducedResult);
     }
 
     inline bool shouldThrottleThread() override
@@ -184,11 +184,35 @@ public:
 
     IterateKernel(Iterator _begin, Iterator _end)
         : begin(_begin), end(_end), current(_begin), currentIndex(0),
-           forIteration(selectIteration(typename std::iterator_traits<Iterator>::iterator_category())), progressReportingEnabled(true)
+           forIteration(selectIteration(typename std::iterator_traits<Iterator>::iterator_category())), progressReportingEnabled(true),
+           staticPartitioning(false), chunkSize(0)
     {
         iterationCount =  forIteration ? std::distance(_begin, _end) : 0;
     }
 
+    /*
+        Splits a random access range into one chunk per thread instead of
+        adapting the block size while running. Chunks are rounded up to
+        whole cache lines of input, so that neighbouring threads do not
+        share them. Returns the number of chunks, or 0 if the range can't
+        be partitioned up front.
+    */
+    int enableStaticPartitioning()
+    {
+        if (!forIteration || iterationCount <= 0)
+            return 0;
+
+        enum { CacheLineSize = 64 };
+        typedef typename std::iterator_traits<Iterator>::value_type ValueType;
+        const int valuesPerCacheLine = qMax(1, int(CacheLineSize / sizeof(ValueType)));
+        const int threadCount = qMax(1, this->threadPool->maxThreadCount());
+
+        chunkSize = (iterationCount + threadCount - 1) / threadCount;
+        chunkSize = (chunkSize + valuesPerCacheLine - 1) / valuesPerCacheLine * valuesPerCacheLine;
+        staticPartitioning = true;
+        return (iterationCount + chunkSize - 1) / chunkSize;
+    }
+
     virtual ~IterateKernel() { }
 
     virtual bool runIteration(Iterator it, int index , T *result)
@@ -228,7 +252,7 @@ public:
             if (this->isCanceled())
                 break;
 
-            const int currentBlockSize = blockSizeManager.blockSize();
+            const int currentBlockSize = staticPartitioning ? chunkSize : blockSizeManager.blockSize();
 
             if (currentIndex.load() >= iterationCount)
                 break;
@@ -248,14 +272,18 @@ public:
                 this->startThread();
 
             const int finalBlockSize = endIndex - beginIndex; // block size adjusted for possible end-of-range
-            resultReporter.reserveSpace(finalBlockSize);
+            // with static partitioning, chunks are reduced in place and report no results
+            if (!staticPartitioning)
+                resultReporter.reserveSpace(finalBlockSize);
 
             // Call user code with the current iteration range.
-            blockSizeManager.timeBeforeUser();
+            if (!staticPartitioning)
+                blockSizeManager.timeBeforeUser();
             const bool resultsAvailable = this->runIterations(begin, beginIndex, endIndex, resultReporter.getPointer());
-            blockSizeManager.timeAfterUser();
+            if (!staticPartitioning)
+                blockSizeManager.timeAfterUser();
 
-            if (resultsAvailable)
+            if (resultsAvailable && !staticPartitioning)
                 resultReporter.reportResults(beginIndex);
 
             // Report progress if progress reporting enabled.
@@ -318,6 +346,8 @@ public:
 
     bool progressReportingEnabled;
     QAtomicInt completed;
+    bool staticPartitioning;
+    int chunkSize;
 };
 
 } // namespace QtConcurrent
@@ -127,8 +127,22 @@
     \value OrderedReduce Reduction is done in the order of the
     original sequence.
     \value SequentialReduce Reduction is done sequentially: only one
-    thread will enter the reduce function at a time. (Parallel reduction
-    might be supported in a future version of Qt Concurrent.)
+    thread will enter the reduce function at a time.
+    \value ParallelReduce Reduction is done in parallel. A random access
+    range is split up front into one chunk per thread, and each thread
+    reduces every intermediate result of its chunk into a default-constructed
+    partial result of its own. The partial results are then combined
+    pairwise, in the order of the original sequence, by calling the reduce
+    function with a partial result as the intermediate. This avoids queueing
+    intermediate results, but requires the result type of the reduce
+    function to be the same as the type of the intermediate results, and
+    the reduce function to be associative: reducing a partial result must
+    give the same as reducing the intermediates it was built from one by
+    one. Summing, appending and taking the minimum or maximum qualify, but
+    summing squares, for instance, does not. If the types differ, and for
+    ranges that are not random access, this flag has no effect. The reduce function may be called by
+    several threads at the same time, each with a different result
+    variable. This enum value was introduced in Qt 5.14.
 */
 
 /*!
@@ -91,20 +91,60 @@ template <typename ReducedResultType,
                                           typename MapFunctor::result_type> >
 class MappedReducedKernel : public IterateKernel<Iterator, ReducedResultType>
 {
+    typedef std::is_same<ReducedResultType,
+                         typename std::decay<typename MapFunctor::result_type>::type> CanReduceInParallel;
+
     ReducedResultType reducedResult;
     MapFunctor map;
     ReduceFunctor reduce;
     Reducer reducer;
+    ParallelReducer<ReduceFunctor, ReducedResultType> parallelReducer;
+    bool parallelReduce;
+
+    bool runParallelIterations(Iterator sequenceBeginIterator, int begin, int end, std::true_type)
+    {
+        Iterator it = sequenceBeginIterator;
+        std::advance(it, begin);
+        ReducedResultType partial = ReducedResultType();
+        for (int i = begin; i < end; ++i, std::advance(it, 1))
+            reduce(partial, map(*it));
+
+        parallelReducer.reduceInto(reduce, begin / this->chunkSize, partial);
+        return false;
+    }
+
+    bool runParallelIterations(Iterator, int, int, std::false_type)
+    {
+        Q_UNREACHABLE();
+        return false;
+    }
+
+    void finishParallel(std::true_type)
+    {
+        parallelReducer.finish(reduce, reducedResult);
+    }
+
+    void finishParallel(std::false_type) { }
+
 public:
     typedef ReducedResultType ReturnType;
     MappedReducedKernel(Iterator begin, Iterator end, MapFunctor _map, ReduceFunctor _reduce, ReduceOptions reduceOptions)
-        : IterateKernel<Iterator, ReducedResultType>(begin, end), reducedResult(), map(_map), reduce(_reduce), reducer(reduceOptions)
-    { }
+        : IterateKernel<Iterator, ReducedResultType>(begin, end), reducedResult(), map(_map), reduce(_reduce), reducer(reduceOptions),
+          parallelReduce(false)
+    {
+        if (CanReduceInParallel::value && (reduceOptions & ParallelReduce)) {
+            const int chunkCount = this->enableStaticPartitioning();
+            if (chunkCount > 0) {
+                parallelReducer.setChunkCount(chunkCount);
+                parallelReduce = true;
+            }
+        }
+    }
 
     MappedReducedKernel(ReducedResultType initialValue,
                      MapFunctor _map,
                      ReduceFunctor _reduce)
-        : reducedResult(initialValue), map(_map), reduce(_reduce)
+        : reducedResult(initialValue), map(_map), reduce(_reduce), parallelReduce(false)
     { }
 
     bool runIteration(Iterator it, int index, ReducedResultType *) override
@@ -120,6 +160,9 @@ public:
 
     bool runIterations(Iterator sequenceBeginIterator, int begin, int end, ReducedResultType *) override
     {
+        if (parallelReduce)
+            return runParallelIterations(sequenceBeginIterator, begin, end, CanReduceInParallel());
+
         IntermediateResults<typename MapFunctor::result_type> results;
         results.begin = begin;
         results.end = end;
@@ -138,7 +181,10 @@ public:
 
     void finish() override
     {
-        reducer.finish(reduce, reducedResult);
+        if (parallelReduce)
+            finishParallel(CanReduceInParallel());
+        else
+            reducer.finish(reduce, reducedResult);
     }
 
     bool shouldThrottleThread() override
@@ -90,8 +90,8 @@ public:
 enum ReduceOption {
     UnorderedReduce = 0x1,
     OrderedReduce = 0x2,
-    SequentialReduce = 0x4
-    // ParallelReduce = 0x8
+    SequentialReduce = 0x4,
+    ParallelReduce = 0x8
 };
 Q_DECLARE_FLAGS(ReduceOptions, ReduceOption)
 #ifndef Q_CLANG_QDOC
@@ -219,6 +219,70 @@ public:
     }
 };
 
+/*
+    ParallelReducer is used instead of ReduceKernel for ParallelReduce.
+    The range is statically partitioned, and each chunk is reduced by the
+    thread that runs it, starting from a default-constructed result and
+    passing every element through the reduce function, into a slot of its
+    own. Once all chunks are done, the slots are combined pairwise, in
+    order, by reducing one partial result into another. This requires the
+    intermediate and the reduced result to be of the same type, and the
+    reduce function to combine partial results the same way it does
+    single intermediates (as summing, appending or taking the maximum do).
+*/
+template <typename ReduceFunctor, typename ReduceResultType>
+class ParallelReducer
+{
+    struct Partial
+    {
+        Partial() : value(), valid(false) { }
+        ReduceResultType value;
+        bool valid;
+    };
+    QVector<Partial> partials;
+
+public:
+    void setChunkCount(int chunkCount)
+    {
+        partials.resize(chunkCount);
+    }
+
+    // only called by the thread running the chunk
+    void reduceInto(ReduceFunctor &reduce, int chunk, const ReduceResultType &value)
+    {
+        Partial &partial = partials[chunk];
+        if (partial.valid) {
+            reduce(partial.value, value);
+        } else {
+            partial.value = value;
+            partial.valid = true;
+        }
+    }
+
+    // final reduction
+    void finish(ReduceFunctor &reduce, ReduceResultType &r)
+    {
+        const int count = partials.size();
+        for (int step = 1; step < count; step *= 2) {
+            for (int i = 0; i + step < count; i += 2 * step) {
+                Partial &left = partials[i];
+                const Partial &right = partials.at(i + step);
+                if (!right.valid)
+                    continue;
+                if (left.valid) {
+                    reduce(left.value, right.value);
+                } else {
+                    left.value = right.value;
+                    left.valid = true;
+                }
+            }
+        }
+        if (count > 0 && partials.at(0).valid)
+            reduce(r, partials.at(0).value);
+        partials.clear();
+    }
+};
+
 template <typename Sequence, typename Base, typename Functor1, typename Functor2>
 struct SequenceHolder2 : public Base
 {
@@ -370,6 +370,570 @@ static inline const uchar *simdFindNonAscii(const uchar *src, const uchar *end,
 }
 #endif
 
+// Multi-byte UTF-8 is handled in windows of 16 bytes. Each window is validated
+// with the lookup algorithm by John Keiser and Daniel Lemire ("Validating UTF-8
+// In Less Than One Instruction Per Byte"): three nibble lookups classify each
+// pair of consecutive bytes and the result is combined with a check on the
+// third and fourth bytes of the longer sequences. A window always starts at a
+// character boundary and we only consume the characters that end at least one
+// byte before the end of the window, so the byte that follows each of them has
+// been validated too. Windows containing an error are left to the scalar code,
+// which knows how to insert replacement characters.
+//
+// Decoding computes, for every byte that ends a character, the UTF-16 code unit
+// of that character; for four-byte sequences the high surrogate is computed in
+// the position of the third byte. The code units are then compacted with a
+// byte shuffle, eight at a time. Both the decoder and the encoder may write
+// garbage past the last code unit or byte they produced, but never past the
+// worst case size of the output the callers allocate.
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+enum Utf8ValidationFlags {
+    TooShort = 1 << 0,      // 11______ 0_______ or 11______ 11______
+    TooLong = 1 << 1,       // 0_______ 10______
+    Overlong3 = 1 << 2,     // 11100000 100_____
+    TooLarge = 1 << 3,      // 11110100 1001____, 11110100 101_____, 11110101+ 10______
+    Surrogate = 1 << 4,     // 11101101 101_____
+    Overlong2 = 1 << 5,     // 1100000_ 10______
+    TooLarge1000 = 1 << 6,  // 11110101+ 1000____
+    Overlong4 = 1 << 6,     // 11110000 1000____
+    TwoConts = 1 << 7,      // 10______ 10______
+    Carry = TooShort | TooLong | TwoConts
+};
+
+#define UTF8_BYTE1_HIGH_TABLE \
+    /* 0_______: ASCII */ \
+    TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, \
+    /* 10______: continuation */ \
+    TwoConts, TwoConts, TwoConts, TwoConts, \
+    /* 1100____, 1101____: two-byte lead */ \
+    TooShort | Overlong2, \
+    TooShort, \
+    /* 1110____: three-byte lead */ \
+    TooShort | Overlong3 | Surrogate, \
+    /* 1111____: four-byte lead */ \
+    TooShort | TooLarge | TooLarge1000 | Overlong4
+
+#define UTF8_BYTE1_LOW_TABLE \
+    Carry | Overlong3 | Overlong2 | Overlong4,  /* ____0000 */ \
+    Carry | Overlong2,                          /* ____0001 */ \
+    Carry,                                      /* ____001_ */ \
+    Carry, \
+    Carry | TooLarge,                           /* ____0100 */ \
+    Carry | TooLarge | TooLarge1000,            /* ____0101 */ \
+    Carry | TooLarge | TooLarge1000,            /* ____011_ */ \
+    Carry | TooLarge | TooLarge1000, \
+    Carry | TooLarge | TooLarge1000,            /* ____1___ */ \
+    Carry | TooLarge | TooLarge1000, \
+    Carry | TooLarge | TooLarge1000, \
+    Carry | TooLarge | TooLarge1000, \
+    Carry | TooLarge | TooLarge1000, \
+    Carry | TooLarge | TooLarge1000 | Surrogate, /* ____1101 */ \
+    Carry | TooLarge | TooLarge1000, \
+    Carry | TooLarge | TooLarge1000
+
+#define UTF8_BYTE2_HIGH_TABLE \
+    /* 0_______: ASCII */ \
+    TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, \
+    /* 1000____ */ \
+    TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4, \
+    /* 1001____ */ \
+    TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge, \
+    /* 101_____ */ \
+    TooLong | Overlong2 | TwoConts | Surrogate | TooLarge, \
+    TooLong | Overlong2 | TwoConts | Surrogate | TooLarge, \
+    /* 11______: lead */ \
+    TooShort, TooShort, TooShort, TooShort
+
+// the indexes of the bits set in mask, one per byte
+static Q_DECL_CONSTEXPR quint64 utf8CompactionEntry(uint mask, uint bit = 0, uint n = 0) Q_DECL_NOTHROW
+{
+    return bit == 8 ? 0
+         : mask & (1U << bit) ? (quint64(bit) << (8 * n)) | utf8CompactionEntry(mask, bit + 1, n + 1)
+         : utf8CompactionEntry(mask, bit + 1, n);
+}
+
+#define UTF8_COMPACTION_ENTRIES4(m) \
+    utf8CompactionEntry(m), utf8CompactionEntry(m + 1), utf8CompactionEntry(m + 2), utf8CompactionEntry(m + 3)
+#define UTF8_COMPACTION_ENTRIES16(m) \
+    UTF8_COMPACTION_ENTRIES4(m), UTF8_COMPACTION_ENTRIES4(m + 4), \
+    UTF8_COMPACTION_ENTRIES4(m + 8), UTF8_COMPACTION_ENTRIES4(m + 12)
+#define UTF8_COMPACTION_ENTRIES64(m) \
+    UTF8_COMPACTION_ENTRIES16(m), UTF8_COMPACTION_ENTRIES16(m + 16), \
+    UTF8_COMPACTION_ENTRIES16(m + 32), UTF8_COMPACTION_ENTRIES16(m + 48)
+
+static const quint64 utf8CompactionTable[256] = {
+    UTF8_COMPACTION_ENTRIES64(0), UTF8_COMPACTION_ENTRIES64(64),
+    UTF8_COMPACTION_ENTRIES64(128), UTF8_COMPACTION_ENTRIES64(192)
+};
+
+#undef UTF8_COMPACTION_ENTRIES4
+#undef UTF8_COMPACTION_ENTRIES16
+#undef UTF8_COMPACTION_ENTRIES64
+
+static Q_ALWAYS_INLINE void utf8StoreEncoded(uchar *&dst, const quint32 *encoded, const ushort *src, int count) Q_DECL_NOTHROW
+{
+    // the caller guarantees that there's room for one more byte at the end
+    for (int i = 0; i < count; ++i) {
+        qToLittleEndian(encoded[i], dst);
+        dst += 1 + (src[i] >= 0x80) + (src[i] >= 0x800);
+    }
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+// returns the mask of the bytes that end a character, or 0 if the window is not valid UTF-8
+QT_FUNCTION_TARGET(AVX2)
+static inline uint utf8ValidateWindowAvx2(__m128i data) Q_DECL_NOTHROW
+{
+    const __m128i byte1HighTable = _mm_setr_epi8(UTF8_BYTE1_HIGH_TABLE);
+    const __m128i byte1LowTable = _mm_setr_epi8(UTF8_BYTE1_LOW_TABLE);
+    const __m128i byte2HighTable = _mm_setr_epi8(UTF8_BYTE2_HIGH_TABLE);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+
+    // the window starts at a character boundary, so shift in ASCII
+    const __m128i prev1 = _mm_slli_si128(data, 1);
+    const __m128i prev2 = _mm_slli_si128(data, 2);
+    const __m128i prev3 = _mm_slli_si128(data, 3);
+
+    __m128i special = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibbleMask));
+    special = _mm_and_si128(special, _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(prev1, nibbleMask)));
+    special = _mm_and_si128(special, _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(data, 4), nibbleMask)));
+
+    // only third and fourth bytes of a sequence may follow two continuation bytes
+    __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(char(0xe0 - 0x80))),
+                                  _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xf0 - 0x80))));
+    must23 = _mm_and_si128(must23, _mm_set1_epi8(char(0x80)));
+    const __m128i error = _mm_xor_si128(must23, special);
+    if (!_mm_testz_si128(error, error))
+        return 0;
+
+    const __m128i cont = _mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xc0))), _mm_set1_epi8(char(0x80)));
+    return (~uint(_mm_movemask_epi8(cont)) >> 1) & 0x7fff;
+}
+
+// stores the code units in the positions selected by mask
+QT_FUNCTION_TARGET(AVX2)
+static inline ushort *utf8CompactStoreAvx2(ushort *dst, __m128i units, uint mask) Q_DECL_NOTHROW
+{
+    __m128i shuffle = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(utf8CompactionTable + mask));
+    shuffle = _mm_add_epi8(shuffle, shuffle);
+    shuffle = _mm_unpacklo_epi8(shuffle, _mm_add_epi8(shuffle, _mm_set1_epi8(1)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(units, shuffle));
+    return dst + qPopulationCount(mask);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static bool simdDecodeNonAsciiAvx2(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end) Q_DECL_NOTHROW
+{
+    while (end - src >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        if (!_mm_movemask_epi8(data)) {
+            // let simdDecodeAscii handle it
+            nextAscii = src;
+            return false;
+        }
+
+        const uint ends = utf8ValidateWindowAvx2(data);
+        if (!ends) {
+            nextAscii = src + 16;
+            return false;
+        }
+
+        const __m128i cont = _mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xc0))), _mm_set1_epi8(char(0x80)));
+        const __m128i prev1 = _mm_slli_si128(data, 1);
+        const __m128i prev2 = _mm_slli_si128(data, 2);
+        const __m128i prev3 = _mm_slli_si128(data, 3);
+
+        // how many bytes precede the one in each position, in the same sequence
+        const __m128i has1 = cont;
+        const __m128i has2 = _mm_and_si128(has1, _mm_slli_si128(cont, 1));
+        const __m128i has3 = _mm_and_si128(has2, _mm_slli_si128(cont, 2));
+
+        const __m128i c0 = _mm_and_si128(data, _mm_or_si128(_mm_cmpgt_epi8(data, _mm_set1_epi8(-1)), _mm_set1_epi8(0x3f)));
+        const __m128i c1 = _mm_and_si128(_mm_and_si128(prev1, has1),
+                                         _mm_or_si128(_mm_set1_epi8(0x1f), _mm_and_si128(has2, _mm_set1_epi8(0x20))));
+        const __m128i c2 = _mm_and_si128(_mm_and_si128(prev2, has2),
+                                         _mm_or_si128(_mm_set1_epi8(0x0f), _mm_and_si128(has3, _mm_set1_epi8(0x30))));
+        const __m128i c3 = _mm_and_si128(_mm_and_si128(prev3, has3), _mm_set1_epi8(0x07));
+
+        // one to three byte sequences
+        const __m256i w0 = _mm256_cvtepu8_epi16(c0);
+        const __m256i w1 = _mm256_cvtepu8_epi16(c1);
+        __m256i units = _mm256_or_si256(_mm256_or_si256(w0, _mm256_slli_epi16(w1, 6)),
+                                        _mm256_slli_epi16(_mm256_cvtepu8_epi16(c2), 12));
+
+        uint mask = ends;
+        const uint fourByte = uint(_mm_movemask_epi8(has3)) & ends;
+        if (fourByte) {
+            // low surrogate in the position of the last byte
+            const __m256i low = _mm256_or_si256(_mm256_set1_epi16(short(0xdc00)),
+                                                _mm256_or_si256(w0, _mm256_slli_epi16(_mm256_and_si256(w1, _mm256_set1_epi16(0x0f)), 6)));
+            units = _mm256_blendv_epi8(units, low, _mm256_cvtepi8_epi16(has3));
+
+            // high surrogate in the position of the third byte
+            const __m256i s1 = _mm256_cvtepu8_epi16(_mm_srli_si128(c1, 1));
+            const __m256i s2 = _mm256_cvtepu8_epi16(_mm_srli_si128(c2, 1));
+            const __m256i s3 = _mm256_cvtepu8_epi16(_mm_srli_si128(c3, 1));
+            __m256i high = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(s3, 8), _mm256_slli_epi16(s2, 2)),
+                                           _mm256_srli_epi16(s1, 4));
+            high = _mm256_add_epi16(high, _mm256_set1_epi16(short(0xd800 - (0x10000 >> 10))));
+            units = _mm256_blendv_epi8(units, high, _mm256_cvtepi8_epi16(_mm_srli_si128(has3, 1)));
+            mask |= fourByte >> 1;
+        }
+
+        dst = utf8CompactStoreAvx2(dst, _mm256_castsi256_si128(units), mask & 0xff);
+        dst = utf8CompactStoreAvx2(dst, _mm256_extracti128_si256(units, 1), mask >> 8);
+        src += 32 - qCountLeadingZeroBits(ends);
+    }
+    nextAscii = end;
+    return src == end;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static const uchar *simdFindInvalidUtf8Avx2(const uchar *src, const uchar *end, const uchar *&nextAscii) Q_DECL_NOTHROW
+{
+    while (end - src >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        if (!_mm_movemask_epi8(data))
+            break;
+        const uint ends = utf8ValidateWindowAvx2(data);
+        if (!ends) {
+            nextAscii = src + 16;
+            return src;
+        }
+        src += 32 - qCountLeadingZeroBits(ends);
+    }
+    nextAscii = src;
+    return src;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static bool simdEncodeNonAsciiAvx2(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end) Q_DECL_NOTHROW
+{
+    // the loop below may write up to four bytes past the output of the last
+    // character, so keep two characters in reserve to guarantee there's room
+    while (end - src >= 10) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(short(0xf800))),
+                                                   _mm_set1_epi16(short(0xd800)));
+        if (!_mm_testz_si128(surrogates, surrogates)) {
+            // leave surrogate pairs and errors to the scalar code
+            nextAscii = qMax(nextAscii, src + 8);
+            return false;
+        }
+        if (_mm_testz_si128(data, _mm_set1_epi16(short(0xff80)))) {
+            // let simdEncodeAscii handle it
+            nextAscii = src;
+            return false;
+        }
+
+        const __m128i zero = _mm_setzero_si128();
+        const uint asciiChars = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(short(0xff80))), zero));
+        const uint narrowChars = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(short(0xf800))), zero));
+        if (!asciiChars && narrowChars == 0xffff) {
+            // 110xxxxx 10xxxxxx only
+            const __m128i encoded = _mm_or_si128(_mm_or_si128(_mm_srli_epi16(data, 6), _mm_set1_epi16(short(0x80c0))),
+                                                 _mm_slli_epi16(_mm_and_si128(data, _mm_set1_epi16(0x3f)), 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), encoded);
+            dst += 16;
+            src += 8;
+            continue;
+        }
+
+        const __m256i u = _mm256_cvtepu16_epi32(data);
+        const __m256i lowBits = _mm256_or_si256(_mm256_and_si256(u, _mm256_set1_epi32(0x3f)), _mm256_set1_epi32(0x80));
+        const __m256i midBits = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(u, 6), _mm256_set1_epi32(0x3f)),
+                                                _mm256_set1_epi32(0x80));
+
+        // 1110xxxx 10xxxxxx 10xxxxxx
+        const __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(u, 12), _mm256_set1_epi32(0xe0)),
+                                              _mm256_or_si256(_mm256_slli_epi32(midBits, 8), _mm256_slli_epi32(lowBits, 16)));
+        if (!narrowChars) {
+            const __m256i packed = _mm256_shuffle_epi8(three, _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                                               0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(packed));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 12), _mm256_extracti128_si256(packed, 1));
+            dst += 24;
+            src += 8;
+            continue;
+        }
+
+        // 110xxxxx 10xxxxxx
+        const __m256i two = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(u, 6), _mm256_set1_epi32(0xc0)),
+                                            _mm256_slli_epi32(lowBits, 8));
+        const __m256i isAscii = _mm256_cmpgt_epi32(_mm256_set1_epi32(0x80), u);
+        const __m256i isTwo = _mm256_cmpgt_epi32(_mm256_set1_epi32(0x800), u);
+        __m256i encoded = _mm256_blendv_epi8(three, two, isTwo);
+        encoded = _mm256_blendv_epi8(encoded, u, isAscii);
+
+        Q_DECL_ALIGN(32) quint32 buffer[8];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(buffer), encoded);
+        utf8StoreEncoded(dst, buffer, src, 8);
+        src += 8;
+    }
+    nextAscii = end;
+    return src == end;
+}
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+static Q_ALWAYS_INLINE uint utf8MoveMask(uint8x16_t v) Q_DECL_NOTHROW
+{
+    const uint8x16_t bits = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7,
+                              1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    v = vandq_u8(v, bits);
+    return vaddv_u8(vget_low_u8(v)) | (uint(vaddv_u8(vget_high_u8(v))) << 8);
+}
+
+// returns the mask of the bytes that end a character, or 0 if the window is not valid UTF-8
+static inline uint utf8ValidateWindowNeon(uint8x16_t data) Q_DECL_NOTHROW
+{
+    const uint8x16_t byte1HighTable = { UTF8_BYTE1_HIGH_TABLE };
+    const uint8x16_t byte1LowTable = { UTF8_BYTE1_LOW_TABLE };
+    const uint8x16_t byte2HighTable = { UTF8_BYTE2_HIGH_TABLE };
+    const uint8x16_t nibbleMask = vdupq_n_u8(0x0f);
+    const uint8x16_t zero = vdupq_n_u8(0);
+
+    // the window starts at a character boundary, so shift in ASCII
+    const uint8x16_t prev1 = vextq_u8(zero, data, 15);
+    const uint8x16_t prev2 = vextq_u8(zero, data, 14);
+    const uint8x16_t prev3 = vextq_u8(zero, data, 13);
+
+    uint8x16_t special = vqtbl1q_u8(byte1HighTable, vshrq_n_u8(prev1, 4));
+    special = vandq_u8(special, vqtbl1q_u8(byte1LowTable, vandq_u8(prev1, nibbleMask)));
+    special = vandq_u8(special, vqtbl1q_u8(byte2HighTable, vshrq_n_u8(data, 4)));
+
+    // only third and fourth bytes of a sequence may follow two continuation bytes
+    uint8x16_t must23 = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xe0 - 0x80)),
+                                 vqsubq_u8(prev3, vdupq_n_u8(0xf0 - 0x80)));
+    must23 = vandq_u8(must23, vdupq_n_u8(0x80));
+    if (vmaxvq_u8(veorq_u8(must23, special)))
+        return 0;
+
+    const uint8x16_t cont = vceqq_u8(vandq_u8(data, vdupq_n_u8(0xc0)), vdupq_n_u8(0x80));
+    return (~utf8MoveMask(cont) >> 1) & 0x7fff;
+}
+
+// stores the code units in the positions selected by mask
+static inline ushort *utf8CompactStoreNeon(ushort *dst, uint16x8_t units, uint mask) Q_DECL_NOTHROW
+{
+    uint8x8_t shuffle = vld1_u8(reinterpret_cast<const uint8_t *>(utf8CompactionTable + mask));
+    shuffle = vadd_u8(shuffle, shuffle);
+    const uint8x8_t odd = vadd_u8(shuffle, vdup_n_u8(1));
+    const uint8x16_t bytes = vqtbl1q_u8(vreinterpretq_u8_u16(units),
+                                        vcombine_u8(vzip1_u8(shuffle, odd), vzip2_u8(shuffle, odd)));
+    vst1q_u16(dst, vreinterpretq_u16_u8(bytes));
+    return dst + qPopulationCount(mask);
+}
+
+static bool simdDecodeNonAsciiNeon(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end) Q_DECL_NOTHROW
+{
+    while (end - src >= 16) {
+        const uint8x16_t data = vld1q_u8(src);
+        if (vmaxvq_u8(data) < 0x80) {
+            // let simdDecodeAscii handle it
+            nextAscii = src;
+            return false;
+        }
+
+        const uint ends = utf8ValidateWindowNeon(data);
+        if (!ends) {
+            nextAscii = src + 16;
+            return false;
+        }
+
+        const uint8x16_t zero = vdupq_n_u8(0);
+        const uint8x16_t cont = vceqq_u8(vandq_u8(data, vdupq_n_u8(0xc0)), vdupq_n_u8(0x80));
+        const uint8x16_t prev1 = vextq_u8(zero, data, 15);
+        const uint8x16_t prev2 = vextq_u8(zero, data, 14);
+        const uint8x16_t prev3 = vextq_u8(zero, data, 13);
+
+        // how many bytes precede the one in each position, in the same sequence
+        const uint8x16_t has1 = cont;
+        const uint8x16_t has2 = vandq_u8(has1, vextq_u8(zero, cont, 15));
+        const uint8x16_t has3 = vandq_u8(has2, vextq_u8(zero, cont, 14));
+
+        const uint8x16_t c0 = vandq_u8(data, vorrq_u8(vcltq_u8(data, vdupq_n_u8(0x80)), vdupq_n_u8(0x3f)));
+        const uint8x16_t c1 = vandq_u8(vandq_u8(prev1, has1),
+                                       vorrq_u8(vdupq_n_u8(0x1f), vandq_u8(has2, vdupq_n_u8(0x20))));
+        const uint8x16_t c2 = vandq_u8(vandq_u8(prev2, has2),
+                                       vorrq_u8(vdupq_n_u8(0x0f), vandq_u8(has3, vdupq_n_u8(0x30))));
+        const uint8x16_t c3 = vandq_u8(vandq_u8(prev3, has3), vdupq_n_u8(0x07));
+
+        const uint16x8_t w0[2] = { vmovl_u8(vget_low_u8(c0)), vmovl_high_u8(c0) };
+        const uint16x8_t w1[2] = { vmovl_u8(vget_low_u8(c1)), vmovl_high_u8(c1) };
+        const uint16x8_t w2[2] = { vmovl_u8(vget_low_u8(c2)), vmovl_high_u8(c2) };
+        uint16x8_t units[2];
+        for (int i = 0; i < 2; ++i)
+            units[i] = vorrq_u16(vorrq_u16(w0[i], vshlq_n_u16(w1[i], 6)), vshlq_n_u16(w2[i], 12));
+
+        uint mask = ends;
+        const uint fourByte = utf8MoveMask(has3) & ends;
+        if (fourByte) {
+            const uint8x16_t s1 = vextq_u8(c1, zero, 1);
+            const uint8x16_t s2 = vextq_u8(c2, zero, 1);
+            const uint8x16_t s3 = vextq_u8(c3, zero, 1);
+            const uint8x16_t highPos = vextq_u8(has3, zero, 1);
+            const uint16x8_t w3[2] = { vmovl_u8(vget_low_u8(s3)), vmovl_high_u8(s3) };
+            const uint16x8_t ws2[2] = { vmovl_u8(vget_low_u8(s2)), vmovl_high_u8(s2) };
+            const uint16x8_t ws1[2] = { vmovl_u8(vget_low_u8(s1)), vmovl_high_u8(s1) };
+            const uint16x8_t lowSel[2] = { vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(vget_low_u8(has3)))),
+                                           vreinterpretq_u16_s16(vmovl_high_s8(vreinterpretq_s8_u8(has3))) };
+            const uint16x8_t highSel[2] = { vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(vget_low_u8(highPos)))),
+                                            vreinterpretq_u16_s16(vmovl_high_s8(vreinterpretq_s8_u8(highPos))) };
+            for (int i = 0; i < 2; ++i) {
+                // low surrogate in the position of the last byte
+                const uint16x8_t low = vorrq_u16(vdupq_n_u16(0xdc00),
+                                                 vorrq_u16(w0[i], vshlq_n_u16(vandq_u16(w1[i], vdupq_n_u16(0x0f)), 6)));
+                // high surrogate in the position of the third byte
+                uint16x8_t high = vorrq_u16(vorrq_u16(vshlq_n_u16(w3[i], 8), vshlq_n_u16(ws2[i], 2)),
+                                            vshrq_n_u16(ws1[i], 4));
+                high = vaddq_u16(high, vdupq_n_u16(0xd800 - (0x10000 >> 10)));
+                units[i] = vbslq_u16(lowSel[i], low, units[i]);
+                units[i] = vbslq_u16(highSel[i], high, units[i]);
+            }
+            mask |= fourByte >> 1;
+        }
+
+        dst = utf8CompactStoreNeon(dst, units[0], mask & 0xff);
+        dst = utf8CompactStoreNeon(dst, units[1], mask >> 8);
+        src += 32 - qCountLeadingZeroBits(ends);
+    }
+    nextAscii = end;
+    return src == end;
+}
+
+static const uchar *simdFindInvalidUtf8Neon(const uchar *src, const uchar *end, const uchar *&nextAscii) Q_DECL_NOTHROW
+{
+    while (end - src >= 16) {
+        const uint8x16_t data = vld1q_u8(src);
+        if (vmaxvq_u8(data) < 0x80)
+            break;
+        const uint ends = utf8ValidateWindowNeon(data);
+        if (!ends) {
+            nextAscii = src + 16;
+            return src;
+        }
+        src += 32 - qCountLeadingZeroBits(ends);
+    }
+    nextAscii = src;
+    return src;
+}
+
+static bool simdEncodeNonAsciiNeon(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end) Q_DECL_NOTHROW
+{
+    // the loop below may write up to four bytes past the output of the last
+    // character, so keep two characters in reserve to guarantee there's room
+    while (end - src >= 10) {
+        const uint16x8_t data = vld1q_u16(src);
+        const uint16x8_t surrogates = vceqq_u16(vandq_u16(data, vdupq_n_u16(0xf800)), vdupq_n_u16(0xd800));
+        if (vmaxvq_u16(surrogates)) {
+            // leave surrogate pairs and errors to the scalar code
+            nextAscii = qMax(nextAscii, src + 8);
+            return false;
+        }
+        const ushort highest = vmaxvq_u16(data);
+        if (highest < 0x80) {
+            // let simdEncodeAscii handle it
+            nextAscii = src;
+            return false;
+        }
+
+        const ushort lowest = vminvq_u16(data);
+        if (lowest >= 0x80 && highest < 0x800) {
+            // 110xxxxx 10xxxxxx only
+            const uint16x8_t encoded = vorrq_u16(vorrq_u16(vshrq_n_u16(data, 6), vdupq_n_u16(0x80c0)),
+                                                 vshlq_n_u16(vandq_u16(data, vdupq_n_u16(0x3f)), 8));
+            vst1q_u8(dst, vreinterpretq_u8_u16(encoded));
+            dst += 16;
+            src += 8;
+            continue;
+        }
+
+        Q_DECL_ALIGN(16) quint32 buffer[8];
+        const uint32x4_t halves[2] = { vmovl_u16(vget_low_u16(data)), vmovl_high_u16(data) };
+        for (int i = 0; i < 2; ++i) {
+            const uint32x4_t u = halves[i];
+            const uint32x4_t lowBits = vorrq_u32(vandq_u32(u, vdupq_n_u32(0x3f)), vdupq_n_u32(0x80));
+            const uint32x4_t midBits = vorrq_u32(vandq_u32(vshrq_n_u32(u, 6), vdupq_n_u32(0x3f)), vdupq_n_u32(0x80));
+
+            // 110xxxxx 10xxxxxx
+            const uint32x4_t two = vorrq_u32(vorrq_u32(vshrq_n_u32(u, 6), vdupq_n_u32(0xc0)), vshlq_n_u32(lowBits, 8));
+            // 1110xxxx 10xxxxxx 10xxxxxx
+            const uint32x4_t three = vorrq_u32(vorrq_u32(vshrq_n_u32(u, 12), vdupq_n_u32(0xe0)),
+                                               vorrq_u32(vshlq_n_u32(midBits, 8), vshlq_n_u32(lowBits, 16)));
+
+            uint32x4_t encoded = vbslq_u32(vcltq_u32(u, vdupq_n_u32(0x800)), two, three);
+            encoded = vbslq_u32(vcltq_u32(u, vdupq_n_u32(0x80)), u, encoded);
+            vst1q_u32(buffer + 4 * i, encoded);
+        }
+
+        if (lowest >= 0x800) {
+            // 1110xxxx 10xxxxxx 10xxxxxx only
+            const uint8x16_t pack = { 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0xff, 0xff, 0xff, 0xff };
+            vst1q_u8(dst, vqtbl1q_u8(vreinterpretq_u8_u32(vld1q_u32(buffer)), pack));
+            vst1q_u8(dst + 12, vqtbl1q_u8(vreinterpretq_u8_u32(vld1q_u32(buffer + 4)), pack));
+            dst += 24;
+        } else {
+            utf8StoreEncoded(dst, buffer, src, 8);
+        }
+        src += 8;
+    }
+    nextAscii = end;
+    return src == end;
+}
+#endif
+
+#undef UTF8_BYTE1_HIGH_TABLE
+#undef UTF8_BYTE1_LOW_TABLE
+#undef UTF8_BYTE2_HIGH_TABLE
+#endif
+
+// These return true if the entire input was consumed. Otherwise, they return
+// false and set nextAscii to where the scalar code should take over, or leave
+// it untouched if there's no vectorized implementation to use.
+static inline bool simdDecodeNonAscii(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return simdDecodeNonAsciiAvx2(dst, nextAscii, src, end);
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    return simdDecodeNonAsciiNeon(dst, nextAscii, src, end);
+#endif
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+    return false;
+}
+
+static inline bool simdEncodeNonAscii(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return simdEncodeNonAsciiAvx2(dst, nextAscii, src, end);
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    return simdEncodeNonAsciiNeon(dst, nextAscii, src, end);
+#endif
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+    return false;
+}
+
+// Skips over valid UTF-8 and returns the position where the scalar code should
+// continue checking up to nextAscii.
+static inline const uchar *simdFindInvalidUtf8(const uchar *src, const uchar *end, const uchar *&nextAscii)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return simdFindInvalidUtf8Avx2(src, end, nextAscii);
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    return simdFindInvalidUtf8Neon(src, end, nextAscii);
+#endif
+    Q_UNUSED(end);
+    Q_UNUSED(nextAscii);
+    return src;
+}
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -382,6 +946,8 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        if (simdEncodeNonAscii(dst, nextAscii, src, end))
+            break;
 
         do {
             ushort uc = *src++;
@@ -434,8 +1000,12 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
             surrogate_high = -1;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
         } else {
-            if (src >= nextAscii && simdEncodeAscii(cursor, nextAscii, src, end))
-                break;
+            if (src >= nextAscii) {
+                if (simdEncodeAscii(cursor, nextAscii, src, end))
+                    break;
+                if (simdEncodeNonAscii(cursor, nextAscii, src, end))
+                    break;
+            }
 
             uc = *src++;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
@@ -525,6 +1095,8 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) Q_DECL
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            if (simdDecodeNonAscii(dst, nextAscii, src, end))
+                break;
 
             do {
                 uchar b = *src++;
@@ -542,12 +1114,6 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) Q_DECL
 
 QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::ConverterState *state)
 {
-    bool headerdone = false;
-    ushort replacement = QChar::ReplacementCharacter;
-    int invalid = 0;
-    int res;
-    uchar ch = 0;
-
     // See above for buffer requirements for stateless decoding. However, that
     // fails if the state is not empty. The following situations can add to the
     // requirements:
@@ -559,8 +1125,30 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     //   2 of 3 bytes       same                        +1 (same)
     //   3 of 4 bytes       same                        +1 (same)
     QString result(len + 1, Qt::Uninitialized);
+    const bool hadRemainingChars = state && state->remainingChars;
+    QChar *end = convertToUnicode(result.data(), chars, len, state);
+    if (hadRemainingChars && end == result.constData() && state->remainingChars)
+        return QString();   // still in the middle of a sequence
+    result.truncate(end - result.constData());
+    return result;
+}
 
-    ushort *dst = reinterpret_cast<ushort *>(const_cast<QChar *>(result.constData()));
+/*!
+    \internal
+
+    Decodes \a len bytes of UTF-8 from \a chars into \a buffer, which must
+    have room for at least \a len + 1 characters, continuing from and
+    updating \a state. Returns a pointer past the last character written.
+*/
+QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len, QTextCodec::ConverterState *state)
+{
+    bool headerdone = false;
+    ushort replacement = QChar::ReplacementCharacter;
+    int invalid = 0;
+    int res;
+    uchar ch = 0;
+
+    ushort *dst = reinterpret_cast<ushort *>(buffer);
     const uchar *src = reinterpret_cast<const uchar *>(chars);
     const uchar *end = src + len;
 
@@ -592,7 +1180,7 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
                 // copy to our state and return
                 state->remainingChars = remainingCharsCount + newCharsToCopy;
                 memcpy(&state->state_data[0], remainingCharsData, state->remainingChars);
-                return QString();
+                return buffer;
             } else if (!headerdone && res >= 0) {
                 // eat the UTF-8 BOM
                 headerdone = true;
@@ -613,8 +1201,13 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     const uchar *nextAscii = src;
     const uchar *start = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            // the BOM is only removed by the scalar code
+            if (headerdone && simdDecodeNonAscii(dst, nextAscii, src, end))
+                break;
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -640,7 +1233,6 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
             *dst++ = QChar::ReplacementCharacter;
     }
 
-    result.truncate(dst - (const ushort *)result.unicode());
     if (state) {
         state->invalidChars += invalid;
         if (headerdone)
@@ -653,7 +1245,7 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
             state->remainingChars = 0;
         }
     }
-    return result;
+    return reinterpret_cast<QChar *>(dst);
 }
 
 struct QUtf8NoOutputTraits : public QUtf8BaseTraitsNoAscii
@@ -671,10 +1263,15 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(const char *chars, qsizetype len)
     bool isValidAscii = true;
 
     while (src < end) {
-        if (src >= nextAscii)
+        if (src >= nextAscii) {
             src = simdFindNonAscii(src, end, nextAscii);
-        if (src == end)
-            break;
+            if (src == end)
+                break;
+            if (*src & 0x80) {
+                isValidAscii = false;
+                src = simdFindInvalidUtf8(src, end, nextAscii);
+            }
+        }
 
         do {
             uchar b = *src++;
@@ -294,6 +294,7 @@ struct QUtf8
     static QChar *convertToUnicode(QChar *, const char *, int) Q_DECL_NOTHROW;
     static QString convertToUnicode(const char *, int);
     static QString convertToUnicode(const char *, int, QTextCodec::ConverterState *);
+    static QChar *convertToUnicode(QChar *, const char *, int, QTextCodec::ConverterState *);
     static QByteArray convertFromUnicode(const QChar *, int);
     static QByteArray convertFromUnicode(const QChar *, int, QTextCodec::ConverterState *);
     struct ValidUtf8Result {
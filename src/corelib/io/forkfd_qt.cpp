@@ -40,7 +40,10 @@
 // these might be defined via precompiled headers
 #include <QtCore/qatomic.h>
 
-#define FORKFD_NO_SPAWNFD
+// QProcess uses spawnfd() on Linux only
+#ifndef Q_OS_LINUX
+#  define FORKFD_NO_SPAWNFD
+#endif
 
 #if defined(QT_NO_DEBUG) && !defined(NDEBUG)
 #  define NDEBUG
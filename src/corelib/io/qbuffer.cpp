@@ -62,6 +62,7 @@ public:
 
     qint64 peek(char *data, qint64 maxSize) override;
     QByteArray peek(qint64 maxSize) override;
+    QByteArray directView(qint64 maxSize) override;
 
 #ifndef QT_NO_QOBJECT
     // private slots
@@ -99,6 +100,14 @@ QByteArray QBufferPrivate::peek(qint64 maxSize)
     return QByteArray(buf->constData() + pos, readBytes);
 }
 
+QByteArray QBufferPrivate::directView(qint64 maxSize)
+{
+    qint64 readBytes = qMax(Q_INT64_C(0), qMin(maxSize, static_cast<qint64>(buf->size()) - pos));
+    if (pos == 0 && maxSize >= buf->size())
+        return *buf;
+    return QByteArray::fromRawData(buf->constData() + pos, int(readBytes));
+}
+
 /*!
     \class QBuffer
     \inmodule QtCore
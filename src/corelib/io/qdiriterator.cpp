@@ -87,6 +87,14 @@
     enables iterating through all subdirectories of the assigned path,
     following all symbolic links. Symbolic link loops (e.g., "link" => "." or
     "link" => "..") are automatically detected and ignored.
+
+    \value PrefetchSubdirectories When combined with Subdirectories, this
+    flag makes the iterator read subdirectories ahead of time, in parallel,
+    on the global QThreadPool. Entries are still returned in the same order
+    as without this flag. This mostly helps on file systems with high
+    latency, such as network file systems. It has no effect for paths handled
+    by a QAbstractFileEngine, or if Qt was built without thread support.
+    This value was introduced in Qt 5.14.
 */
 
 #include "qdiriterator.h"
@@ -103,6 +111,16 @@
 #include <QtCore/private/qfilesystemengine_p.h>
 #include <QtCore/private/qfileinfo_p.h>
 
+#if QT_CONFIG(thread) && !defined(QT_NO_FILESYSTEMITERATOR)
+#  include <QtCore/qhash.h>
+#  include <QtCore/qmutex.h>
+#  include <QtCore/qrunnable.h>
+#  include <QtCore/qthreadpool.h>
+#  include <QtCore/qvector.h>
+#  include <QtCore/qwaitcondition.h>
+#  define QDIRITERATOR_PREFETCH
+#endif
+
 QT_BEGIN_NAMESPACE
 
 template <class Iterator>
@@ -115,11 +133,78 @@ public:
     }
 };
 
+#ifdef QDIRITERATOR_PREFETCH
+// The complete listing of one directory, read by a QFileSystemIterator,
+// usually on a thread pool thread ahead of the time it is needed.
+class QDirListing : public QRunnable
+{
+public:
+    QDirListing(const QFileSystemEntry &entry, QDir::Filters filters,
+                const QStringList &nameFilters, QDirIterator::IteratorFlags flags, int depth)
+        : entry(entry), nameFilters(nameFilters), filters(filters), flags(flags),
+          depth(depth), next(0), finished(false)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        QFileSystemIterator it(entry, filters, nameFilters, flags);
+        QFileSystemEntry nextEntry;
+        QFileSystemMetaData nextMetaData;
+        while (it.advance(nextEntry, nextMetaData)) {
+            entries.append(qMakePair(nextEntry, nextMetaData));
+            nextMetaData = QFileSystemMetaData();
+        }
+
+        QMutexLocker locker(&mutex);
+        finished = true;
+        finishedCondition.wakeAll();
+    }
+
+    void waitForFinished()
+    {
+        QMutexLocker locker(&mutex);
+        while (!finished)
+            finishedCondition.wait(&mutex);
+    }
+
+    bool advance(QFileSystemEntry &fileEntry, QFileSystemMetaData &metaData)
+    {
+        if (next == entries.size())
+            return false;
+        fileEntry = entries.at(next).first;
+        metaData = entries.at(next).second;
+        ++next;
+        return true;
+    }
+
+    const QFileSystemEntry entry;
+    const QStringList nameFilters;
+    const QDir::Filters filters;
+    const QDirIterator::IteratorFlags flags;
+    const int depth;
+
+    QVector<QPair<QFileSystemEntry, QFileSystemMetaData> > entries;
+    int next;
+
+private:
+    QMutex mutex;
+    QWaitCondition finishedCondition;
+    bool finished;
+};
+#endif
+
 class QDirIteratorPrivate
 {
 public:
     QDirIteratorPrivate(const QFileSystemEntry &entry, const QStringList &nameFilters,
                         QDir::Filters filters, QDirIterator::IteratorFlags flags, bool resolveEngine = true);
+#ifdef QDIRITERATOR_PREFETCH
+    ~QDirIteratorPrivate();
+
+    void prefetchSubdirectories(const QDirListing *listing);
+#endif
 
     void advance();
 
@@ -143,6 +228,11 @@ public:
 #ifndef QT_NO_FILESYSTEMITERATOR
     QDirIteratorPrivateIteratorStack<QFileSystemIterator> nativeIterators;
 #endif
+#ifdef QDIRITERATOR_PREFETCH
+    // used instead of nativeIterators with PrefetchSubdirectories
+    QDirIteratorPrivateIteratorStack<QDirListing> listings;
+    QHash<QString, QDirListing *> pendingListings;
+#endif
 
     QFileInfo currentFileInfo;
     QFileInfo nextFileInfo;
@@ -179,6 +269,68 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
     advance();
 }
 
+#ifdef QDIRITERATOR_PREFETCH
+/*!
+    \internal
+*/
+QDirIteratorPrivate::~QDirIteratorPrivate()
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+    for (QDirListing *listing : qAsConst(pendingListings)) {
+        if (!pool->tryTake(listing))
+            listing->waitForFinished();
+        delete listing;
+    }
+}
+
+/*!
+    \internal
+
+    Starts reading the subdirectories found in \a listing that we are going
+    to descend into, so they are ready by the time we get there.
+*/
+void QDirIteratorPrivate::prefetchSubdirectories(const QDirListing *listing)
+{
+    // Bounds the memory used for listings that were read but not consumed
+    // yet. Once reached, directories are read when they are reached.
+    const int maxPendingListings = 256;
+
+    if (!(iteratorFlags & QDirIterator::Subdirectories))
+        return;
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    for (const auto &entry : listing->entries) {
+        if (pendingListings.size() >= maxPendingListings)
+            break;
+
+        // the same checks as checkAndPushDirectory(), as far as they can be
+        // made from the metadata we already have
+        const QFileSystemMetaData &metaData = entry.second;
+        if (!metaData.hasFlags(QFileSystemMetaData::DirectoryType | QFileSystemMetaData::LinkType)
+                || !metaData.isDirectory())
+            continue;
+        if (!(iteratorFlags & QDirIterator::FollowSymlinks) && metaData.isLink())
+            continue;
+        const QString fileName = entry.first.fileName();
+        if (fileName == QLatin1String(".") || fileName == QLatin1String(".."))
+            continue;
+        if (fileName.startsWith(QLatin1Char('.')) && !(filters & (QDir::AllDirs | QDir::Hidden)))
+            continue;
+
+        const QString filePath = entry.first.filePath();
+        if (pendingListings.contains(filePath))
+            continue;
+
+        // Deeper directories come first in the iteration order, so they
+        // get the higher priority.
+        QDirListing *subdirectory = new QDirListing(entry.first, filters, nameFilters,
+                                                    iteratorFlags, listing->depth + 1);
+        pendingListings.insert(filePath, subdirectory);
+        pool->start(subdirectory, subdirectory->depth);
+    }
+}
+#endif
+
 /*!
     \internal
 */
@@ -204,6 +356,24 @@ void QDirIteratorPrivate::pushDirectory(const QFileInfo &fileInfo)
             // No iterator; no entry list.
         }
     } else {
+#ifdef QDIRITERATOR_PREFETCH
+        if (iteratorFlags & QDirIterator::PrefetchSubdirectories) {
+            QDirListing *listing = pendingListings.take(fileInfo.filePath());
+            if (!listing) {
+                const int depth = listings.isEmpty() ? 0 : listings.top()->depth + 1;
+                listing = new QDirListing(fileInfo.d_ptr->fileEntry, filters, nameFilters,
+                                          iteratorFlags, depth);
+                listing->run();
+            } else if (QThreadPool::globalInstance()->tryTake(listing)) {
+                listing->run();     // not started yet, so don't wait for it
+            } else {
+                listing->waitForFinished();
+            }
+            listings << listing;
+            prefetchSubdirectories(listing);
+            return;
+        }
+#endif
 #ifndef QT_NO_FILESYSTEMITERATOR
         QFileSystemIterator *it = new QFileSystemIterator(fileInfo.d_ptr->fileEntry,
             filters, nameFilters, iteratorFlags);
@@ -252,6 +422,22 @@ void QDirIteratorPrivate::advance()
         QFileSystemEntry nextEntry;
         QFileSystemMetaData nextMetaData;
 
+#ifdef QDIRITERATOR_PREFETCH
+        while (!listings.isEmpty()) {
+            // Find the next valid listing that matches the filters.
+            QDirListing *listing;
+            while (listing = listings.top(), listing->advance(nextEntry, nextMetaData)) {
+                QFileInfo info(new QFileInfoPrivate(nextEntry, nextMetaData));
+
+                if (entryMatches(nextEntry.fileName(), info))
+                    return;
+            }
+
+            listings.pop();
+            delete listing;
+        }
+#endif
+
         while (!nativeIterators.isEmpty()) {
             // Find the next valid iterator that matches the filters.
             QFileSystemIterator *it;
@@ -507,7 +693,9 @@ bool QDirIterator::hasNext() const
     if (d->engine)
         return !d->fileEngineIterators.isEmpty();
     else
-#ifndef QT_NO_FILESYSTEMITERATOR
+#if defined(QDIRITERATOR_PREFETCH)
+        return !d->nativeIterators.isEmpty() || !d->listings.isEmpty();
+#elif !defined(QT_NO_FILESYSTEMITERATOR)
         return !d->nativeIterators.isEmpty();
 #else
         return false;
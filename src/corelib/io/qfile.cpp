@@ -47,10 +47,14 @@
 #include "qlist.h"
 #include "qfileinfo.h"
 #include "private/qiodevice_p.h"
+#include "private/qbytearray_p.h"
 #include "private/qfile_p.h"
 #include "private/qfilesystemengine_p.h"
 #include "private/qsystemerror_p.h"
 #include "private/qtemporaryfile_p.h"
+
+#include <algorithm>
+
 #if defined(QT_BUILD_CORE_LIB)
 # include "qcoreapplication.h"
 #endif
@@ -1153,6 +1157,111 @@ qint64 QFile::size() const
     return QFileDevice::size(); // for now
 }
 
+#if QT_CONFIG(future) && defined(Q_OS_UNIX)
+/*!
+    \since 5.14
+
+    Starts reading at most \a maxSize bytes from position \a offset in the
+    file and returns a future that receives the data.
+
+    The read is performed in the background; on Linux it is submitted to
+    the kernel through io_uring when available, otherwise it runs on a
+    dedicated I/O thread pool. Any number of requests may be outstanding
+    at the same time. The resulting array is shorter than \a maxSize if
+    the end of the file was reached and empty if an error occurred. For
+    regular files, no more memory than what is left of the file is
+    allocated, however large \a maxSize is.
+
+    Asynchronous operations do not change the current position and bypass
+    the read buffer of QIODevice. The file must be open for reading and
+    must have a native file handle, so Qt resource files are not supported.
+    It may be closed or destroyed while requests are still in flight.
+
+    \note The asynchronous I/O functions are only available on Unix
+    platforms.
+
+    \sa writeAsync(), read()
+*/
+QFuture<QByteArray> QFile::readAsync(qint64 offset, qint64 maxSize)
+{
+    Q_D(QFile);
+    if (offset < 0 || maxSize < 0) {
+        qWarning("QFile::readAsync: Called with negative offset or size");
+        return QFileAsyncIo::finished(QByteArray());
+    }
+    QFileAsyncHandle *handle = d->asyncFileHandle(QIODevice::ReadOnly, "readAsync");
+    if (!handle)
+        return QFileAsyncIo::finished(QByteArray());
+    return QFileAsyncIo::read(handle, offset, qMin(maxSize, qint64(MaxByteArraySize)));
+}
+
+/*!
+    \since 5.14
+    \overload
+
+    Starts a vectored read from position \a offset: consecutive ranges of
+    the file are read into one array for each entry in \a sizes, using a
+    single system call where possible. Arrays past the end of the file are
+    truncated or empty.
+*/
+QFuture<QByteArrayList> QFile::readAsync(qint64 offset, const QVector<qint64> &sizes)
+{
+    Q_D(QFile);
+    const bool invalidSize = std::any_of(sizes.cbegin(), sizes.cend(), [](qint64 size) {
+        return size < 0 || size > MaxByteArraySize;
+    });
+    if (offset < 0 || invalidSize) {
+        qWarning("QFile::readAsync: Called with negative offset or invalid size");
+        return QFileAsyncIo::finished(QByteArrayList());
+    }
+    QFileAsyncHandle *handle = d->asyncFileHandle(QIODevice::ReadOnly, "readAsync");
+    if (!handle)
+        return QFileAsyncIo::finished(QByteArrayList());
+    return QFileAsyncIo::read(handle, offset, sizes);
+}
+
+/*!
+    \since 5.14
+
+    Starts writing \a data at position \a offset in the file and returns a
+    future that receives the number of bytes written, or -1 if an error
+    occurred.
+
+    Pending buffered writes are flushed first, so the data is written after
+    everything that was passed to write() before. On Unix, data written to
+    a file opened with QIODevice::Append may be appended regardless of
+    \a offset. Like readAsync(), this does not change the current position.
+
+    \note This function is only available on Unix platforms.
+
+    \sa readAsync(), write()
+*/
+QFuture<qint64> QFile::writeAsync(qint64 offset, const QByteArray &data)
+{
+    return writeAsync(offset, QByteArrayList() << data);
+}
+
+/*!
+    \since 5.14
+    \overload
+
+    Starts a vectored write of the arrays in \a data, one after the other,
+    at position \a offset, using a single system call where possible.
+*/
+QFuture<qint64> QFile::writeAsync(qint64 offset, const QByteArrayList &data)
+{
+    Q_D(QFile);
+    if (offset < 0) {
+        qWarning("QFile::writeAsync: Called with negative offset");
+        return QFileAsyncIo::finished(qint64(-1));
+    }
+    QFileAsyncHandle *handle = d->asyncFileHandle(QIODevice::WriteOnly, "writeAsync");
+    if (!handle)
+        return QFileAsyncIo::finished(qint64(-1));
+    return QFileAsyncIo::write(handle, offset, data);
+}
+#endif // QT_CONFIG(future) && Q_OS_UNIX
+
 QT_END_NAMESPACE
 
 #ifndef QT_NO_QOBJECT
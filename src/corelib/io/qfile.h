@@ -43,6 +43,9 @@
 
 #include <QtCore/qfiledevice.h>
 #include <QtCore/qstring.h>
+#if QT_CONFIG(future) && defined(Q_OS_UNIX)
+#include <QtCore/qbytearraylist.h>
+#endif
 #include <stdio.h>
 
 #ifdef open
@@ -53,6 +56,9 @@ QT_BEGIN_NAMESPACE
 
 class QTemporaryFile;
 class QFilePrivate;
+#if QT_CONFIG(future) && defined(Q_OS_UNIX)
+template <typename T> class QFuture;
+#endif
 
 class Q_CORE_EXPORT QFile : public QFileDevice
 {
@@ -142,6 +148,13 @@ public:
     bool setPermissions(Permissions permissionSpec) override;
     static bool setPermissions(const QString &filename, Permissions permissionSpec);
 
+#if QT_CONFIG(future) && defined(Q_OS_UNIX)
+    QFuture<QByteArray> readAsync(qint64 offset, qint64 maxSize);
+    QFuture<QByteArrayList> readAsync(qint64 offset, const QVector<qint64> &sizes);
+    QFuture<qint64> writeAsync(qint64 offset, const QByteArray &data);
+    QFuture<qint64> writeAsync(qint64 offset, const QByteArrayList &data);
+#endif
+
 protected:
 #ifdef QT_NO_QOBJECT
     QFile(QFilePrivate &dd);
@@ -0,0 +1,685 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qfileasyncio_p.h"
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qvarlengtharray.h>
+#include <QtCore/qwaitcondition.h>
+
+#include "private/qcore_unix_p.h"
+
+#include <limits.h>
+#include <sys/uio.h>
+
+#if defined(Q_OS_LINUX) && QT_HAS_INCLUDE(<linux/io_uring.h>)
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#    define QT_FILEASYNCIO_IO_URING
+#  endif
+#endif
+
+#if defined(Q_OS_DARWIN) || (defined(Q_OS_ANDROID) && __ANDROID_API__ < 24)
+// preadv() and pwritev() are missing; transfer one segment at a time
+#  define QT_FILEASYNCIO_NO_PREADV
+#  if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#    define QT_PREAD    ::pread64
+#    define QT_PWRITE   ::pwrite64
+#  else
+#    define QT_PREAD    ::pread
+#    define QT_PWRITE   ::pwrite
+#  endif
+#elif defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#  define QT_PREADV     ::preadv64
+#  define QT_PWRITEV    ::pwritev64
+#else
+#  define QT_PREADV     ::preadv
+#  define QT_PWRITEV    ::pwritev
+#endif
+
+QT_BEGIN_NAMESPACE
+
+QFileAsyncHandle::~QFileAsyncHandle()
+{
+    qt_safe_close(fd);
+}
+
+QFileAsyncHandle *QFileAsyncHandle::duplicate(int fd)
+{
+    const int copy = qt_safe_dup(fd);
+    return copy == -1 ? nullptr : new QFileAsyncHandle(copy);
+}
+
+/*
+    One positional, possibly vectored, transfer. The backends hand the
+    outcome of each preadv()/pwritev() to transferred(), which either
+    advances the segments past what was transferred so that the remainder
+    can be resubmitted, or completes the future and deletes the request.
+*/
+class QFileAsyncRequest
+{
+public:
+#ifdef IOV_MAX
+    enum { MaxSegments = IOV_MAX };
+#else
+    enum { MaxSegments = 16 };
+#endif
+    enum { MaxRetryDelay = 64 };
+
+    QFileAsyncRequest(QFileAsyncHandle *h, qint64 position, bool write)
+        : handle(h), offset(position), isWrite(write)
+    {}
+    virtual ~QFileAsyncRequest() = default;
+
+    // Takes the number of bytes transferred or -errno; returns true
+    // when the request has finished (and has been deleted).
+    bool transferred(qint64 result);
+    // Milliseconds to wait before resubmitting, because the last attempt
+    // would have blocked; 0 to resubmit right away.
+    int retryDelay() const { return delay; }
+
+    int segmentCount() const { return qMin(segments.size() - current, int(MaxSegments)); }
+    const iovec *currentSegments() const { return segments.constData() + current; }
+    qint64 currentOffset() const { return offset + total; }
+
+    bool isEmpty() const { return segments.isEmpty(); }
+    void addSegment(const char *data, qint64 size)
+    {
+        if (size == 0)
+            return;
+        iovec segment;
+        segment.iov_base = const_cast<char *>(data);
+        segment.iov_len = size_t(size);
+        segments.append(segment);
+    }
+
+    QExplicitlySharedDataPointer<QFileAsyncHandle> handle;
+    const qint64 offset;
+    const bool isWrite;
+
+protected:
+    // Takes the total number of bytes transferred or -errno.
+    virtual void finish(qint64 result) = 0;
+
+private:
+    QVarLengthArray<iovec, 1> segments;
+    qint64 total = 0;
+    int current = 0;
+    int delay = 0;
+};
+
+bool QFileAsyncRequest::transferred(qint64 result)
+{
+    if (result == -EINTR)
+        return false;
+    if (result == -EAGAIN) {
+        // A non-blocking descriptor that is not ready; back off exponentially
+        delay = qBound(1, delay * 2, int(MaxRetryDelay));
+        return false;
+    }
+
+    delay = 0;
+    if (result > 0) {
+        total += result;
+        while (current < segments.size() && size_t(result) >= segments[current].iov_len) {
+            result -= qint64(segments[current].iov_len);
+            ++current;
+        }
+        if (current < segments.size()) {
+            iovec &segment = segments[current];
+            segment.iov_base = static_cast<char *>(segment.iov_base) + result;
+            segment.iov_len -= size_t(result);
+            return false;
+        }
+    }
+
+    // Like QIODevice::read(), report what was transferred before an error.
+    finish(result < 0 && total == 0 ? result : total);
+    delete this;
+    return true;
+}
+
+namespace {
+class QFileAsyncReadRequest : public QFileAsyncRequest
+{
+public:
+    QFileAsyncReadRequest(QFileAsyncHandle *handle, qint64 offset, qint64 maxSize)
+        : QFileAsyncRequest(handle, offset, false), buffer(int(maxSize), Qt::Uninitialized)
+    {
+        promise.reportStarted();
+        addSegment(buffer.constData(), maxSize);
+    }
+
+    QFutureInterface<QByteArray> promise;
+
+protected:
+    void finish(qint64 result) override
+    {
+        buffer.resize(int(qMax(result, qint64(0))));
+        promise.reportFinished(&buffer);
+    }
+
+private:
+    QByteArray buffer;
+};
+
+class QFileAsyncVectorReadRequest : public QFileAsyncRequest
+{
+public:
+    QFileAsyncVectorReadRequest(QFileAsyncHandle *handle, qint64 offset, const QVector<qint64> &sizes)
+        : QFileAsyncRequest(handle, offset, false)
+    {
+        promise.reportStarted();
+        buffers.reserve(sizes.size());
+        for (qint64 size : sizes) {
+            buffers.append(QByteArray(int(size), Qt::Uninitialized));
+            addSegment(buffers.constLast().constData(), size);
+        }
+    }
+
+    QFutureInterface<QByteArrayList> promise;
+
+protected:
+    void finish(qint64 result) override
+    {
+        qint64 remaining = qMax(result, qint64(0));
+        for (QByteArray &buffer : buffers) {
+            buffer.resize(int(qMin(remaining, qint64(buffer.size()))));
+            remaining -= buffer.size();
+        }
+        promise.reportFinished(&buffers);
+    }
+
+private:
+    QByteArrayList buffers;
+};
+
+class QFileAsyncWriteRequest : public QFileAsyncRequest
+{
+public:
+    QFileAsyncWriteRequest(QFileAsyncHandle *handle, qint64 offset, const QByteArrayList &data)
+        : QFileAsyncRequest(handle, offset, true), buffers(data)
+    {
+        promise.reportStarted();
+        for (const QByteArray &buffer : qAsConst(buffers))
+            addSegment(buffer.constData(), buffer.size());
+    }
+
+    QFutureInterface<qint64> promise;
+
+protected:
+    void finish(qint64 result) override
+    {
+        const qint64 written = result < 0 ? qint64(-1) : result;
+        promise.reportFinished(&written);
+    }
+
+private:
+    const QByteArrayList buffers;
+};
+
+class QFileAsyncEngine
+{
+public:
+    virtual ~QFileAsyncEngine() = default;
+    virtual void submit(QFileAsyncRequest *request) = 0;
+};
+
+// Fallback: run blocking preadv()/pwritev() calls on a dedicated thread
+// pool, so that file I/O does not starve QThreadPool::globalInstance().
+class QFileAsyncThreadPoolEngine : public QFileAsyncEngine
+{
+public:
+    QFileAsyncThreadPoolEngine()
+    {
+        pool.setObjectName(QStringLiteral("QFileAsyncIo"));
+        pool.setMaxThreadCount(qMax(4, QThread::idealThreadCount()));
+    }
+    ~QFileAsyncThreadPoolEngine()
+    {
+        pool.waitForDone();
+    }
+
+    void submit(QFileAsyncRequest *request) override
+    {
+        pool.start(new Runnable(request));
+    }
+
+private:
+    class Runnable : public QRunnable
+    {
+    public:
+        explicit Runnable(QFileAsyncRequest *r) : request(r) {}
+        void run() override
+        {
+            qint64 result;
+            do {
+                if (const int delay = request->retryDelay())
+                    QThread::msleep(ulong(delay));
+                const int fd = request->handle->fd;
+                const iovec *segments = request->currentSegments();
+                const QT_OFF_T offset = QT_OFF_T(request->currentOffset());
+#ifdef QT_FILEASYNCIO_NO_PREADV
+                if (request->isWrite)
+                    result = QT_PWRITE(fd, segments->iov_base, segments->iov_len, offset);
+                else
+                    result = QT_PREAD(fd, segments->iov_base, segments->iov_len, offset);
+#else
+                const int count = request->segmentCount();
+                if (request->isWrite)
+                    result = QT_PWRITEV(fd, segments, count, offset);
+                else
+                    result = QT_PREADV(fd, segments, count, offset);
+#endif
+                if (result < 0)
+                    result = -errno;
+            } while (!request->transferred(result));
+        }
+
+    private:
+        QFileAsyncRequest *request;
+    };
+
+    QThreadPool pool;
+};
+
+#ifdef QT_FILEASYNCIO_IO_URING
+/*
+    Linux io_uring backend. Submissions are written into the shared
+    submission queue under a mutex; a single thread waits for and reaps
+    completions. The number of requests in flight is bounded by the size
+    of the completion queue so that no completion can be dropped; excess
+    requests wait in a FIFO until slots free up. Requests that would have
+    blocked are held back by the completion thread for a while before they
+    are resubmitted.
+*/
+class QFileAsyncIoUringEngine : public QFileAsyncEngine
+{
+public:
+    static QFileAsyncIoUringEngine *create();
+    ~QFileAsyncIoUringEngine();
+
+    void submit(QFileAsyncRequest *request) override;
+
+private:
+    class CompletionThread : public QThread
+    {
+    public:
+        explicit CompletionThread(QFileAsyncIoUringEngine *e) : engine(e)
+        {
+            setObjectName(QStringLiteral("QFileAsyncIo"));
+        }
+        void run() override { engine->processCompletions(); }
+
+    private:
+        QFileAsyncIoUringEngine *engine;
+    };
+
+    QFileAsyncIoUringEngine() : thread(this) {}
+    bool setup(unsigned entries);
+    bool queue(QFileAsyncRequest *request);
+    void submitPending();
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags);
+    unsigned unsubmitted() const
+    {
+        return __atomic_load_n(sqTail, __ATOMIC_ACQUIRE) - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    }
+    void processCompletions();
+
+    CompletionThread thread;
+    QMutex mutex;
+    QWaitCondition idle;
+    QQueue<QFileAsyncRequest *> pending;
+    unsigned inFlight = 0;
+    unsigned outstanding = 0;   // submitted and not finished yet
+
+    int ringFd = -1;
+    void *sqRing = nullptr;
+    void *cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe *sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    const unsigned *sqMask = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned sqEntries = 0;
+    unsigned *cqHead = nullptr;
+    const unsigned *cqTail = nullptr;
+    const unsigned *cqMask = nullptr;
+    const io_uring_cqe *cqes = nullptr;
+    unsigned cqEntries = 0;
+};
+
+QFileAsyncIoUringEngine *QFileAsyncIoUringEngine::create()
+{
+    QFileAsyncIoUringEngine *engine = new QFileAsyncIoUringEngine;
+    if (!engine->setup(256)) {
+        delete engine;
+        return nullptr;
+    }
+    engine->thread.start();
+    return engine;
+}
+
+bool QFileAsyncIoUringEngine::setup(unsigned entries)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd = int(syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd < 0)
+        return false;   // ENOSYS, or blocked by a seccomp policy
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+#ifdef IORING_FEAT_SINGLE_MMAP
+    const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap)
+        sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+#else
+    const bool singleMmap = false;
+#endif
+
+    void *ring = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED)
+        return false;
+    sqRing = ring;
+    if (singleMmap) {
+        cqRing = sqRing;
+    } else {
+        ring = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ringFd, IORING_OFF_CQ_RING);
+        if (ring == MAP_FAILED)
+            return false;
+        cqRing = ring;
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ringFd, IORING_OFF_SQES);
+    if (ring == MAP_FAILED)
+        return false;
+    sqes = static_cast<io_uring_sqe *>(ring);
+
+    char *sq = static_cast<char *>(sqRing);
+    sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sqEntries = params.sq_entries;
+
+    char *cq = static_cast<char *>(cqRing);
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    cqEntries = params.cq_entries;
+    return true;
+}
+
+QFileAsyncIoUringEngine::~QFileAsyncIoUringEngine()
+{
+    if (thread.isRunning()) {
+        // The completion thread must see every request through before it
+        // exits, or the kernel could still write to a finished request's
+        // buffers. A no-op without a request then tells it to exit.
+        QMutexLocker locker(&mutex);
+        while (outstanding)
+            idle.wait(&mutex);
+        while (!queue(nullptr)) {
+            locker.unlock();
+            QThread::yieldCurrentThread();
+            locker.relock();
+        }
+        enter(unsubmitted(), 0, 0);
+        locker.unlock();
+        thread.wait();
+    }
+
+    if (sqes)
+        munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing)
+        munmap(sqRing, sqRingSize);
+    if (ringFd != -1)
+        qt_safe_close(ringFd);
+}
+
+int QFileAsyncIoUringEngine::enter(unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    int ret;
+    EINTR_LOOP(ret, int(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags,
+                                nullptr, 0)));
+    return ret;
+}
+
+// Must be called with the mutex locked.
+bool QFileAsyncIoUringEngine::queue(QFileAsyncRequest *request)
+{
+    const unsigned tail = *sqTail;
+    if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+        return false;
+
+    const unsigned index = tail & *sqMask;
+    io_uring_sqe *sqe = sqes + index;
+    memset(sqe, 0, sizeof(*sqe));
+    if (request) {
+        sqe->opcode = request->isWrite ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe->fd = request->handle->fd;
+        sqe->off = quint64(request->currentOffset());
+        sqe->addr = quintptr(request->currentSegments());
+        sqe->len = unsigned(request->segmentCount());
+        sqe->user_data = quintptr(request);
+    } else {
+        sqe->opcode = IORING_OP_NOP;
+    }
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Must be called with the mutex locked.
+void QFileAsyncIoUringEngine::submitPending()
+{
+    // Keep one completion slot free for the shutdown no-op.
+    bool queued = false;
+    while (!pending.isEmpty() && inFlight + 1 < cqEntries && queue(pending.head())) {
+        pending.dequeue();
+        ++inFlight;
+        queued = true;
+    }
+    // If the kernel cannot take the entries right now (EAGAIN, EBUSY) they
+    // stay in the ring and the completion thread submits them later.
+    if (queued)
+        enter(unsubmitted(), 0, 0);
+}
+
+void QFileAsyncIoUringEngine::submit(QFileAsyncRequest *request)
+{
+    QMutexLocker locker(&mutex);
+    pending.enqueue(request);
+    ++outstanding;
+    submitPending();
+}
+
+void QFileAsyncIoUringEngine::processCompletions()
+{
+    QVarLengthArray<io_uring_cqe, 64> completed;
+    QVarLengthArray<QFileAsyncRequest *, 64> resubmit;
+    QVarLengthArray<QFileAsyncRequest *, 64> deferred;
+    bool quit = false;
+    while (!quit) {
+        // With requests held back, only poll for completions, and retry
+        // them after the shortest delay any of them asked for.
+        int delay = int(QFileAsyncRequest::MaxRetryDelay);
+        for (const QFileAsyncRequest *request : qAsConst(deferred))
+            delay = qMin(delay, request->retryDelay());
+        if (!deferred.isEmpty())
+            QThread::msleep(ulong(delay));
+
+        const unsigned minComplete = deferred.isEmpty() ? 1 : 0;
+        if (enter(unsubmitted(), minComplete, IORING_ENTER_GETEVENTS) < 0
+                && errno != EAGAIN && errno != EBUSY) {
+            qErrnoWarning("QFileAsyncIo: io_uring_enter() failed");
+            QThread::msleep(10);
+        }
+
+        unsigned head = *cqHead;
+        const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        completed.clear();
+        for ( ; head != tail; ++head)
+            completed.append(cqes[head & *cqMask]);
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+        resubmit = deferred;
+        deferred.clear();
+        unsigned done = 0;
+        unsigned finished = 0;
+        for (const io_uring_cqe &cqe : qAsConst(completed)) {
+            QFileAsyncRequest *request = reinterpret_cast<QFileAsyncRequest *>(quintptr(cqe.user_data));
+            if (!request) {
+                quit = true;
+                continue;
+            }
+            ++done;
+            if (request->transferred(cqe.res))
+                ++finished;
+            else if (request->retryDelay())
+                deferred.append(request);
+            else
+                resubmit.append(request);
+        }
+
+        if (done || !resubmit.isEmpty()) {
+            QMutexLocker locker(&mutex);
+            inFlight -= done;
+            outstanding -= finished;
+            if (!outstanding)
+                idle.wakeAll();
+            for (QFileAsyncRequest *request : qAsConst(resubmit))
+                pending.prepend(request);
+            submitPending();
+        }
+    }
+}
+#endif // QT_FILEASYNCIO_IO_URING
+
+class QFileAsyncEngineHolder
+{
+public:
+    QFileAsyncEngineHolder()
+    {
+#ifdef QT_FILEASYNCIO_IO_URING
+        if (!qEnvironmentVariableIsSet("QT_NO_IO_URING"))
+            engine.reset(QFileAsyncIoUringEngine::create());
+#endif
+        if (!engine)
+            engine.reset(new QFileAsyncThreadPoolEngine);
+    }
+
+    QScopedPointer<QFileAsyncEngine> engine;
+};
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QFileAsyncEngineHolder, asyncEngine)
+
+template <typename Request>
+static auto start(Request *request) -> decltype(request->promise.future())
+{
+    auto future = request->promise.future();
+    if (request->isEmpty())
+        request->transferred(0);
+    else if (QFileAsyncEngineHolder *holder = asyncEngine())
+        holder->engine->submit(request);
+    else
+        request->transferred(-ECANCELED);
+    return future;
+}
+
+// Limits a read to what is left of a regular file, so that its buffer is not
+// allocated for the full requested size. Devices report no useful size and
+// are read as requested. Note that files in /proc claim to be empty, and so
+// read as empty.
+static qint64 clampToFileSize(const QFileAsyncHandle *handle, qint64 offset, qint64 maxSize)
+{
+    QT_STATBUF st;
+    if (QT_FSTAT(handle->fd, &st) == 0 && S_ISREG(st.st_mode))
+        return qBound(qint64(0), qint64(st.st_size) - offset, maxSize);
+    return maxSize;
+}
+
+QFuture<QByteArray> QFileAsyncIo::read(QFileAsyncHandle *handle, qint64 offset, qint64 maxSize)
+{
+    maxSize = clampToFileSize(handle, offset, maxSize);
+    return start(new QFileAsyncReadRequest(handle, offset, maxSize));
+}
+
+QFuture<QByteArrayList> QFileAsyncIo::read(QFileAsyncHandle *handle, qint64 offset,
+                                           const QVector<qint64> &sizes)
+{
+    qint64 total = 0;
+    for (qint64 size : sizes)
+        total += size;
+    qint64 available = clampToFileSize(handle, offset, total);
+    if (available == total)
+        return start(new QFileAsyncVectorReadRequest(handle, offset, sizes));
+
+    QVector<qint64> clamped;
+    clamped.reserve(sizes.size());
+    for (qint64 size : sizes) {
+        clamped.append(qMin(size, available));
+        available -= clamped.constLast();
+    }
+    return start(new QFileAsyncVectorReadRequest(handle, offset, clamped));
+}
+
+QFuture<qint64> QFileAsyncIo::write(QFileAsyncHandle *handle, qint64 offset,
+                                    const QByteArrayList &data)
+{
+    return start(new QFileAsyncWriteRequest(handle, offset, data));
+}
+
+QT_END_NAMESPACE
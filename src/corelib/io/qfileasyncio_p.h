@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFILEASYNCIO_P_H
+#define QFILEASYNCIO_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+QT_REQUIRE_CONFIG(future);
+
+// Positional I/O on a duplicated descriptor, so Unix only; QFile's
+// asynchronous API is not available elsewhere.
+#ifndef Q_OS_UNIX
+#  error "qfileasyncio_p.h included on a non-Unix system"
+#endif
+
+#include <QtCore/qbytearraylist.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// A private duplicate of a QFile's native handle. Requests in flight keep
+// a reference to it, so closing the QFile (and the kernel reusing the
+// descriptor number) cannot redirect their I/O to another file.
+class QFileAsyncHandle : public QSharedData
+{
+public:
+    explicit QFileAsyncHandle(int fileDescriptor) : fd(fileDescriptor) {}
+    ~QFileAsyncHandle();
+
+    static QFileAsyncHandle *duplicate(int fd);
+
+    const int fd;
+
+private:
+    Q_DISABLE_COPY(QFileAsyncHandle)
+};
+
+namespace QFileAsyncIo
+{
+QFuture<QByteArray> read(QFileAsyncHandle *handle, qint64 offset, qint64 maxSize);
+QFuture<QByteArrayList> read(QFileAsyncHandle *handle, qint64 offset, const QVector<qint64> &sizes);
+QFuture<qint64> write(QFileAsyncHandle *handle, qint64 offset, const QByteArrayList &data);
+
+template <typename T>
+QFuture<T> finished(const T &result)
+{
+    QFutureInterface<T> fi;
+    fi.reportStarted();
+    fi.reportFinished(&result);
+    return fi.future();
+}
+}
+
+QT_END_NAMESPACE
+
+#endif // QFILEASYNCIO_P_H
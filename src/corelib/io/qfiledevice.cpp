@@ -52,9 +52,15 @@ QT_BEGIN_NAMESPACE
 #define QFILE_WRITEBUFFER_SIZE 16384
 #endif
 
+// files smaller than this are read into the buffer rather than mapped by
+// readView() and peekView(), as mapping them costs more than copying
+#ifndef QFILE_MINIMUM_VIEW_MAP_SIZE
+#define QFILE_MINIMUM_VIEW_MAP_SIZE (4 * QIODEVICE_BUFFERSIZE)
+#endif
+
 QFileDevicePrivate::QFileDevicePrivate()
     : fileEngine(0),
-      cachedSize(0),
+      cachedSize(0), viewMap(nullptr), viewMapSize(0),
       error(QFile::NoError), lastWasWrite(false)
 {
     writeBufferChunkSize = QFILE_WRITEBUFFER_SIZE;
@@ -73,6 +79,42 @@ QAbstractFileEngine * QFileDevicePrivate::engine() const
     return fileEngine;
 }
 
+QByteArray QFileDevicePrivate::directView(qint64 maxSize)
+{
+    if (!fileEngine || !ensureFlushed())
+        return QByteArray();
+
+    // Never hand out mapped memory beyond the end of the file: touching
+    // it would raise SIGBUS if the file was truncated since it was mapped.
+    const qint64 fileSize = fileEngine->size();
+    if (pos >= fileSize)
+        return QByteArray();
+
+    if (pos >= viewMapSize) {
+        if (fileSize < QFILE_MINIMUM_VIEW_MAP_SIZE
+                || !fileEngine->supportsExtension(QAbstractFileEngine::MapExtension)) {
+            return QByteArray();
+        }
+        // the file grew beyond the old mapping, which no view refers to anymore
+        unmapView();
+        viewMap = fileEngine->map(0, fileSize, QFileDevice::NoOptions);
+        if (!viewMap)
+            return QByteArray();
+        viewMapSize = fileSize;
+    }
+
+    const qint64 length = qMin(maxSize, qMin(fileSize, viewMapSize) - pos);
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(viewMap) + pos, int(length));
+}
+
+void QFileDevicePrivate::unmapView()
+{
+    if (viewMap)
+        fileEngine->unmap(viewMap);
+    viewMap = nullptr;
+    viewMapSize = 0;
+}
+
 void QFileDevicePrivate::setError(QFileDevice::FileError err)
 {
     error = err;
@@ -91,6 +133,38 @@ void QFileDevicePrivate::setError(QFileDevice::FileError err, int errNum)
     errorString = qt_error_string(errNum);
 }
 
+#if QT_CONFIG(future) && defined(Q_OS_UNIX)
+QFileAsyncHandle *QFileDevicePrivate::asyncFileHandle(QIODevice::OpenModeFlag mode,
+                                                     const char *function)
+{
+    Q_Q(QFileDevice);
+    if (!(openMode & mode)) {
+        qWarning("QFile::%s: %s", function,
+                 openMode == QIODevice::NotOpen ? "device not open"
+                 : mode == QIODevice::ReadOnly ? "WriteOnly device" : "ReadOnly device");
+        return nullptr;
+    }
+
+    // Asynchronous writes must land after the buffered ones.
+    if ((openMode & QIODevice::WriteOnly) && !q->flush())
+        return nullptr;
+
+    if (!asyncHandle) {
+        const int fd = q->handle();
+        if (fd == -1) {
+            qWarning("QFile::%s: file has no native handle", function);
+            return nullptr;
+        }
+        asyncHandle = QFileAsyncHandle::duplicate(fd);
+        if (!asyncHandle) {
+            qErrnoWarning("QFile::%s: cannot duplicate the file handle", function);
+            return nullptr;
+        }
+    }
+    return asyncHandle.data();
+}
+#endif
+
 /*!
     \enum QFileDevice::FileError
 
@@ -331,6 +405,12 @@ void QFileDevice::close()
     // reset cached size
     d->cachedSize = 0;
 
+    d->unmapView();
+#if QT_CONFIG(future) && defined(Q_OS_UNIX)
+    // requests in flight keep their own reference
+    d->asyncHandle.reset();
+#endif
+
     // keep earlier error from flush
     if (d->fileEngine->close() && flushed)
         unsetError();
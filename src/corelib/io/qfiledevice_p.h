@@ -52,6 +52,9 @@
 //
 
 #include "private/qiodevice_p.h"
+#if QT_CONFIG(future) && defined(Q_OS_UNIX)
+#include "private/qfileasyncio_p.h"
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -70,14 +73,24 @@ protected:
     inline bool ensureFlushed() const;
 
     bool putCharHelper(char c) override;
+    QByteArray directView(qint64 maxSize) override;
+    void unmapView();
 
     void setError(QFileDevice::FileError err);
     void setError(QFileDevice::FileError err, const QString &errorString);
     void setError(QFileDevice::FileError err, int errNum);
 
+#if QT_CONFIG(future) && defined(Q_OS_UNIX)
+    QFileAsyncHandle *asyncFileHandle(QIODevice::OpenModeFlag mode, const char *function);
+    QExplicitlySharedDataPointer<QFileAsyncHandle> asyncHandle;
+#endif
+
     mutable QAbstractFileEngine *fileEngine;
     mutable qint64 cachedSize;
 
+    uchar *viewMap;
+    qint64 viewMapSize;
+
     QFileDevice::FileHandleFlags handleFlags;
     QFileDevice::FileError error;
 
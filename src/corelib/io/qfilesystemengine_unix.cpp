@@ -106,6 +106,12 @@ extern "C" NSString *NSTemporaryDirectory();
 struct statx { mode_t stx_mode; };      // dummy
 #endif
 
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#  define QT_FSTATAT    ::fstatat64
+#else
+#  define QT_FSTATAT    ::fstatat
+#endif
+
 QT_BEGIN_NAMESPACE
 
 enum {
@@ -431,6 +437,110 @@ bool QFileSystemEngine::fillMetaData(int fd, QFileSystemMetaData &data)
     return false;
 }
 
+//static
+bool QFileSystemEngine::fillMetaData(int dirFd, const char *name, QFileSystemMetaData &data,
+                                     QFileSystemMetaData::MetaDataFlags what)
+{
+    // Like fillMetaData(const QFileSystemEntry &, ...), but for an entry of
+    // an open directory, so the kernel doesn't need to walk the path again.
+    // It only fills in what can be had from a single stat call: the type,
+    // the POSIX permission bits, sizes, times and owners. User permissions
+    // and the other attributes are still resolved by the full version.
+    const QFileSystemMetaData::MetaDataFlags typeFlags = QFileSystemMetaData::FileType
+            | QFileSystemMetaData::DirectoryType
+            | QFileSystemMetaData::SequentialType
+            | QFileSystemMetaData::ExistsAttribute;
+    what |= typeFlags;
+
+#ifdef STATX_BASIC_STATS
+    // ask only for the fields we need, so remote file systems that have the
+    // type cached don't need to go back to the server for the rest
+    unsigned mask = STATX_TYPE;
+    if (what & (QFileSystemMetaData::OtherPermissions | QFileSystemMetaData::GroupPermissions
+                | QFileSystemMetaData::OwnerPermissions))
+        mask |= STATX_MODE;
+    if (what & QFileSystemMetaData::SizeAttribute)
+        mask |= STATX_SIZE;
+    if (what & QFileSystemMetaData::WasDeletedAttribute)
+        mask |= STATX_NLINK;
+    if (what & QFileSystemMetaData::Times)
+        mask |= STATX_ATIME | STATX_MTIME | STATX_CTIME | STATX_BTIME;
+    if (what & QFileSystemMetaData::OwnerIds)
+        mask |= STATX_UID | STATX_GID;
+
+    // if we already know it's a symlink, go straight to its target
+    const int flags = data.hasFlags(QFileSystemMetaData::LinkType) && data.isLink()
+            ? 0 : AT_SYMLINK_NOFOLLOW;
+    struct statx statxBuffer;
+    int ret = statx(dirFd, name, flags, mask, &statxBuffer);
+    if (ret == 0 && flags) {
+        data.knownFlagsMask |= QFileSystemMetaData::LinkType;
+        if (S_ISLNK(statxBuffer.stx_mode)) {
+            data.entryFlags |= QFileSystemMetaData::LinkType;
+            ret = statx(dirFd, name, 0, mask, &statxBuffer);
+        } else {
+            data.entryFlags &= ~QFileSystemMetaData::LinkType;
+        }
+    }
+
+    if (ret == 0 || errno != ENOSYS) {
+        data.entryFlags &= ~(what & QFileSystemMetaData::PosixStatFlags);
+        if (ret != 0) {
+            // doesn't exist, or a dangling symlink
+            data.entryFlags &= ~QFileSystemMetaData::ExistsAttribute;
+            data.knownFlagsMask |= typeFlags;
+            return false;
+        }
+
+        const bool isLink = data.isLink();
+        data.fillFromStatxBuf(statxBuffer);
+        if (isLink)
+            data.entryFlags |= QFileSystemMetaData::LinkType;
+
+        QFileSystemMetaData::MetaDataFlags known = typeFlags;
+        if (statxBuffer.stx_mask & STATX_MODE)
+            known |= QFileSystemMetaData::OtherPermissions | QFileSystemMetaData::GroupPermissions
+                    | QFileSystemMetaData::OwnerPermissions;
+        if (statxBuffer.stx_mask & STATX_SIZE)
+            known |= QFileSystemMetaData::SizeAttribute;
+        if (statxBuffer.stx_mask & STATX_NLINK)
+            known |= QFileSystemMetaData::WasDeletedAttribute;
+        if ((statxBuffer.stx_mask & (STATX_ATIME | STATX_MTIME | STATX_CTIME))
+                == (STATX_ATIME | STATX_MTIME | STATX_CTIME))
+            known |= QFileSystemMetaData::Times;
+        if ((statxBuffer.stx_mask & (STATX_UID | STATX_GID)) == (STATX_UID | STATX_GID))
+            known |= QFileSystemMetaData::OwnerIds;
+        data.knownFlagsMask |= known;
+        return true;
+    }
+#endif
+
+    const int statFlags = data.hasFlags(QFileSystemMetaData::LinkType) && data.isLink()
+            ? 0 : AT_SYMLINK_NOFOLLOW;
+    QT_STATBUF statBuffer;
+    int statResult = QT_FSTATAT(dirFd, name, &statBuffer, statFlags);
+    if (statResult == 0 && statFlags) {
+        data.knownFlagsMask |= QFileSystemMetaData::LinkType;
+        if (S_ISLNK(statBuffer.st_mode)) {
+            data.entryFlags |= QFileSystemMetaData::LinkType;
+            statResult = QT_FSTATAT(dirFd, name, &statBuffer, 0);
+        } else {
+            data.entryFlags &= ~QFileSystemMetaData::LinkType;
+        }
+    }
+
+    data.entryFlags &= ~QFileSystemMetaData::PosixStatFlags;
+    if (statResult != 0) {
+        data.entryFlags &= ~QFileSystemMetaData::ExistsAttribute;
+        data.knownFlagsMask |= typeFlags;
+        return false;
+    }
+    data.fillFromStatBuf(statBuffer);
+    data.entryFlags |= QFileSystemMetaData::ExistsAttribute;
+    data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::ExistsAttribute;
+    return true;
+}
+
 #if defined(_DEXTRA_FIRST)
 static void fillStat64fromStat32(struct stat64 *statBuf64, const struct stat &statBuf32)
 {
@@ -67,6 +67,11 @@
 #include <QtCore/qscopedpointer.h>
 #endif
 
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+// read directories with getdents64(2) directly, in large batches
+#  define QT_FILESYSTEMITERATOR_GETDENTS
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QFileSystemIterator
@@ -90,6 +95,14 @@ private:
     bool uncFallback;
     int uncShareIndex;
     bool onlyDirs;
+#elif defined(QT_FILESYSTEMITERATOR_GETDENTS)
+    bool readEntries();
+
+    int dirFd;
+    QScopedArrayPointer<char> buffer;
+    int bufferSize;
+    int bufferOffset;
+    int lastError;
 #else
     QT_DIR *dir;
     QT_DIRENT *dirEntry;
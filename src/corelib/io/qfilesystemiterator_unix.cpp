@@ -39,6 +39,7 @@
 
 #include "qplatformdefs.h"
 #include "qfilesystemiterator_p.h"
+#include "qfilesystemengine_p.h"
 
 #if QT_CONFIG(textcodec)
 #  include <qtextcodec.h>
@@ -52,6 +53,12 @@
 #include <stdlib.h>
 #include <errno.h>
 
+#ifdef QT_FILESYSTEMITERATOR_GETDENTS
+#  include <QtCore/private/qcore_unix_p.h>
+#  include <stddef.h>
+#  include <sys/syscall.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 static bool checkNameDecodable(const char *d_name, qsizetype len)
@@ -90,6 +97,98 @@ static bool checkNameDecodable(const char *d_name, qsizetype len)
 #endif
 }
 
+#ifdef QT_FILESYSTEMITERATOR_GETDENTS
+
+// The records returned by getdents64(2) have the same layout as the
+// glibc/musl struct dirent64, so QFileSystemMetaData::fillFromDirEnt() can
+// read them in place.
+static_assert(offsetof(QT_DIRENT, d_name) == 19, "unexpected struct dirent layout");
+
+enum {
+    // big enough to fetch a few hundred entries per system call; readdir(3)
+    // uses 32 KiB and so needs many more round trips for large directories
+    DirentBufferSize = 64 * 1024
+};
+
+QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Filters filters,
+                                         const QStringList &nameFilters, QDirIterator::IteratorFlags flags)
+    : nativePath(entry.nativeFilePath())
+    , dirFd(-1)
+    , bufferSize(0)
+    , bufferOffset(0)
+    , lastError(0)
+{
+    Q_UNUSED(filters)
+    Q_UNUSED(nameFilters)
+    Q_UNUSED(flags)
+
+    dirFd = qt_safe_open(nativePath.constData(), O_RDONLY | O_DIRECTORY);
+    if (dirFd == -1) {
+        lastError = errno;
+    } else {
+        buffer.reset(new char[DirentBufferSize]);
+        if (!nativePath.endsWith('/'))
+            nativePath.append('/');
+    }
+}
+
+QFileSystemIterator::~QFileSystemIterator()
+{
+    if (dirFd != -1)
+        qt_safe_close(dirFd);
+}
+
+bool QFileSystemIterator::readEntries()
+{
+    long n;
+    do {
+        n = syscall(SYS_getdents64, dirFd, buffer.data(), DirentBufferSize);
+    } while (n == -1 && errno == EINTR);
+
+    bufferOffset = 0;
+    bufferSize = n > 0 ? int(n) : 0;
+    if (n > 0)
+        return true;
+
+    // end of directory or error; we won't need the buffer any more
+    lastError = n == 0 ? 0 : errno;
+    qt_safe_close(dirFd);
+    dirFd = -1;
+    buffer.reset();
+    return false;
+}
+
+bool QFileSystemIterator::advance(QFileSystemEntry &fileEntry, QFileSystemMetaData &metaData)
+{
+    if (dirFd == -1)
+        return false;
+
+    for (;;) {
+        if (bufferOffset >= bufferSize && !readEntries())
+            return false;
+
+        const QT_DIRENT *dirEntry = reinterpret_cast<const QT_DIRENT *>(buffer.data() + bufferOffset);
+        bufferOffset += dirEntry->d_reclen;
+
+        qsizetype len = strlen(dirEntry->d_name);
+        if (checkNameDecodable(dirEntry->d_name, len)) {
+            fileEntry = QFileSystemEntry(nativePath + QByteArray(dirEntry->d_name, len), QFileSystemEntry::FromNativePath());
+            metaData.fillFromDirEnt(*dirEntry);
+
+            // The file type is all QDirIterator needs to apply its filters,
+            // and for most entries d_type has it already. Where it doesn't
+            // (file systems that don't fill it in, and symlinks, whose target
+            // we need), look it up relative to the directory instead of
+            // letting QFileInfo stat the full path later.
+            if (!metaData.hasFlags(QFileSystemMetaData::DirectoryType | QFileSystemMetaData::ExistsAttribute))
+                QFileSystemEngine::fillMetaData(dirFd, dirEntry->d_name, metaData, QFileSystemMetaData::Type);
+            return true;
+        }
+    }
+}
+
+#else // !QT_FILESYSTEMITERATOR_GETDENTS
+
 QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Filters filters,
                                          const QStringList &nameFilters, QDirIterator::IteratorFlags flags)
     : nativePath(entry.nativeFilePath())
@@ -139,6 +238,8 @@ bool QFileSystemIterator::advance(QFileSystemEntry &fileEntry, QFileSystemMetaDa
     return false;
 }
 
+#endif // QT_FILESYSTEMITERATOR_GETDENTS
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_FILESYSTEMITERATOR
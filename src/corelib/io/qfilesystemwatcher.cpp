@@ -43,6 +43,7 @@
 #include <qdatetime.h>
 #include <qdebug.h>
 #include <qdir.h>
+#include <qdiriterator.h>
 #include <qfileinfo.h>
 #include <qset.h>
 #include <qtimer.h>
@@ -86,7 +87,7 @@ QFileSystemWatcherEngine *QFileSystemWatcherPrivate::createNativeEngine(QObject
 }
 
 QFileSystemWatcherPrivate::QFileSystemWatcherPrivate()
-    : native(0), poller(0)
+    : native(0), poller(0), coalescingTimer(nullptr), coalescingInterval(-1)
 {
 }
 
@@ -103,6 +104,8 @@ void QFileSystemWatcherPrivate::init()
                          SIGNAL(directoryChanged(QString,bool)),
                          q,
                          SLOT(_q_directoryChanged(QString,bool)));
+        QObject::connect(native, &QFileSystemWatcherEngine::eventsDropped,
+                         q, [q] { emit q->eventsDropped(QFileSystemWatcher::QPrivateSignal()); });
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
         QObject::connect(static_cast<QWindowsFileSystemWatcherEngine *>(native),
                          &QWindowsFileSystemWatcherEngine::driveLockForRemoval,
@@ -134,28 +137,129 @@ void QFileSystemWatcherPrivate::initPollerEngine()
                      SLOT(_q_directoryChanged(QString,bool)));
 }
 
+void QFileSystemWatcherPrivate::addToIndex(int oldFileCount, int oldDirectoryCount)
+{
+    // the engines only ever append to the lists
+    for (int i = oldFileCount; i < files.size(); ++i)
+        fileSet.insert(files.at(i));
+    for (int i = oldDirectoryCount; i < directories.size(); ++i)
+        directorySet.insert(directories.at(i));
+}
+
+void QFileSystemWatcherPrivate::removeFromIndex(const QStringList &paths, const QStringList &failed)
+{
+    QSet<QString> failedSet;
+    failedSet.reserve(failed.size());
+    for (const QString &path : failed)
+        failedSet.insert(path);
+
+    for (const QString &path : paths) {
+        if (failedSet.contains(path))
+            continue;
+        fileSet.remove(path);
+        directorySet.remove(path);
+        recursiveDirectories.remove(path);
+    }
+}
+
+/*!
+    \internal
+
+    Watches all subdirectories of \a path that are not watched yet, and
+    marks them for automatic watching of their own new subdirectories.
+    Subdirectories that were already handled this way are not descended
+    into again, so calling this for every change of \a path is cheap.
+    Returns the subdirectories that could not be watched.
+*/
+QStringList QFileSystemWatcherPrivate::watchSubdirectories(const QString &path)
+{
+    Q_Q(QFileSystemWatcher);
+    QStringList newDirectories;
+    QStringList pending(path);
+    while (!pending.isEmpty()) {
+        const QString directory = pending.takeLast();
+        recursiveDirectories.insert(directory);
+
+        // symlinks are not followed, to stay out of loops
+        QDirIterator it(directory, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+        while (it.hasNext()) {
+            const QString subdirectory = it.next();
+            if (recursiveDirectories.contains(subdirectory))
+                continue;
+            if (!directorySet.contains(subdirectory))
+                newDirectories.append(subdirectory);
+            pending.append(subdirectory);
+        }
+    }
+
+    if (newDirectories.isEmpty())
+        return QStringList();
+
+    const QStringList failed = q->addPaths(newDirectories);
+    for (const QString &directory : failed)
+        recursiveDirectories.remove(directory);
+    return failed;
+}
+
+void QFileSystemWatcherPrivate::pathChanged(const QString &path)
+{
+    if (coalescingInterval < 0)
+        return;
+
+    if (!changedPathSet.contains(path)) {
+        changedPathSet.insert(path);
+        changedPaths.append(path);
+    }
+    // The timer isn't restarted by later changes, so a steady stream of
+    // changes is still reported every interval.
+    if (!coalescingTimer->isActive())
+        coalescingTimer->start(coalescingInterval);
+}
+
+void QFileSystemWatcherPrivate::emitPathsChanged()
+{
+    Q_Q(QFileSystemWatcher);
+    if (changedPaths.isEmpty())
+        return;
+
+    const QStringList paths = std::move(changedPaths);
+    changedPaths.clear();
+    changedPathSet.clear();
+    emit q->pathsChanged(paths, QFileSystemWatcher::QPrivateSignal());
+}
+
 void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
 {
     Q_Q(QFileSystemWatcher);
-    if (!files.contains(path)) {
+    if (!fileSet.contains(path)) {
         // the path was removed after a change was detected, but before we delivered the signal
         return;
     }
-    if (removed)
+    if (removed) {
         files.removeAll(path);
+        fileSet.remove(path);
+    }
     emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+    pathChanged(path);
 }
 
 void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool removed)
 {
     Q_Q(QFileSystemWatcher);
-    if (!directories.contains(path)) {
+    if (!directorySet.contains(path)) {
         // perhaps the path was removed after a change was detected, but before we delivered the signal
         return;
     }
-    if (removed)
+    if (removed) {
         directories.removeAll(path);
+        directorySet.remove(path);
+        recursiveDirectories.remove(path);
+    } else if (recursiveDirectories.contains(path)) {
+        // pick up subdirectories that were created or moved in
+        watchSubdirectories(path);
+    }
     emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+    pathChanged(path);
 }
 
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
@@ -247,9 +351,30 @@ void  QFileSystemWatcherPrivate::_q_winDriveRemoved(const QString &path)
     \endlist
     \endlist
 
+    When many paths change at once, for instance while a build runs in a
+    watched source tree, handling every fileChanged() and
+    directoryChanged() signal separately can be expensive. Call
+    setCoalescingInterval() to have the changes collected and reported
+    together with the pathsChanged() signal. If the operating system had
+    to drop change notifications, eventsDropped() is emitted and the
+    watched paths should be rescanned.
+
     \sa QFile, QDir
 */
 
+/*!
+    \enum QFileSystemWatcher::WatchFlag
+    \since 5.14
+
+    This enum describes flags that can be passed to addPaths().
+
+    \value NoWatchFlags The paths are watched by themselves.
+    \value WatchSubdirectories Directories are watched together with all
+    their subdirectories, and subdirectories that are created or moved into
+    them later on are watched automatically. Symbolic links to directories
+    are not followed.
+*/
+
 
 /*!
     Constructs a new file system watcher object with the given \a parent.
@@ -378,9 +503,43 @@ QStringList QFileSystemWatcher::addPaths(const QStringList &paths)
         }
     }
 
-    if(engine)
+    if(engine) {
+        const int fileCount = d->files.size();
+        const int directoryCount = d->directories.size();
         p = engine->addPaths(p, &d->files, &d->directories);
+        d->addToIndex(fileCount, directoryCount);
+    }
+
+    return p;
+}
 
+/*!
+    \overload
+    \since 5.14
+
+    Adds each path in \a paths to the file system watcher, as modified by
+    \a flags. If \a flags contains WatchSubdirectories, all subdirectories
+    of the directories in \a paths are watched as well.
+
+    The return value is a list of paths that could not be watched,
+    including subdirectories.
+
+    \note Every watched subdirectory counts towards the system dependent
+    limit on the number of watched paths.
+
+    \sa addPath(), removePaths()
+*/
+QStringList QFileSystemWatcher::addPaths(const QStringList &paths, WatchFlags flags)
+{
+    Q_D(QFileSystemWatcher);
+
+    QStringList p = addPaths(paths);
+    if (flags & WatchSubdirectories) {
+        for (const QString &path : paths) {
+            if (d->directorySet.contains(path))
+                p += d->watchSubdirectories(path);
+        }
+    }
     return p;
 }
 
@@ -434,10 +593,32 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
         return QStringList();
     }
 
+    // removing a recursively watched directory removes its subdirectories
+    if (!d->recursiveDirectories.isEmpty()) {
+        QSet<QString> roots;
+        for (const QString &path : qAsConst(p)) {
+            if (d->recursiveDirectories.contains(path))
+                roots.insert(path);
+        }
+        if (!roots.isEmpty()) {
+            for (const QString &directory : qAsConst(d->recursiveDirectories)) {
+                for (int i = directory.lastIndexOf(QLatin1Char('/')); i > 0;
+                     i = directory.lastIndexOf(QLatin1Char('/'), i - 1)) {
+                    if (roots.contains(directory.left(i))) {
+                        p.append(directory);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    const QStringList requested = p;
     if (d->native)
         p = d->native->removePaths(p, &d->files, &d->directories);
     if (d->poller)
         p = d->poller->removePaths(p, &d->files, &d->directories);
+    d->removeFromIndex(requested, p);
 
     return p;
 }
@@ -451,6 +632,74 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
     \sa directoryChanged()
 */
 
+/*!
+    \fn void QFileSystemWatcher::pathsChanged(const QStringList &paths)
+    \since 5.14
+
+    This signal is emitted with the watched files and directories that
+    changed, or were removed, since it was last emitted. It is only emitted
+    if a coalescing interval is set, at most once per interval. Each path is
+    listed once, no matter how many changes it had.
+
+    \sa setCoalescingInterval(), fileChanged(), directoryChanged()
+*/
+
+/*!
+    \fn void QFileSystemWatcher::eventsDropped()
+    \since 5.14
+
+    This signal is emitted when the operating system dropped change
+    notifications, for instance because its event queue overflowed (on
+    Linux, \c IN_Q_OVERFLOW). Changes may have gone unreported, so the
+    watched paths should be rescanned.
+*/
+
+/*!
+    \since 5.14
+
+    Returns the interval in milliseconds over which changes are collected
+    before pathsChanged() is emitted, or -1 if pathsChanged() is not emitted.
+    The default is -1.
+
+    \sa setCoalescingInterval()
+*/
+int QFileSystemWatcher::coalescingInterval() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->coalescingInterval;
+}
+
+/*!
+    \since 5.14
+
+    Sets the interval over which changes are collected before pathsChanged()
+    is emitted to \a msecs milliseconds. The interval starts with the first
+    change after pathsChanged() was emitted, so a steady stream of changes
+    is reported every \a msecs milliseconds. Set it to -1 to stop emitting
+    pathsChanged().
+
+    fileChanged() and directoryChanged() are emitted for every change,
+    regardless of this setting.
+
+    \sa coalescingInterval()
+*/
+void QFileSystemWatcher::setCoalescingInterval(int msecs)
+{
+    Q_D(QFileSystemWatcher);
+    if (msecs < 0) {
+        // report what we have so far
+        msecs = -1;
+        if (d->coalescingTimer)
+            d->coalescingTimer->stop();
+        d->emitPathsChanged();
+    } else if (!d->coalescingTimer) {
+        d->coalescingTimer = new QTimer(this);
+        d->coalescingTimer->setSingleShot(true);
+        connect(d->coalescingTimer, &QTimer::timeout, this, [d] { d->emitPathsChanged(); });
+    }
+    d->coalescingInterval = msecs;
+}
+
 /*!
     \fn void QFileSystemWatcher::directoryChanged(const QString &path)
 
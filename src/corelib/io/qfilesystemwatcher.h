@@ -41,6 +41,7 @@
 #define QFILESYSTEMWATCHER_H
 
 #include <QtCore/qobject.h>
+#include <QtCore/qstringlist.h>
 
 QT_REQUIRE_CONFIG(filesystemwatcher);
 
@@ -55,27 +56,41 @@ class Q_CORE_EXPORT QFileSystemWatcher : public QObject
     Q_DECLARE_PRIVATE(QFileSystemWatcher)
 
 public:
+    enum WatchFlag {
+        NoWatchFlags = 0x0,
+        WatchSubdirectories = 0x1
+    };
+    Q_DECLARE_FLAGS(WatchFlags, WatchFlag)
+
     QFileSystemWatcher(QObject *parent = nullptr);
     QFileSystemWatcher(const QStringList &paths, QObject *parent = nullptr);
     ~QFileSystemWatcher();
 
     bool addPath(const QString &file);
     QStringList addPaths(const QStringList &files);
+    QStringList addPaths(const QStringList &paths, WatchFlags flags);
     bool removePath(const QString &file);
     QStringList removePaths(const QStringList &files);
 
     QStringList files() const;
     QStringList directories() const;
 
+    int coalescingInterval() const;
+    void setCoalescingInterval(int msecs);
+
 Q_SIGNALS:
     void fileChanged(const QString &path, QPrivateSignal);
     void directoryChanged(const QString &path, QPrivateSignal);
+    void pathsChanged(const QStringList &paths, QPrivateSignal);
+    void eventsDropped(QPrivateSignal);
 
 private:
     Q_PRIVATE_SLOT(d_func(), void _q_fileChanged(const QString &path, bool removed))
     Q_PRIVATE_SLOT(d_func(), void _q_directoryChanged(const QString &path, bool removed))
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QFileSystemWatcher::WatchFlags)
+
 QT_END_NAMESPACE
 
 #endif // QFILESYSTEMWATCHER_H
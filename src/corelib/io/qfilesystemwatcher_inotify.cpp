@@ -45,10 +45,12 @@
 
 #include <qdebug.h>
 #include <qfile.h>
-#include <qfileinfo.h>
+#include <qset.h>
 #include <qsocketnotifier.h>
 #include <qvarlengtharray.h>
 
+#include <algorithm>
+
 #if defined(Q_OS_LINUX)
 #include <sys/syscall.h>
 #include <sys/ioctl.h>
@@ -208,6 +210,8 @@ struct inotify_event {
 #define IN_Q_OVERFLOW           0x00004000
 #define IN_IGNORED              0x00008000
 
+#define IN_ONLYDIR              0x01000000
+
 #define IN_CLOSE                (IN_CLOSE_WRITE | IN_CLOSE_NOWRITE)
 #define IN_MOVE                 (IN_MOVED_FROM | IN_MOVED_TO)
 }
@@ -272,33 +276,34 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
     QMutableListIterator<QString> it(p);
     while (it.hasNext()) {
         QString path = it.next();
-        QFileInfo fi(path);
-        bool isDir = fi.isDir();
-        if (isDir) {
-            if (directories->contains(path))
-                continue;
-        } else {
-            if (files->contains(path))
-                continue;
-        }
+        // pathToID has every path we watch, files and directories alike
+        if (pathToID.contains(path))
+            continue;
 
-        int wd = inotify_add_watch(inotifyFd,
-                                   QFile::encodeName(path),
-                                   (isDir
-                                    ? (0
-                                       | IN_ATTRIB
-                                       | IN_MOVE
-                                       | IN_CREATE
-                                       | IN_DELETE
-                                       | IN_DELETE_SELF
-                                       )
-                                    : (0
-                                       | IN_ATTRIB
-                                       | IN_MODIFY
-                                       | IN_MOVE
-                                       | IN_MOVE_SELF
-                                       | IN_DELETE_SELF
-                                       )));
+        // Try to watch it as a directory first and let the kernel tell us
+        // if it isn't one, instead of stat'ing every path beforehand. This
+        // saves a system call per directory when adding large trees.
+        const QByteArray nativePath = QFile::encodeName(path);
+        bool isDir = true;
+        int wd = inotify_add_watch(inotifyFd, nativePath,
+                                   IN_ONLYDIR
+                                   | IN_ATTRIB
+                                   | IN_MOVE
+                                   | IN_CREATE
+                                   | IN_DELETE
+                                   | IN_DELETE_SELF
+                                   );
+        if (wd < 0 && errno == ENOTDIR) {
+            isDir = false;
+            wd = inotify_add_watch(inotifyFd, nativePath,
+                                   (0
+                                    | IN_ATTRIB
+                                    | IN_MODIFY
+                                    | IN_MOVE
+                                    | IN_MOVE_SELF
+                                    | IN_DELETE_SELF
+                                    ));
+        }
         if (wd < 0) {
             if (errno != ENOENT)
                 qErrnoWarning("inotify_add_watch(%ls) failed:", path.constData());
@@ -325,11 +330,18 @@ QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &path
                                                          QStringList *files,
                                                          QStringList *directories)
 {
+    QSet<QString> removedFiles;
+    QSet<QString> removedDirectories;
+
     QStringList p = paths;
     QMutableListIterator<QString> it(p);
     while (it.hasNext()) {
         QString path = it.next();
-        int id = pathToID.take(path);
+        const auto id_it = pathToID.constFind(path);
+        if (id_it == pathToID.constEnd())
+            continue;
+        const int id = *id_it;
+        pathToID.erase(id_it);
 
         // Multiple paths could be associated to the same watch descriptor
         // when a file is moved and added with the new name.
@@ -351,12 +363,23 @@ QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &path
 
         it.remove();
         if (id < 0) {
-            directories->removeAll(path);
+            removedDirectories.insert(path);
         } else {
-            files->removeAll(path);
+            removedFiles.insert(path);
         }
     }
 
+    // remove them from the lists in one pass each, rather than one pass per path
+    auto removeAll = [](QStringList *list, const QSet<QString> &removed) {
+        if (!removed.isEmpty()) {
+            list->erase(std::remove_if(list->begin(), list->end(),
+                                       [&removed](const QString &path) { return removed.contains(path); }),
+                        list->end());
+        }
+    };
+    removeAll(files, removedFiles);
+    removeAll(directories, removedDirectories);
+
     return p;
 }
 
@@ -371,18 +394,28 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
     char *at = buffer.data();
     char * const end = at + buffSize;
 
+    bool overflowed = false;
     QHash<int, inotify_event *> eventForId;
     while (at < end) {
         inotify_event *event = reinterpret_cast<inotify_event *>(at);
+        at += sizeof(inotify_event) + event->len;
+
+        // the kernel's queue overflowed and events were lost; this event
+        // doesn't belong to any watch
+        if (event->mask & IN_Q_OVERFLOW) {
+            overflowed = true;
+            continue;
+        }
 
         if (eventForId.contains(event->wd))
             eventForId[event->wd]->mask |= event->mask;
         else
             eventForId.insert(event->wd, event);
-
-        at += sizeof(inotify_event) + event->len;
     }
 
+    if (overflowed)
+        emit eventsDropped();
+
     QHash<int, inotify_event *>::const_iterator it = eventForId.constBegin();
     while (it != eventForId.constEnd()) {
         const inotify_event &event = **it;
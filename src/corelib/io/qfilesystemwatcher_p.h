@@ -59,9 +59,12 @@ QT_REQUIRE_CONFIG(filesystemwatcher);
 
 #include <QtCore/qstringlist.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qset.h>
 
 QT_BEGIN_NAMESPACE
 
+class QTimer;
+
 class QFileSystemWatcherEngine : public QObject
 {
     Q_OBJECT
@@ -88,6 +91,8 @@ public:
 Q_SIGNALS:
     void fileChanged(const QString &path, bool removed);
     void directoryChanged(const QString &path, bool removed);
+    // change notifications were lost, e.g. because a kernel queue overflowed
+    void eventsDropped();
 };
 
 class QFileSystemWatcherPrivate : public QObjectPrivate
@@ -101,9 +106,28 @@ public:
     void init();
     void initPollerEngine();
 
+    void connectEngine(QFileSystemWatcherEngine *engine);
+    void addToIndex(int oldFileCount, int oldDirectoryCount);
+    void removeFromIndex(const QStringList &paths, const QStringList &failed);
+    QStringList watchSubdirectories(const QString &path);
+    void pathChanged(const QString &path);
+    void emitPathsChanged();
+
     QFileSystemWatcherEngine *native, *poller;
     QStringList files, directories;
 
+    // the same as files and directories, for fast lookups
+    QSet<QString> fileSet, directorySet;
+
+    // directories whose new subdirectories are watched automatically
+    QSet<QString> recursiveDirectories;
+
+    // changes not yet reported with pathsChanged()
+    QStringList changedPaths;
+    QSet<QString> changedPathSet;
+    QTimer *coalescingTimer;
+    int coalescingInterval;
+
     // private slots
     void _q_fileChanged(const QString &path, bool removed);
     void _q_directoryChanged(const QString &path, bool removed);
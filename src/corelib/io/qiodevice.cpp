@@ -823,6 +823,7 @@ void QIODevice::close()
     d->pos = 0;
     d->transactionStarted = false;
     d->transactionPos = 0;
+    d->viewOwner.clear();
     d->setReadChannelCount(0);
     // Do not clear write buffers to allow delayed close in sockets
     d->writeChannelCount = 0;
@@ -1896,6 +1897,138 @@ QByteArray QIODevice::peek(qint64 maxSize)
     return d->peek(maxSize);
 }
 
+/*!
+    \since 5.14
+
+    Returns at most \a maxSize bytes from the current position without
+    consuming them, like peek(), but without copying the data whenever
+    possible: the returned QByteArray refers to memory owned by the device,
+    such as its read buffer, the byte array of a QBuffer or a memory mapping
+    of a large file. It may contain fewer bytes than are available, since it
+    only covers data that the device stores contiguously.
+
+    The returned data stays valid until the next call to peekView() or
+    readView(), or until the device is closed or destroyed, whichever happens
+    first. Use QByteArray::detach() on it to keep a copy for longer.
+
+    Devices opened in text mode cannot provide views, as their end-of-line
+    translation changes the data; for them, this function returns a copy.
+
+    This function has no way of reporting errors; returning an empty
+    QByteArray can mean either that no data was currently available
+    for peeking, or that an error occurred.
+
+    \sa readView(), peek(), QFileDevice::map()
+*/
+QByteArray QIODevice::peekView(qint64 maxSize)
+{
+    Q_D(QIODevice);
+
+    CHECK_MAXLEN(peekView, QByteArray());
+    CHECK_MAXBYTEARRAYSIZE(peekView);
+    CHECK_READABLE(peekView, QByteArray());
+
+    return d->readView(maxSize, true);
+}
+
+/*!
+    \since 5.14
+
+    Reads at most \a maxSize bytes from the device and returns them without
+    copying the data whenever possible, in the same way as peekView(). The
+    returned data stays valid until the next call to peekView() or
+    readView(), or until the device is closed or destroyed.
+
+    Parsers that process their input in chunks can use this function instead
+    of read() to avoid copying every chunk into a buffer of their own. As the
+    chunks only ever cover contiguous data, they can be shorter than \a maxSize
+    even if more data is available.
+
+    This function has no way of reporting errors; returning an empty
+    QByteArray can mean either that no data was currently available
+    for reading, or that an error occurred.
+
+    \sa peekView(), read()
+*/
+QByteArray QIODevice::readView(qint64 maxSize)
+{
+    Q_D(QIODevice);
+
+    CHECK_MAXLEN(readView, QByteArray());
+    CHECK_MAXBYTEARRAYSIZE(readView);
+    CHECK_READABLE(readView, QByteArray());
+
+    return d->readView(maxSize, false);
+}
+
+/*!
+    \internal
+
+    Returns a view of at most \a maxSize bytes at the current position, taken
+    from the device's own storage if it has any, or else from the read buffer,
+    which is filled by a single readData() call if needed.
+*/
+QByteArray QIODevicePrivate::readView(qint64 maxSize, bool peeking)
+{
+    Q_Q(QIODevice);
+
+    // Views can't present the result of the end-of-line translation.
+    if (openMode & QIODevice::Text)
+        return peeking ? peek(maxSize) : q->read(maxSize);
+
+    // The previous view is no longer needed.
+    viewOwner.clear();
+    if (maxSize == 0)
+        return QByteArray();
+
+    const bool sequential = isSequential();
+    if (isBufferEmpty()) {
+        if (!sequential) {
+            const QByteArray view = directView(maxSize);
+            if (!view.isNull()) {
+                if (!peeking)
+                    pos += view.size();
+                return view;
+            }
+        }
+
+        if (sequential || pos == devicePos || q->seek(pos)) {
+            const qint64 bytesToBuffer = qMax<qint64>(readBufferChunkSize, 1);
+            const qint64 readFromDevice = q->readData(buffer.reserve(bytesToBuffer), bytesToBuffer);
+            buffer.chop(bytesToBuffer - qMax(Q_INT64_C(0), readFromDevice));
+            if (readFromDevice > 0 && !sequential)
+                devicePos += readFromDevice;
+        }
+    }
+
+    const qint64 bufferPos = (sequential && transactionStarted) ? transactionPos : Q_INT64_C(0);
+    const QByteArray view = buffer.peekView(bufferPos, maxSize, &viewOwner);
+    if (!peeking && !view.isEmpty()) {
+        if (sequential && transactionStarted)
+            transactionPos += view.size();
+        else
+            buffer.free(view.size());
+        if (!sequential)
+            pos += view.size();
+        if (buffer.isEmpty())
+            q->readData(nullptr, 0);
+    }
+    return view;
+}
+
+/*!
+    \internal
+
+    Returns a view of at most \a maxSize bytes at the current position that
+    refers to memory the device owns, or a null byte array if it has none.
+    Only called for random-access devices with an empty read buffer.
+*/
+QByteArray QIODevicePrivate::directView(qint64 maxSize)
+{
+    Q_UNUSED(maxSize);
+    return QByteArray();
+}
+
 /*!
     \since 5.10
 
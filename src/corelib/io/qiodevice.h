@@ -138,6 +138,8 @@ public:
 
     qint64 peek(char *data, qint64 maxlen);
     QByteArray peek(qint64 maxlen);
+    QByteArray peekView(qint64 maxSize);
+    QByteArray readView(qint64 maxSize);
     qint64 skip(qint64 maxSize);
 
     virtual bool waitForReadyRead(int msecs);
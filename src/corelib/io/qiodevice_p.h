@@ -113,6 +113,7 @@ public:
         inline qint64 read(char *data, qint64 maxLength) { return (m_buf ? m_buf->read(data, maxLength) : Q_INT64_C(0)); }
         inline QByteArray read() { return (m_buf ? m_buf->read() : QByteArray()); }
         inline qint64 peek(char *data, qint64 maxLength, qint64 pos = 0) const { return (m_buf ? m_buf->peek(data, maxLength, pos) : Q_INT64_C(0)); }
+        inline QByteArray peekView(qint64 pos, qint64 maxLength, QByteArray *owner) const { return (m_buf ? m_buf->peekView(pos, maxLength, owner) : QByteArray()); }
         inline void append(const char *data, qint64 size) { Q_ASSERT(m_buf); m_buf->append(data, size); }
         inline void append(const QByteArray &qba) { Q_ASSERT(m_buf); m_buf->append(qba); }
         inline qint64 skip(qint64 length) { return (m_buf ? m_buf->skip(length) : Q_INT64_C(0)); }
@@ -131,6 +132,7 @@ public:
     int readBufferChunkSize;
     int writeBufferChunkSize;
     qint64 transactionPos;
+    QByteArray viewOwner;
     bool transactionStarted;
     bool baseReadLineDataCalled;
 
@@ -174,6 +176,8 @@ public:
     qint64 read(char *data, qint64 maxSize, bool peeking = false);
     virtual qint64 peek(char *data, qint64 maxSize);
     virtual QByteArray peek(qint64 maxSize);
+    QByteArray readView(qint64 maxSize, bool peeking);
+    virtual QByteArray directView(qint64 maxSize);
     qint64 skipByReading(qint64 maxSize);
     // ### Qt6: consider replacing with a protected virtual QIODevice::skipData().
     virtual qint64 skip(qint64 maxSize);
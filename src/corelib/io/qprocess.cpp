@@ -1963,6 +1963,10 @@ void QProcess::setProcessState(ProcessState state)
 
     \warning This function is called by QProcess on Unix and \macos
     only. On Windows and QNX, it is not called.
+
+    \note On Linux, QProcess itself starts programs with \c posix_spawn(),
+    which does not copy the parent's address space. Subclasses go through
+    \c fork() so that this function can run in the child.
 */
 void QProcess::setupChildProcess()
 {
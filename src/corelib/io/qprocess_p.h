@@ -63,6 +63,7 @@ QT_REQUIRE_CONFIG(processenvironment);
 
 #ifdef Q_OS_UNIX
 #include <QtCore/private/qorderedmutexlocker_p.h>
+#include <sys/types.h>
 #endif
 
 #ifdef Q_OS_WIN
@@ -350,6 +351,7 @@ public:
     void startProcess();
 #if defined(Q_OS_UNIX)
     void execChild(const char *workingDirectory, char **argv, char **envp);
+    int spawnChild(const char *workingDirectory, char **argv, char **envp, pid_t *childPid);
 #endif
     bool processStarted(QString *errorMessage = nullptr);
     void terminateProcess();
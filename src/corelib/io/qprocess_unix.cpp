@@ -117,6 +117,20 @@ QT_END_NAMESPACE
 #include <forkfd.h>
 #endif
 
+// posix_spawn() creates the child with vfork semantics (no copy of the page
+// tables) and reports exec() errors since glibc 2.24.
+#if QT_CONFIG(process) && defined(Q_OS_LINUX) && defined(__GLIBC__) && _POSIX_SPAWN > 0 \
+    && (defined(__cpp_rtti) || defined(__GXX_RTTI))
+#  if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 24)
+#    define QPROCESS_USE_SPAWN
+#    include <spawn.h>
+#    include <typeinfo>
+#    if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29)
+#      define QPROCESS_HAVE_SPAWN_CHDIR
+#    endif
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if !defined(Q_OS_DARWIN)
@@ -359,6 +373,97 @@ static char **_q_dupEnvironment(const QProcessEnvironmentPrivate::Map &environme
     return envp;
 }
 
+struct ChildError
+{
+    int code;
+    char function[8];
+};
+
+#ifdef QPROCESS_USE_SPAWN
+static bool qt_can_spawn(const QProcess *process, const char *workingDir)
+{
+    // A reimplemented setupChildProcess() must run in the child between
+    // fork() and exec(), which posix_spawn() cannot do.
+    if (typeid(*process) != typeid(QProcess))
+        return false;
+#ifndef QPROCESS_HAVE_SPAWN_CHDIR
+    if (workingDir)
+        return false;
+#else
+    Q_UNUSED(workingDir);
+#endif
+    return true;
+}
+
+/*
+    Starts the child with posix_spawn(), setting it up like execChild() does.
+    Returns the forkfd or -1 with errno set; unlike fork(), that includes
+    errors from exec().
+*/
+int QProcessPrivate::spawnChild(const char *workingDir, char **argv, char **envp, pid_t *childPid)
+{
+    posix_spawn_file_actions_t fileActions;
+    posix_spawnattr_t attr;
+    int ret = posix_spawn_file_actions_init(&fileActions);
+    if (ret != 0) {
+        errno = ret;
+        return -1;
+    }
+    ret = posix_spawnattr_init(&attr);
+    if (ret != 0) {
+        posix_spawn_file_actions_destroy(&fileActions);
+        errno = ret;
+        return -1;
+    }
+
+    // copy the stdin socket if asked to
+    if (inputChannelMode != QProcess::ForwardedInputChannel)
+        ret = posix_spawn_file_actions_adddup2(&fileActions, stdinChannel.pipe[0], STDIN_FILENO);
+
+    // copy the stdout and stderr if asked to
+    if (ret == 0 && processChannelMode != QProcess::ForwardedChannels) {
+        if (processChannelMode != QProcess::ForwardedOutputChannel)
+            ret = posix_spawn_file_actions_adddup2(&fileActions, stdoutChannel.pipe[1], STDOUT_FILENO);
+
+        // merge stdout and stderr if asked to
+        if (ret == 0 && processChannelMode == QProcess::MergedChannels)
+            ret = posix_spawn_file_actions_adddup2(&fileActions, STDOUT_FILENO, STDERR_FILENO);
+        else if (ret == 0 && processChannelMode != QProcess::ForwardedErrorChannel)
+            ret = posix_spawn_file_actions_adddup2(&fileActions, stderrChannel.pipe[1], STDERR_FILENO);
+    }
+
+#ifdef QPROCESS_HAVE_SPAWN_CHDIR
+    // enter the working directory
+    if (ret == 0 && workingDir)
+        ret = posix_spawn_file_actions_addchdir_np(&fileActions, workingDir);
+#endif
+
+    // reset the signal that we ignored
+    sigset_t defaultSignals;
+    sigemptyset(&defaultSignals);
+    sigaddset(&defaultSignals, SIGPIPE);
+    if (ret == 0)
+        ret = posix_spawnattr_setsigdefault(&attr, &defaultSignals);
+    if (ret == 0)
+        ret = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+    int ffd = -1;
+    if (ret == 0) {
+#if defined (QPROCESS_DEBUG)
+        fprintf(stderr, "QProcessPrivate::spawnChild() starting %s\n", argv[0]);
+#endif
+        ffd = ::spawnfd(FFD_CLOEXEC, childPid, argv[0], &fileActions, &attr, argv,
+                        envp ? envp : environ);
+        ret = errno;
+    }
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&fileActions);
+    errno = ret;
+    return ffd;
+}
+#endif // QPROCESS_USE_SPAWN
+
 void QProcessPrivate::startProcess()
 {
     Q_Q(QProcess);
@@ -453,8 +558,33 @@ void QProcessPrivate::startProcess()
 
     // Start the process manager, and fork off the child process.
     pid_t childPid;
-    forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
-    int lastForkErrno = errno;
+    int lastForkErrno;
+    bool spawnFailed = false;
+#ifdef QPROCESS_USE_SPAWN
+    if (qt_can_spawn(q, workingDirPtr)) {
+        forkfd = spawnChild(workingDirPtr, argv, envp, &childPid);
+        lastForkErrno = errno;
+        if (forkfd == -1 && lastForkErrno != EAGAIN && lastForkErrno != ENOMEM) {
+            // Not a resource problem: report it like a child whose exec()
+            // failed, through the startup notification.
+            ChildError error = { lastForkErrno, {} };
+            if (workingDirPtr && ::access(workingDirPtr, X_OK) == -1) {
+                // posix_spawn() does not say which step failed
+                error.code = errno;
+                strcpy(error.function, "chdir");
+            } else {
+                strcpy(error.function, envp ? "execve" : "execvp");
+            }
+            qt_safe_write(childStartedPipe[1], &error, sizeof(error));
+            childPid = 0;
+            spawnFailed = true;
+        }
+    } else
+#endif
+    {
+        forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
+        lastForkErrno = errno;
+    }
     if (forkfd != FFD_CHILD_PROCESS) {
         // Parent process.
         // Clean up duplicated memory.
@@ -470,7 +600,7 @@ void QProcessPrivate::startProcess()
     // This is intentional because we only want to handle failure to fork()
     // here, which is a rare occurrence. Handling of the failure to start is
     // done elsewhere.
-    if (forkfd == -1) {
+    if (forkfd == -1 && !spawnFailed) {
         // Cleanup, report error and return
 #if defined (QPROCESS_DEBUG)
         qDebug("fork failed: %s", qPrintable(qt_error_string(lastForkErrno)));
@@ -518,19 +648,13 @@ void QProcessPrivate::startProcess()
     if (stderrChannel.pipe[0] != -1)
         ::fcntl(stderrChannel.pipe[0], F_SETFL, ::fcntl(stderrChannel.pipe[0], F_GETFL) | O_NONBLOCK);
 
-    if (threadData->eventDispatcher) {
+    if (threadData->eventDispatcher && forkfd != -1) {
         deathNotifier = new QSocketNotifier(forkfd, QSocketNotifier::Read, q);
         QObject::connect(deathNotifier, SIGNAL(activated(int)),
                          q, SLOT(_q_processDied()));
     }
 }
 
-struct ChildError
-{
-    int code;
-    char function[8];
-};
-
 void QProcessPrivate::execChild(const char *workingDir, char **argv, char **envp)
 {
     ::signal(SIGPIPE, SIG_DFL);         // reset the signal that we ignored
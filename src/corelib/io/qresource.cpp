@@ -50,6 +50,7 @@
 #include "qdatetime.h"
 #include "qbytearray.h"
 #include "qstringlist.h"
+#include "qvarlengtharray.h"
 #include "qendian.h"
 #include <qshareddata.h>
 #include <qplatformdefs.h>
@@ -135,19 +136,22 @@ public:
         // must match rcc.h
         Compressed = 0x01,
         Directory = 0x02,
-        CompressedZstd = 0x04
+        CompressedZstd = 0x04,
+        PathIndex = 0x08        // root only
     };
 private:
-    const uchar *tree, *names, *payloads;
+    const uchar *tree, *names, *payloads, *index;
     int version;
     inline int findOffset(int node) const { return node * (14 + (version >= 0x02 ? 8 : 0)); } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
+    bool nameEquals(int node, QStringView name) const;
     short flags(int node) const;
+    int findIndexedNode(QStringView path, const QLocale &locale) const;
 public:
     mutable QAtomicInt ref;
 
-    inline QResourceRoot(): tree(0), names(0), payloads(0), version(0) {}
+    inline QResourceRoot(): tree(0), names(0), payloads(0), index(nullptr), version(0) {}
     inline QResourceRoot(int version, const uchar *t, const uchar *n, const uchar *d) { setSource(version, t, n, d); }
     virtual ~QResourceRoot() { }
     int findNode(const QString &path, const QLocale &locale=QLocale()) const;
@@ -179,6 +183,10 @@ protected:
         names = n;
         payloads = d;
         version = v;
+        // rcc --path-index stores the offset of the index in the root's name field
+        index = nullptr;
+        if (t && (qFromBigEndian<qint16>(t + 4) & PathIndex))
+            index = t + qFromBigEndian<quint32>(t);
     }
 };
 
@@ -730,6 +738,111 @@ inline QString QResourceRoot::name(int node) const
     return ret;
 }
 
+inline bool QResourceRoot::nameEquals(int node, QStringView str) const
+{
+    if (!node) // root
+        return str.isEmpty();
+    const int offset = findOffset(node);
+    qint32 name_offset = qFromBigEndian<qint32>(tree + offset);
+    const quint16 name_length = qFromBigEndian<quint16>(names + name_offset);
+    if (name_length != str.size())
+        return false;
+    name_offset += 2;
+    name_offset += 4; //jump past hash
+
+    const uchar *data = names + name_offset;
+    for (int i = 0; i < name_length; ++i) {
+        if (qFromBigEndian<quint16>(data + 2 * i) != str.at(i).unicode())
+            return false;
+    }
+    return true;
+}
+
+// must match rcc.cpp
+static uint qt_resource_path_hash(const QStringView *segments, int count, uint seed)
+{
+    uint h = 2166136261u ^ seed;
+    for (int i = 0; i < count; ++i) {
+        if (i)
+            h = (h ^ '/') * 16777619u;
+        for (QChar c : segments[i])
+            h = (h ^ c.unicode()) * 16777619u;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+/*
+    Looks the path up in the perfect hash written by rcc --path-index
+    (see buildPathIndex() in rcc.cpp): a single probe instead of a binary
+    search per path segment. A hit is verified by walking up the parent
+    links; a miss is usually rejected by the stored hash alone.
+*/
+int QResourceRoot::findIndexedNode(QStringView path, const QLocale &locale) const
+{
+    QVarLengthArray<QStringView, 16> segments;
+    QStringSplitter splitter(path);
+    while (splitter.hasNext())
+        segments.append(splitter.next());
+    if (segments.isEmpty())
+        return -1;
+
+    const quint32 slotCount = qFromBigEndian<quint32>(index);
+    const quint32 bucketCount = qFromBigEndian<quint32>(index + 4);
+    const uchar *seeds = index + 8;
+    const uchar *slotTable = seeds + 4 * bucketCount;
+    const uchar *parentTable = slotTable + 8 * slotCount;
+
+    const uint h = qt_resource_path_hash(segments.constData(), segments.size(), 0);
+    const quint32 seed = qFromBigEndian<quint32>(seeds + 4 * (h % bucketCount));
+    const uint slotHash = qt_resource_path_hash(segments.constData(), segments.size(), seed);
+    const uchar *slot = slotTable + 8 * (slotHash % slotCount);
+    const int node = qFromBigEndian<qint32>(slot);
+    if (!node || qFromBigEndian<quint32>(slot + 4) != h)
+        return -1;
+
+    int parent = node;
+    for (int i = segments.size() - 1; i >= 0; --i) {
+        if (!parent || !nameEquals(parent, segments.at(i)))
+            return -1;
+        parent = qFromBigEndian<qint32>(parentTable + 4 * parent);
+    }
+    if (parent)
+        return -1;
+
+    if (flags(node) & Directory)
+        return node;
+
+    // pick the locale like findNode(), among the siblings with this name
+    parent = qFromBigEndian<qint32>(parentTable + 4 * node);
+    int offset = findOffset(parent) + 6; //jump past name and flags
+    const qint32 child_count = qFromBigEndian<qint32>(tree + offset);
+    const qint32 child = qFromBigEndian<qint32>(tree + offset + 4);
+    const uint name_hash = hash(node);
+    int sub_node = node;
+    while (sub_node > child && hash(sub_node - 1) == name_hash)
+        --sub_node;
+    int found = -1;
+    for (; sub_node < child + child_count && hash(sub_node) == name_hash; ++sub_node) {
+        if (!nameEquals(sub_node, segments.last()))
+            continue;
+        offset = findOffset(sub_node) + 6; //jump past name and flags
+        const qint16 country = qFromBigEndian<qint16>(tree + offset);
+        const qint16 language = qFromBigEndian<qint16>(tree + offset + 2);
+        if (country == locale.country() && language == locale.language())
+            return sub_node;
+        if ((country == QLocale::AnyCountry && language == locale.language()) ||
+            (country == QLocale::AnyCountry && language == QLocale::C && found == -1)) {
+            found = sub_node;
+        }
+    }
+    return found;
+}
+
 int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
 {
     QString path = _path;
@@ -755,6 +868,9 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
     if(path == QLatin1String("/"))
         return 0;
 
+    if (index)
+        return findIndexedNode(path, locale);
+
     //the root node is always first
     qint32 child_count = qFromBigEndian<qint32>(tree + 6);
     qint32 child       = qFromBigEndian<qint32>(tree + 10);
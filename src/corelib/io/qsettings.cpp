@@ -69,6 +69,9 @@
 #ifndef QT_BOOTSTRAPPED
 #include "qsavefile.h"
 #include "qlockfile.h"
+#include "qbuffer.h"
+#include "qendian.h"
+#include "qrandom.h"
 #endif
 
 #ifdef Q_OS_VXWORKS
@@ -154,7 +157,8 @@ static QBasicMutex settingsGlobalMutex;
 static QSettings::Format globalDefaultFormat = QSettings::NativeFormat;
 
 QConfFile::QConfFile(const QString &fileName, bool _userPerms)
-    : name(fileName), size(0), ref(1), userPerms(_userPerms)
+    : name(fileName), size(0), ref(1), userPerms(_userPerms),
+      journalOffset(0), journalGeneration(0), journalRecords(0)
 {
     usedHashFunc()->insert(name, this);
 }
@@ -927,7 +931,10 @@ QStringList QSettingsPrivate::splitArgs(const QString &s, int idx)
 
 void QConfFileSettingsPrivate::initFormat()
 {
-    extension = (format == QSettings::NativeFormat) ? QLatin1String(".conf") : QLatin1String(".ini");
+    if (format == QSettings::JournalFormat)
+        extension = QLatin1String(".journal");
+    else
+        extension = (format == QSettings::NativeFormat) ? QLatin1String(".conf") : QLatin1String(".ini");
     readFunc = 0;
     writeFunc = 0;
 #if defined(Q_OS_MAC)
@@ -936,7 +943,7 @@ void QConfFileSettingsPrivate::initFormat()
     caseSensitivity = IniCaseSensitivity;
 #endif
 
-    if (format > QSettings::IniFormat) {
+    if (format > QSettings::IniFormat && format != QSettings::JournalFormat) {
         QMutexLocker locker(&settingsGlobalMutex);
         const CustomFormatVector *customFormatVector = customFormatVectorFunc();
 
@@ -954,7 +961,7 @@ void QConfFileSettingsPrivate::initFormat()
 void QConfFileSettingsPrivate::initAccess()
 {
     if (!confFiles.isEmpty()) {
-        if (format > QSettings::IniFormat) {
+        if (format > QSettings::IniFormat && format != QSettings::JournalFormat) {
             if (!readFunc)
                 setStatus(QSettings::AccessError);
         }
@@ -1384,7 +1391,7 @@ QString QConfFileSettingsPrivate::fileName() const
 
 bool QConfFileSettingsPrivate::isWritable() const
 {
-    if (format > QSettings::IniFormat && !writeFunc)
+    if (format > QSettings::IniFormat && format != QSettings::JournalFormat && !writeFunc)
         return false;
 
     if (confFiles.isEmpty())
@@ -1395,6 +1402,15 @@ bool QConfFileSettingsPrivate::isWritable() const
 
 void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
 {
+    if (format == QSettings::JournalFormat) {
+#ifndef QT_BOOTSTRAPPED
+        syncJournalFile(confFile);
+#else
+        setStatus(QSettings::AccessError);
+#endif
+        return;
+    }
+
     bool readOnly = confFile->addedKeys.isEmpty() && confFile->removedKeys.isEmpty();
 
     /*
@@ -1559,6 +1575,283 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
     }
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*
+    A JournalFormat file starts with a 16 byte header (magic, QDataStream
+    version, generation) followed by records, each of which is a 32-bit
+    big-endian payload size and a QDataStream-encoded payload holding the
+    operation, the key and, for JournalSetRecord, the value.
+
+    Writers only append complete records while holding the lock file, and
+    give the file a new generation whenever they compact it, so a reader that
+    remembers the generation and the offset it stopped at only has to replay
+    the records appended since its last sync.
+*/
+enum JournalRecordType : quint8 {
+    JournalSetRecord = 1,
+    JournalRemoveRecord = 2
+};
+
+static const char journalMagic[4] = { 'Q', 'S', 'J', 'F' };
+static const int JournalHeaderSize = 16;
+static const int JournalStreamVersion = QDataStream::Qt_5_12;
+static const int JournalCompactionSlack = 256;
+
+static void appendJournalRecord(QByteArray *journal, JournalRecordType type,
+                                const QSettingsKey &key, const QVariant *value = nullptr)
+{
+    const int sizePos = journal->size();
+    journal->resize(sizePos + 4);
+    {
+        QBuffer buffer(journal);
+        buffer.open(QIODevice::WriteOnly | QIODevice::Append);
+        QDataStream stream(&buffer);
+        stream.setVersion(JournalStreamVersion);
+        stream << quint8(type) << key.originalCaseKey();
+        if (value)
+            stream << *value;
+    }
+    qToBigEndian<quint32>(quint32(journal->size() - sizePos - 4), journal->data() + sizePos);
+}
+
+/*
+    Brings confFile->originalKeys up to date with the journal in \a device.
+    Only the records past confFile->journalOffset are replayed, unless the
+    file was compacted (or replaced) since the last read. Sets \a *truncated
+    if the file ends in an incomplete or unreadable record.
+*/
+bool QConfFileSettingsPrivate::readJournal(QIODevice &device, QConfFile *confFile, bool *truncated)
+{
+    *truncated = false;
+
+    const QByteArray header = device.read(JournalHeaderSize);
+    if (header.size() < JournalHeaderSize
+            || memcmp(header.constData(), journalMagic, sizeof(journalMagic)) != 0) {
+        confFile->originalKeys.clear();
+        confFile->journalOffset = 0;
+        confFile->journalGeneration = 0;
+        confFile->journalRecords = 0;
+        *truncated = !header.isEmpty();
+        return header.isEmpty();
+    }
+
+    const int version = int(qFromBigEndian<quint32>(header.constData() + 4));
+    const quint64 generation = qFromBigEndian<quint64>(header.constData() + 8);
+    if (version > QDataStream::Qt_DefaultCompiledVersion)
+        return false;
+
+    if (generation != confFile->journalGeneration
+            || confFile->journalOffset < JournalHeaderSize
+            || device.size() < confFile->journalOffset) {
+        confFile->originalKeys.clear();
+        confFile->journalGeneration = generation;
+        confFile->journalOffset = JournalHeaderSize;
+        confFile->journalRecords = 0;
+    }
+
+    if (!device.seek(confFile->journalOffset))
+        return false;
+
+    const QByteArray tail = device.readAll();
+    const char *data = tail.constData();
+    int pos = 0;
+    bool ok = true;
+    while (tail.size() - pos >= 4) {
+        const quint32 length = qFromBigEndian<quint32>(data + pos);
+        if (length > quint32(tail.size() - pos - 4))
+            break;  // a record that is still being written (or never was)
+
+        const QByteArray record = QByteArray::fromRawData(data + pos + 4, int(length));
+        QDataStream stream(record);
+        stream.setVersion(version);
+        quint8 type;
+        QString key;
+        stream >> type >> key;
+        if (type == JournalSetRecord) {
+            QVariant value;
+            stream >> value;
+            if (stream.status() == QDataStream::Ok)
+                confFile->originalKeys.insert(QSettingsKey(key, caseSensitivity), value);
+        } else if (type == JournalRemoveRecord) {
+            if (stream.status() == QDataStream::Ok)
+                confFile->originalKeys.remove(QSettingsKey(key, caseSensitivity));
+        } else {
+            stream.setStatus(QDataStream::ReadCorruptData);
+        }
+        if (stream.status() != QDataStream::Ok) {
+            ok = false;
+            break;
+        }
+
+        pos += 4 + int(length);
+        ++confFile->journalRecords;
+    }
+
+    confFile->journalOffset += pos;
+    *truncated = (pos != tail.size());
+    return ok;
+}
+
+/*
+    Replaces the journal with one Set record per key of \a map, under a new
+    generation so that other readers know to reload it from the start.
+*/
+bool QConfFileSettingsPrivate::writeJournalSnapshot(QConfFile *confFile, const ParsedSettingsMap &map)
+{
+    quint64 generation;
+    do {
+        generation = QRandomGenerator::global()->generate64();
+    } while (generation == 0 || generation == confFile->journalGeneration);
+
+    QByteArray data(JournalHeaderSize, Qt::Uninitialized);
+    memcpy(data.data(), journalMagic, sizeof(journalMagic));
+    qToBigEndian<quint32>(quint32(JournalStreamVersion), data.data() + 4);
+    qToBigEndian<quint64>(generation, data.data() + 8);
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it)
+        appendJournalRecord(&data, JournalSetRecord, it.key(), &it.value());
+
+#if QT_CONFIG(temporaryfile)
+    QSaveFile sf(confFile->name);
+    sf.setDirectWriteFallback(!atomicSyncOnly);
+#else
+    QFile sf(confFile->name);
+#endif
+    if (!sf.open(QIODevice::WriteOnly) || sf.write(data) != data.size())
+        return false;
+#if QT_CONFIG(temporaryfile)
+    if (!sf.commit())
+        return false;
+#endif
+
+    confFile->unparsedIniSections.clear();
+    confFile->originalKeys = map;
+    confFile->journalGeneration = generation;
+    confFile->journalOffset = data.size();
+    confFile->journalRecords = map.size();
+    return true;
+}
+
+void QConfFileSettingsPrivate::syncJournalFile(QConfFile *confFile)
+{
+    bool readOnly = confFile->addedKeys.isEmpty() && confFile->removedKeys.isEmpty();
+
+    /*
+        Every write changes the size of the file, so if neither the size nor
+        the time stamp changed, the cached keys are still current.
+    */
+    QFileInfo fileInfo(confFile->name);
+    if (readOnly && confFile->size == fileInfo.size()
+            && confFile->timeStamp == fileInfo.lastModified()) {
+        return;
+    }
+
+    if (!readOnly && !confFile->isWritable()) {
+        setStatus(QSettings::AccessError);
+        return;
+    }
+
+    /*
+        Readers don't need the lock: records are appended in one go and a
+        compaction atomically replaces the file, so the worst a reader can
+        see is an incomplete last record, which it will pick up next time.
+    */
+    QLockFile lockFile(confFile->name + QLatin1String(".lock"));
+    if (!readOnly && !lockFile.lock() && atomicSyncOnly) {
+        setStatus(QSettings::AccessError);
+        return;
+    }
+
+    fileInfo.refresh();
+    const bool createFile = !fileInfo.exists();
+    bool truncated = false;
+    if (createFile) {
+        confFile->originalKeys.clear();
+        confFile->journalOffset = 0;
+        confFile->journalGeneration = 0;
+        confFile->journalRecords = 0;
+    } else {
+        QFile file(confFile->name);
+        if (!file.open(QFile::ReadOnly)) {
+            setStatus(QSettings::AccessError);
+            return;
+        }
+        if (!readJournal(file, confFile, &truncated))
+            setStatus(QSettings::FormatError);
+    }
+    confFile->size = fileInfo.size();
+    confFile->timeStamp = fileInfo.lastModified();
+
+    if (readOnly)
+        return;
+
+    /*
+        Only the keys that actually change since the last sync get a record;
+        repeated set() calls on the same key have already been coalesced in
+        addedKeys.
+    */
+    QByteArray records;
+    int recordCount = 0;
+    for (auto it = confFile->removedKeys.constBegin(); it != confFile->removedKeys.constEnd(); ++it) {
+        if (confFile->originalKeys.contains(it.key()) && !confFile->addedKeys.contains(it.key())) {
+            appendJournalRecord(&records, JournalRemoveRecord, it.key());
+            ++recordCount;
+        }
+    }
+    for (auto it = confFile->addedKeys.constBegin(); it != confFile->addedKeys.constEnd(); ++it) {
+        const auto original = confFile->originalKeys.constFind(it.key());
+        if (original == confFile->originalKeys.constEnd() || *original != it.value()) {
+            appendJournalRecord(&records, JournalSetRecord, it.key(), &it.value());
+            ++recordCount;
+        }
+    }
+
+    bool ok = true;
+    if (recordCount > 0) {
+        const int liveKeys = confFile->originalKeys.size() + confFile->addedKeys.size();
+        if (confFile->journalOffset < JournalHeaderSize
+                || confFile->journalRecords + recordCount > 2 * liveKeys + JournalCompactionSlack) {
+            ok = writeJournalSnapshot(confFile, confFile->mergedKeyMap());
+        } else {
+            QFile file(confFile->name);
+            ok = file.open(QIODevice::ReadWrite);
+            if (ok && truncated)
+                ok = file.resize(confFile->journalOffset);
+            ok = ok && file.seek(confFile->journalOffset)
+                    && file.write(records) == records.size() && file.flush();
+            if (ok) {
+                for (auto it = confFile->removedKeys.constBegin(); it != confFile->removedKeys.constEnd(); ++it)
+                    confFile->originalKeys.remove(it.key());
+                for (auto it = confFile->addedKeys.constBegin(); it != confFile->addedKeys.constEnd(); ++it)
+                    confFile->originalKeys.insert(it.key(), it.value());
+                confFile->journalOffset += records.size();
+                confFile->journalRecords += recordCount;
+            }
+        }
+    }
+
+    if (!ok) {
+        setStatus(QSettings::AccessError);
+        return;
+    }
+
+    confFile->addedKeys.clear();
+    confFile->removedKeys.clear();
+    if (recordCount == 0)
+        return;
+
+    fileInfo.refresh();
+    confFile->size = fileInfo.size();
+    confFile->timeStamp = fileInfo.lastModified();
+
+    if (createFile) {
+        QFile::Permissions perms = fileInfo.permissions() | QFile::ReadOwner | QFile::WriteOwner;
+        if (!confFile->userPerms)
+            perms |= QFile::ReadGroup | QFile::ReadOther;
+        QFile(confFile->name).setPermissions(perms);
+    }
+}
+#endif // !QT_BOOTSTRAPPED
+
 enum { Space = 0x1, Special = 0x2 };
 
 static const char charTraits[256] =
@@ -2454,6 +2747,13 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
     \value IniFormat        Store the settings in INI files. Note that type information
                             is not preserved when reading settings from INI files;
                             all values will be returned as QString.
+    \value JournalFormat    Store the settings in an append-only binary journal
+                            (\c .journal files) that preserves type information.
+                            A sync only appends the keys that changed and only
+                            reads what other processes appended since the last
+                            sync, which keeps it fast for large settings files
+                            that are synced often. The journal is compacted
+                            automatically. This enum value was added in Qt 5.14.
 
     \value InvalidFormat    Special value returned by registerFormat().
     \omitvalue CustomFormat1
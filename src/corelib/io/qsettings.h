@@ -90,6 +90,7 @@ public:
         Registry64Format,
 #endif
 
+        JournalFormat = 15,
         InvalidFormat = 16,
         CustomFormat1,
         CustomFormat2,
@@ -169,6 +169,9 @@ public:
     QAtomicInt ref;
     QMutex mutex;
     bool userPerms;
+    qint64 journalOffset;
+    quint64 journalGeneration;
+    int journalRecords;
 
 private:
 #ifdef Q_DISABLE_COPY
@@ -283,6 +286,11 @@ private:
     void initFormat();
     void initAccess();
     void syncConfFile(QConfFile *confFile);
+#ifndef QT_BOOTSTRAPPED
+    void syncJournalFile(QConfFile *confFile);
+    bool readJournal(QIODevice &device, QConfFile *confFile, bool *truncated);
+    bool writeJournalSnapshot(QConfFile *confFile, const ParsedSettingsMap &map);
+#endif
     bool writeIniFile(QIODevice &device, const ParsedSettingsMap &map);
 #ifdef Q_OS_MAC
     bool readPlistFile(const QByteArray &data, ParsedSettingsMap *map) const;
@@ -367,7 +367,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
-    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
+    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset
+            + uint(currentThreadData->postEventList.hasLockFreeEvents());
 }
 
 QAbstractEventDispatcher *QCoreApplicationPrivate::eventDispatcher = 0;
@@ -523,6 +524,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        threadData->mergeLockFreePostedEvents();
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -1547,6 +1549,29 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // Queued slot invocations with default priority are never compressed
+    // and don't need to be sorted, so they bypass the mutex: they are pushed
+    // onto a lock-free stack that the receiving thread merges into the list.
+    // This skips compressEvent(), see there.
+    if (priority == Qt::NormalEventPriority && event->type() == QEvent::MetaCall) {
+        Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+        event->posted = true;
+        ++receiver->d_func()->postedEvents;
+        data->postEventList.addEventLockFree(new QPostEventNode{ QPostEvent(receiver, event, priority), nullptr });
+
+        if (Q_UNLIKELY(data != *pdata)) {
+            // the receiver is moving to another thread, let the merge
+            // forward the event to it
+            QMutexLocker locker(&data->postEventList.mutex);
+            data->mergeLockFreePostedEvents();
+        }
+
+        QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+        if (dispatcher)
+            dispatcher->wakeUp();
+        return;
+    }
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1566,6 +1591,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the posting order with events that took the lock-free path
+    data->mergeLockFreePostedEvents();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1617,6 +1645,10 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 /*!
   \internal
   Returns \c true if \a event was compressed away (possibly deleted) and should not be added to the list.
+
+  Since Qt 5.14, QEvent::MetaCall events posted with Qt::NormalEventPriority
+  are not passed to this function, so reimplementations cannot compress
+  queued slot invocations.
 */
 bool QCoreApplication::compressEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents)
 {
@@ -1711,6 +1743,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->mergeLockFreePostedEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1870,6 +1903,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    data->mergeLockFreePostedEvents();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1902,7 +1936,8 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 
 #ifdef QT_DEBUG
     if (receiver && eventType == 0) {
-        Q_ASSERT(!receiver->d_func()->postedEvents);
+        // only queued slot invocations posted since the merge can be left
+        Q_ASSERT(receiver->d_func()->postedEvents >= 0);
     }
 #endif
 
@@ -1933,6 +1968,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->mergeLockFreePostedEvents();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -226,7 +226,6 @@ void QEventDispatcherCoreFoundation::startingUp()
 QEventDispatcherCoreFoundation::~QEventDispatcherCoreFoundation()
 {
     invalidateTimer();
-    qDeleteAll(m_timerInfoList);
 
     m_cfSocketNotifier.removeSocketNotifiers();
 }
@@ -55,6 +55,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <limits>
+
 #ifndef QT_NO_EVENTFD
 #  include <sys/eventfd.h>
 #endif
@@ -223,17 +225,151 @@ int QThreadPipe::check(const pollfd &pfd)
 }
 
 QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
+#if QT_CONFIG(epoll)
+    : epollFd(-1)
+#endif
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+
+#if QT_CONFIG(epoll)
+    if (isEpollRequested() && !initEpoll())
+        perror("QEventDispatcherUNIXPrivate: Unable to create epoll instance, falling back to poll");
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
-    // cleanup timers
-    qDeleteAll(timerList);
+#if QT_CONFIG(epoll)
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+}
+
+/*!
+    \internal
+
+    Returns \c true if the QT_EVENT_DISPATCHER_EPOLL environment variable
+    asks for socket notifiers to be monitored with epoll(7) instead of
+    rebuilding a pollfd array on every iteration of the event loop.
+*/
+bool QEventDispatcherUNIXPrivate::isEpollRequested()
+{
+#if QT_CONFIG(epoll)
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL", &ok);
+    return ok && value > 0;
+#else
+    return false;
+#endif
+}
+
+#if QT_CONFIG(epoll)
+// epoll(7) reuses the poll(2) bit values on Linux, so the two can be mixed freely
+Q_STATIC_ASSERT(EPOLLIN == POLLIN && EPOLLOUT == POLLOUT && EPOLLPRI == POLLPRI);
+Q_STATIC_ASSERT(EPOLLERR == POLLERR && EPOLLHUP == POLLHUP);
+
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+        return false;
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = threadPipe.fds[0];
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, ev.data.fd, &ev) == -1) {
+        qt_safe_close(epollFd);
+        epollFd = -1;
+        return false;
+    }
+
+    return true;
 }
 
+void QEventDispatcherUNIXPrivate::updateEpollInterest(int fd, short oldEvents, short newEvents)
+{
+    if (oldEvents == newEvents)
+        return;
+
+    if (!newEvents) {
+        if (nonPollableFds.removeOne(fd))
+            return;
+        // the kernel already dropped the fd from the set if it was closed
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    if (nonPollableFds.contains(fd))
+        return;
+
+    epoll_event ev = {};
+    ev.events = uint(newEvents);
+    ev.data.fd = fd;
+
+    int op = oldEvents ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    int ret = epoll_ctl(epollFd, op, fd, &ev);
+    if (ret == -1 && (errno == ENOENT || errno == EEXIST)) {
+        // the descriptor was closed and reused behind our back; resync
+        op = (errno == ENOENT) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+        ret = epoll_ctl(epollFd, op, fd, &ev);
+    }
+
+    if (ret == -1) {
+        if (errno == EPERM) {
+            // regular files and directories are always ready as far as
+            // poll(2) is concerned; emulate that
+            nonPollableFds.append(fd);
+        } else {
+            qWarning("QSocketNotifier: Unable to watch socket %d: %s",
+                     fd, qPrintable(qt_error_string(errno)));
+        }
+    }
+}
+
+int QEventDispatcherUNIXPrivate::processEpollEvents(timespec *tm)
+{
+    int timeout = -1;
+    if (!nonPollableFds.isEmpty())
+        timeout = 0;
+    else if (tm)
+        timeout = int(qMin<qint64>(tm->tv_sec * 1000 + (tm->tv_nsec + 999999) / 1000000,
+                                   std::numeric_limits<int>::max()));
+
+    // grow the event buffer with the interest set, but keep it bounded:
+    // epoll hands out the remaining events on the next wait
+    const int maxEvents = qBound(16, socketNotifiers.size() + 1, 1024);
+    if (epollEvents.size() < maxEvents)
+        epollEvents.resize(maxEvents);
+
+    int ready = epoll_wait(epollFd, epollEvents.data(), epollEvents.size(), timeout);
+    if (ready == -1) {
+        if (errno != EINTR)
+            perror("epoll_wait");
+        ready = 0;
+    }
+
+    int nevents = 0;
+    for (int i = 0; i < ready; ++i) {
+        const epoll_event &ev = epollEvents.at(i);
+        const short revents = short(ev.events & (EPOLLIN | EPOLLOUT | EPOLLPRI | EPOLLERR | EPOLLHUP));
+
+        if (ev.data.fd == threadPipe.fds[0]) {
+            pollfd pfd = qt_make_pollfd(ev.data.fd, POLLIN);
+            pfd.revents = revents;
+            nevents += threadPipe.check(pfd);
+        } else {
+            markPendingSocketNotifier(ev.data.fd, revents);
+        }
+    }
+
+    for (int fd : qAsConst(nonPollableFds))
+        markPendingSocketNotifier(fd, POLLIN | POLLOUT);
+
+    return nevents + activateSocketNotifiers();
+}
+#endif // QT_CONFIG(epoll)
+
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
@@ -255,38 +391,46 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
         if (pfd.fd < 0 || pfd.revents == 0)
             continue;
 
-        auto it = socketNotifiers.find(pfd.fd);
-        Q_ASSERT(it != socketNotifiers.end());
+        Q_ASSERT(socketNotifiers.contains(pfd.fd));
+        markPendingSocketNotifier(pfd.fd, pfd.revents);
+    }
 
-        const QSocketNotifierSetUNIX &sn_set = it.value();
+    pollfds.clear();
+}
 
-        static const struct {
-            QSocketNotifier::Type type;
-            short flags;
-        } notifiers[] = {
-            { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
-            { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
-            { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
-        };
+void QEventDispatcherUNIXPrivate::markPendingSocketNotifier(int fd, short revents)
+{
+    auto it = socketNotifiers.constFind(fd);
+    if (it == socketNotifiers.cend())
+        return;
 
-        for (const auto &n : notifiers) {
-            QSocketNotifier *notifier = sn_set.notifiers[n.type];
+    // copy, as disabling a notifier below modifies the hash
+    const QSocketNotifierSetUNIX sn_set = it.value();
 
-            if (!notifier)
-                continue;
+    static const struct {
+        QSocketNotifier::Type type;
+        short flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
+        { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
+        { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
+    };
 
-            if (pfd.revents & POLLNVAL) {
-                qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
-                         it.key(), socketType(n.type));
-                notifier->setEnabled(false);
-            }
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
+
+        if (!notifier)
+            continue;
 
-            if (pfd.revents & n.flags)
-                setSocketNotifierPending(notifier);
+        if (revents & POLLNVAL) {
+            qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                     fd, socketType(n.type));
+            notifier->setEnabled(false);
         }
-    }
 
-    pollfds.clear();
+        if (revents & n.flags)
+            setSocketNotifierPending(notifier);
+    }
 }
 
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
@@ -411,7 +555,14 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = notifier;
+    if (d->epollFd >= 0)
+        d->updateEpollInterest(sockfd, oldEvents, sn_set.events());
+#else
     sn_set.notifiers[type] = notifier;
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -450,7 +601,14 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = nullptr;
+    if (d->epollFd >= 0)
+        d->updateEpollInterest(sockfd, oldEvents, sn_set.events());
+#else
     sn_set.notifiers[type] = nullptr;
+#endif
 
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
@@ -485,6 +643,21 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
+    int nevents = 0;
+
+#if QT_CONFIG(epoll)
+    // the epoll set always contains every notifier, so it can only be
+    // used when socket notifiers are not excluded
+    if (d->epollFd >= 0 && include_notifiers) {
+        nevents += d->processEpollEvents(tm);
+
+        if (include_timers)
+            nevents += d->activateTimers();
+
+        return (nevents > 0);
+    }
+#endif
+
     d->pollfds.clear();
     d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
@@ -495,8 +668,6 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     // This must be last, as it's popped off the end below
     d->pollfds.append(d->threadPipe.prepare());
 
-    int nevents = 0;
-
     switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
     case -1:
         perror("qt_safe_poll");
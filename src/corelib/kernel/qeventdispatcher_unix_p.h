@@ -58,6 +58,10 @@
 #include "QtCore/qvarlengtharray.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -137,9 +141,22 @@ public:
     int activateTimers();
 
     void markPendingSocketNotifiers();
+    void markPendingSocketNotifier(int fd, short revents);
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+    static bool isEpollRequested();
+
+#if QT_CONFIG(epoll)
+    bool initEpoll();
+    void updateEpollInterest(int fd, short oldEvents, short newEvents);
+    int processEpollEvents(timespec *tm);
+
+    int epollFd;
+    QVector<epoll_event> epollEvents;
+    QVector<int> nonPollableFds; // fds epoll refuses, e.g. regular files
+#endif
+
     QThreadPipe threadPipe;
     QVector<pollfd> pollfds;
 
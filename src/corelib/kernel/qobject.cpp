@@ -1523,8 +1523,12 @@ void QObject::moveToThread(QThread *targetThread)
     currentData->ref();
 
     // move the object
+    currentData->mergeLockFreePostedEvents();
     d_func()->setThreadData_helper(currentData, targetData);
 
+    // events posted concurrently to the old thread are forwarded
+    currentData->mergeLockFreePostedEvents();
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
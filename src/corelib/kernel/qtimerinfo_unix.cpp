@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -53,15 +54,57 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
 
 /*
- * Internal functions for manipulating timer data structures.  The
- * timerBitVec array is used for keeping track of timer identifiers.
+ * Internal functions for manipulating timer data structures.
+ *
+ * The timers live in a hierarchical timer wheel: level 0 has one slot per
+ * millisecond, each following level has slots WheelSlots times as wide. A
+ * timer is put into the level whose range covers its distance to the wheel
+ * clock and is moved ("cascaded") into the lower levels once the wheel clock
+ * gets close enough. Each slot is an unsorted circular list, so adding and
+ * removing timers is O(1); timers are only sorted when they expire.
  */
 
+static inline quint64 toMsecTick(const timespec &t)
+{
+    return quint64(t.tv_sec) * 1000 + quint64(t.tv_nsec) / (1000 * 1000);
+}
+
+static void appendToBucket(QTimerInfo **bucket, QTimerInfo *t)
+{
+    t->bucket = bucket;
+    if (QTimerInfo *head = *bucket) {
+        t->next = head;
+        t->prev = head->prev;
+        head->prev->next = t;
+        head->prev = t;
+    } else {
+        t->next = t->prev = t;
+        *bucket = t;
+    }
+}
+
+static void removeFromBucket(QTimerInfo *t)
+{
+    QTimerInfo **bucket = t->bucket;
+    if (t->next == t) {
+        *bucket = 0;
+    } else {
+        t->prev->next = t->next;
+        t->next->prev = t->prev;
+        if (*bucket == t)
+            *bucket = t->next;
+    }
+    t->bucket = 0;
+    t->next = t->prev = 0;
+}
+
 QTimerInfoList::QTimerInfoList()
 {
 #if (_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC) && !defined(Q_OS_NACL)
@@ -83,7 +126,18 @@ QTimerInfoList::QTimerInfoList()
     }
 #endif
 
-    firstTimerInfo = 0;
+    memset(wheel, 0, sizeof(wheel));
+    memset(occupied, 0, sizeof(occupied));
+    wheelClock = toMsecTick(updateCurrentTime());
+    lastCascade = wheelClock;
+    expired = 0;
+    nextTimer = 0;
+    nextTimerValid = true;
+}
+
+QTimerInfoList::~QTimerInfoList()
+{
+    qDeleteAll(timersById);
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -150,11 +204,20 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 */
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
-    // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    // repair all timers and rebuild the wheel around the new clock
+    for (QTimerInfo *t : qAsConst(timersById)) {
+        if (t->bucket != &expired)
+            unlink(t);
         t->timeout = t->timeout + diff;
     }
+
+    wheelClock = toMsecTick(currentTime);
+    lastCascade = wheelClock;
+    for (QTimerInfo *t : qAsConst(timersById)) {
+        if (!t->bucket)
+            wheelInsert(t);
+    }
+    nextTimerValid = false;
 }
 
 void QTimerInfoList::repairTimersIfNeeded()
@@ -175,17 +238,241 @@ void QTimerInfoList::repairTimersIfNeeded()
 #endif
 
 /*
-  insert timer info into list
+  insert timer info into the wheel, according to its timeout
 */
-void QTimerInfoList::timerInsert(QTimerInfo *ti)
+void QTimerInfoList::wheelInsert(QTimerInfo *t)
+{
+    const quint64 expires = toMsecTick(t->timeout);
+    int level = 0;
+    int slot;
+
+    if (expires <= wheelClock) {
+        // already due, put it into the slot that expires next
+        slot = int(wheelClock & WheelMask);
+    } else {
+        const quint64 maxDelta = (Q_UINT64_C(1) << (WheelBits * WheelLevels)) - 1;
+        const quint64 delta = qMin(expires - wheelClock, maxDelta);
+        while (delta >> (WheelBits * (level + 1)))
+            ++level;
+        slot = int(((wheelClock + delta) >> (WheelBits * level)) & WheelMask);
+    }
+
+    appendToBucket(&wheel[level][slot], t);
+    occupied[level] |= Q_UINT64_C(1) << slot;
+
+    if (nextTimerValid && !t->activateRef && (!nextTimer || t->timeout < nextTimer->timeout))
+        nextTimer = t;
+}
+
+/*
+  remove timer info from the wheel slot or expired list it is in
+*/
+void QTimerInfoList::unlink(QTimerInfo *t)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
+    QTimerInfo **bucket = t->bucket;
+    removeFromBucket(t);
+
+    if (bucket != &expired && !*bucket) {
+        const int index = int(bucket - &wheel[0][0]);
+        occupied[index / WheelSlots] &= ~(Q_UINT64_C(1) << (index % WheelSlots));
+    }
+
+    if (t == nextTimer)
+        nextTimerValid = false;
+}
+
+/*
+  move the timers of the current slot of \a level into the lower levels
+*/
+void QTimerInfoList::cascade(int level)
+{
+    const int slot = int((wheelClock >> (WheelBits * level)) & WheelMask);
+    QTimerInfo *t = wheel[level][slot];
+    if (!t)
+        return;
+
+    QTimerInfo * const last = t->prev;
+    wheel[level][slot] = 0;
+    occupied[level] &= ~(Q_UINT64_C(1) << slot);
+
+    forever {
+        QTimerInfo * const next = t->next;
+        const bool done = (t == last);
+        t->bucket = 0;
+        wheelInsert(t);
+        if (done)
             break;
+        t = next;
+    }
+}
+
+/*
+  advance the wheel clock to the current time, moving all expired timers
+  into the expired list, sorted by timeout
+*/
+void QTimerInfoList::collectExpiredTimers(const timespec &now)
+{
+    const quint64 nowTick = toMsecTick(now);
+
+    forever {
+        const int idx = int(wheelClock & WheelMask);
+
+        if (idx == 0 && wheelClock != lastCascade) {
+            lastCascade = wheelClock;
+            for (int level = 1; level < WheelLevels; ++level) {
+                cascade(level);
+                if ((wheelClock >> (WheelBits * level)) & WheelMask)
+                    break;
+            }
+        }
+
+        if (QTimerInfo *t = wheel[0][idx]) {
+            // every timer in a slot before the current millisecond has
+            // expired; in the current one, compare with the exact time
+            const bool all = wheelClock < nowTick;
+            QTimerInfo * const last = t->prev;
+            forever {
+                QTimerInfo * const next = t->next;
+                const bool done = (t == last);
+                if (all || !(now < t->timeout)) {
+                    unlink(t);
+                    appendToBucket(&expired, t);
+                }
+                if (done)
+                    break;
+                t = next;
+            }
+        }
+
+        if (wheelClock >= nowTick)
+            break;
+
+        // skip ahead to the next occupied slot or the next cascade
+        quint64 nextTick = nowTick;
+        const quint64 boundary = (wheelClock | WheelMask) + 1;
+        const quint64 ahead = idx == WheelMask ? 0 : occupied[0] & (~Q_UINT64_C(0) << (idx + 1));
+        if (ahead)
+            nextTick = qMin(nextTick, wheelClock - idx + qCountTrailingZeroBits(ahead));
+        else if (occupied[0])
+            nextTick = qMin(nextTick, boundary);
+        for (int level = 1; level < WheelLevels; ++level) {
+            if (occupied[level]) {
+                nextTick = qMin(nextTick, boundary);
+                break;
+            }
+        }
+        wheelClock = nextTick;
+    }
+
+    if (expired && expired->next != expired) {
+        QVarLengthArray<QTimerInfo *, 64> sorted;
+        while (QTimerInfo *t = expired) {
+            removeFromBucket(t);
+            sorted.append(t);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const QTimerInfo *a, const QTimerInfo *b) {
+            return a->timeout < b->timeout;
+        });
+        for (QTimerInfo *t : sorted)
+            appendToBucket(&expired, t);
+    }
+
+    nextTimerValid = false;
+}
+
+/*
+  find the first timer to fire which is not being activated already
+*/
+QTimerInfo *QTimerInfoList::findNextTimer() const
+{
+    QTimerInfo *result = 0;
+    const auto findInBucket = [&result](QTimerInfo *head) {
+        bool found = false;
+        QTimerInfo *t = head;
+        do {
+            if (!t->activateRef) {
+                if (!result || t->timeout < result->timeout)
+                    result = t;
+                found = true;
+            }
+            t = t->next;
+        } while (t != head);
+        return found;
+    };
+
+    if (expired)
+        findInBucket(expired);
+
+    // the first occupied slot of each level, in order of time, holds the
+    // earliest timers of that level
+    for (int level = 0; level < WheelLevels; ++level) {
+        if (!occupied[level])
+            continue;
+
+        const int idx = int((wheelClock >> (WheelBits * level)) & WheelMask);
+        const int start = level ? (idx + 1) & WheelMask : idx;
+        quint64 bits = occupied[level];
+        if (start)
+            bits = (bits >> start) | (bits << (WheelSlots - start));
+
+        while (bits) {
+            const int slot = (start + int(qCountTrailingZeroBits(bits))) & WheelMask;
+            if (findInBucket(wheel[level][slot]))
+                break;
+            bits &= bits - 1;
+        }
+    }
+
+    return result;
+}
+
+/*
+  register timer info with the list and insert it into the wheel
+*/
+void QTimerInfoList::timerInsert(QTimerInfo *ti)
+{
+    if (isEmpty() && !expired) {
+        // nothing depends on the old clock, so skip the idle time
+        wheelClock = toMsecTick(currentTime);
     }
-    insert(index+1, ti);
+
+    timersById.insert(ti->id, ti);
+
+    QTimerInfo *&head = timersByObject[ti->obj];
+    if (head) {
+        ti->nextForObject = head;
+        ti->prevForObject = head->prevForObject;
+        head->prevForObject->nextForObject = ti;
+        head->prevForObject = ti;
+    } else {
+        ti->nextForObject = ti->prevForObject = ti;
+        head = ti;
+    }
+
+    wheelInsert(ti);
+}
+
+/*
+  remove timer info from all data structures and delete it
+*/
+void QTimerInfoList::removeTimer(QTimerInfo *t)
+{
+    unlink(t);
+    timersById.remove(t->id);
+
+    if (t->nextForObject == t) {
+        timersByObject.remove(t->obj);
+    } else {
+        t->prevForObject->nextForObject = t->nextForObject;
+        t->nextForObject->prevForObject = t->prevForObject;
+        QTimerInfo *&head = timersByObject[t->obj];
+        if (head == t)
+            head = t->nextForObject;
+    }
+
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -389,14 +676,12 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
+    if (!nextTimerValid) {
+        nextTimer = findNextTimer();
+        nextTimerValid = true;
     }
 
+    const QTimerInfo *t = nextTimer;
     if (!t)
       return false;
 
@@ -423,16 +708,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -451,6 +733,9 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = 0;
+    t->bucket = 0;
+    t->next = t->prev = 0;
+    t->nextForObject = t->prevForObject = 0;
 
     timespec expected = updateCurrentTime() + interval;
 
@@ -507,58 +792,41 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
-    // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
-    }
-    // id not found
-    return false;
+    QTimerInfo *t = timersById.value(timerId);
+    if (!t)
+        return false; // id not found
+
+    removeTimer(t);
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
-    }
+
+    QHash<QObject *, QTimerInfo *>::const_iterator it;
+    while ((it = timersByObject.constFind(object)) != timersByObject.cend())
+        removeTimer(it.value());
     return true;
 }
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
-    }
+    const QTimerInfo * const head = timersByObject.value(object);
+    if (!head)
+        return list;
+
+    const QTimerInfo *t = head;
+    do {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
+        t = t->nextForObject;
+    } while (t != head);
     return list;
 }
 
@@ -570,42 +838,21 @@ int QTimerInfoList::activateTimers()
     if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
-    int n_act = 0, maxCount = 0;
-    firstTimerInfo = 0;
+    int n_act = 0;
 
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
 
-
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    // Find out which timers have expired
+    collectExpiredTimers(currentTime);
 
     //fire the timers.
-    while (maxCount--) {
-        if (isEmpty())
-            break;
-
-        QTimerInfo *currentTimerInfo = constFirst();
-        if (currentTime < currentTimerInfo->timeout)
-            break; // no timer has expired
-
-        if (!firstTimerInfo) {
-            firstTimerInfo = currentTimerInfo;
-        } else if (firstTimerInfo == currentTimerInfo) {
-            // avoid sending the same timer multiple times
-            break;
-        } else if (currentTimerInfo->interval <  firstTimerInfo->interval
-                   || currentTimerInfo->interval == firstTimerInfo->interval) {
-            firstTimerInfo = currentTimerInfo;
-        }
+    while (expired) {
+        QTimerInfo *currentTimerInfo = expired;
 
         // remove from list
-        removeFirst();
+        unlink(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -631,23 +878,25 @@ int QTimerInfoList::activateTimers()
         calculateNextTimeout(currentTimerInfo, currentTime);
 
         // reinsert timer
-        timerInsert(currentTimerInfo);
+        wheelInsert(currentTimerInfo);
         if (currentTimerInfo->interval > 0)
             n_act++;
 
         if (!currentTimerInfo->activateRef) {
             // send event, but don't allow it to recurse
             currentTimerInfo->activateRef = &currentTimerInfo;
+            nextTimerValid = false;
 
             QTimerEvent e(currentTimerInfo->id);
             QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
 
-            if (currentTimerInfo)
+            if (currentTimerInfo) {
                 currentTimerInfo->activateRef = 0;
+                nextTimerValid = false;
+            }
         }
     }
 
-    firstTimerInfo = 0;
     // qDebug() << "Thread" << QThread::currentThreadId() << "activated" << n_act << "timers";
     return n_act;
 }
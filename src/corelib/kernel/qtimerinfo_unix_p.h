@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -70,6 +71,13 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    // intrusive links, maintained by QTimerInfoList
+    QTimerInfo **bucket; // - head of the wheel slot or expired list we are in
+    QTimerInfo *next;    // - circular list of the same bucket
+    QTimerInfo *prev;
+    QTimerInfo *nextForObject; // - circular list of the timers of obj
+    QTimerInfo *prevForObject;
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -77,8 +85,17 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+Q_DECLARE_TYPEINFO(QTimerInfo, Q_PRIMITIVE_TYPE);
+
+/*
+    Timers are kept in a hierarchical timer wheel with a resolution of one
+    millisecond, so registering, unregistering and re-arming a timer are O(1)
+    operations regardless of the number of timers in the thread.
+*/
+class Q_CORE_EXPORT QTimerInfoList
 {
+    Q_DISABLE_COPY(QTimerInfoList)
+
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
     clock_t previousTicks;
@@ -89,11 +106,37 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     void timerRepair(const timespec &);
 #endif
 
-    // state variables used by activateTimers()
-    QTimerInfo *firstTimerInfo;
+    enum {
+        WheelBits = 6,
+        WheelSlots = 1 << WheelBits,
+        WheelMask = WheelSlots - 1,
+        WheelLevels = 6 // 2^36 ms, more than the range of an int interval
+    };
+
+    QTimerInfo *wheel[WheelLevels][WheelSlots];
+    quint64 occupied[WheelLevels]; // bitmap of the non-empty slots
+    quint64 wheelClock;     // tick of the first slot not fully expired yet
+    quint64 lastCascade;
+
+    QTimerInfo *expired;    // collected by activateTimers(), not yet fired
+
+    QHash<int, QTimerInfo *> timersById;
+    QHash<QObject *, QTimerInfo *> timersByObject;
+
+    // cache for timerWait(), which is called on every event loop iteration
+    mutable QTimerInfo *nextTimer;
+    mutable bool nextTimerValid;
+
+    void wheelInsert(QTimerInfo *t);
+    void unlink(QTimerInfo *t);
+    void cascade(int level);
+    void collectExpiredTimers(const timespec &now);
+    QTimerInfo *findNextTimer() const;
+    void removeTimer(QTimerInfo *t);
 
 public:
     QTimerInfoList();
+    ~QTimerInfoList();
 
     timespec currentTime;
     timespec updateCurrentTime();
@@ -112,6 +155,9 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+    inline bool isEmpty() const { return timersById.isEmpty(); }
+    inline int size() const { return timersById.size(); }
 };
 
 QT_END_NAMESPACE
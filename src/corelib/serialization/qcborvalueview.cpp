@@ -0,0 +1,889 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qcborvalueview.h"
+
+#include <qendian.h>
+#include <qfile.h>
+#include <qfloat16.h>
+#include <qhash.h>
+#include <qmutex.h>
+#include <qscopedpointer.h>
+#include <qvector.h>
+
+#include <limits>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QCborValueView
+    \inmodule QtCore
+    \ingroup cbor
+    \reentrant
+    \since 5.14
+
+    \brief The QCborValueView class provides read-only, lazily decoded
+    access to CBOR data in memory or in a memory-mapped file.
+
+    QCborValue::fromCbor() decodes a whole document into QCborValue,
+    QCborArray and QCborMap objects before any of it can be used. For large
+    documents of which only a few values are needed, this costs time and
+    memory proportional to the size of the document. QCborValueView instead
+    refers directly to the encoded data and decodes only what is accessed:
+
+    \snippet code/src_corelib_serialization_qcborvalueview.cpp 0
+
+    Looking up an element of an array or a map requires knowing where each
+    of its elements starts, which in CBOR can only be found by skipping over
+    the preceding elements. Lookups record the offsets of the elements they
+    skip, so that later lookups in the same container take constant time
+    (for arrays) or only need to compare keys (for maps). Elements after the
+    one that was looked up are not examined. The memory used is therefore
+    proportional to the part of the document that has been accessed.
+
+    All views obtained from one document share its data and element offsets,
+    and can be used from multiple threads. The data is kept alive for as
+    long as any view refers to it, except when it was passed to
+    fromRawData(), in which case the caller must keep it alive.
+
+    Unlike QCborValue::fromCbor(), QCborValueView does not validate the
+    document when loading it. Malformed data is detected when it is
+    accessed, and the affected values report the type QCborValue::Invalid.
+    Looking up an element that does not exist returns a view of type
+    QCborValue::Undefined, so that lookups can be chained.
+
+    Use toCborValue() to fully decode a part of the document, for instance
+    to modify it.
+
+    \sa QCborValue, QCborStreamReader, QFile::map()
+*/
+
+class QCborValueViewData : public QSharedData
+{
+public:
+    struct Head
+    {
+        quint64 value;
+        qsizetype size;
+        quint8 major;
+        quint8 info;
+        bool indefinite;
+    };
+
+    // The offsets of the items of an array or map that have been located
+    // so far. Items are only located as far as lookups need them.
+    struct ChildIndex
+    {
+        QVector<qsizetype> offsets;
+        qsizetype next = 0;         // offset of the next item to locate
+        qint64 remaining = -1;      // items left to locate, or -1 if indefinite
+        bool complete = false;
+    };
+
+    enum {
+        Break = 0xff,
+        MaximumRecursionDepth = 1024
+    };
+
+    bool readHead(qsizetype offset, Head *head) const;
+    qsizetype skip(qsizetype offset, int depth = 0) const;
+    void children(qsizetype offset, qsizetype count, QVector<qsizetype> *offsets,
+                  bool *complete) const;
+    QByteArray stringData(qsizetype offset) const;
+    QCborValue::Type type(qsizetype offset) const;
+    static double toDouble(const Head &head);
+
+    const uchar *data = nullptr;
+    qsizetype size = 0;
+    QByteArray bytes;
+    QScopedPointer<QFile> file;
+
+    mutable QBasicMutex mutex;
+    mutable QHash<qsizetype, ChildIndex> index;
+};
+
+bool QCborValueViewData::readHead(qsizetype offset, Head *head) const
+{
+    if (offset < 0 || offset >= size)
+        return false;
+    const uchar initial = data[offset];
+    head->major = initial >> 5;
+    head->info = initial & 0x1f;
+    head->indefinite = false;
+    head->value = head->info;
+    head->size = 1;
+
+    const uchar *p = data + offset + 1;
+    const qsizetype available = size - offset - 1;
+    switch (head->info) {
+    case 24:
+        if (available < 1)
+            return false;
+        head->value = *p;
+        head->size = 2;
+        break;
+    case 25:
+        if (available < 2)
+            return false;
+        head->value = qFromBigEndian<quint16>(p);
+        head->size = 3;
+        break;
+    case 26:
+        if (available < 4)
+            return false;
+        head->value = qFromBigEndian<quint32>(p);
+        head->size = 5;
+        break;
+    case 27:
+        if (available < 8)
+            return false;
+        head->value = qFromBigEndian<quint64>(p);
+        head->size = 9;
+        break;
+    case 28:
+    case 29:
+    case 30:
+        return false;
+    case 31:
+        // indefinite length, or "break" for simple types
+        if (head->major == 0 || head->major == 1 || head->major == 6)
+            return false;
+        head->indefinite = true;
+        head->value = 0;
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+/*!
+    \internal
+    Returns the offset just past the item at \a offset, or -1 if it is
+    malformed or truncated.
+*/
+qsizetype QCborValueViewData::skip(qsizetype offset, int depth) const
+{
+    Head head;
+    if (depth > MaximumRecursionDepth || !readHead(offset, &head))
+        return -1;
+    qsizetype p = offset + head.size;
+
+    switch (head.major) {
+    case 0:         // integers
+    case 1:
+        return p;
+
+    case 2:         // byte and text strings
+    case 3:
+        if (!head.indefinite)
+            return head.value <= quint64(size - p) ? p + qsizetype(head.value) : -1;
+        for (;;) {
+            if (p >= size)
+                return -1;
+            if (data[p] == Break)
+                return p + 1;
+            Head chunk;
+            if (!readHead(p, &chunk) || chunk.major != head.major || chunk.indefinite)
+                return -1;
+            p += chunk.size;
+            if (chunk.value > quint64(size - p))
+                return -1;
+            p += qsizetype(chunk.value);
+        }
+
+    case 4:         // arrays and maps
+    case 5:
+        if (head.indefinite) {
+            qsizetype count = 0;
+            for ( ; ; ++count) {
+                if (p >= size)
+                    return -1;
+                if (data[p] == Break)
+                    return (head.major == 5 && count % 2) ? -1 : p + 1;
+                p = skip(p, depth + 1);
+                if (p < 0)
+                    return -1;
+            }
+        }
+        // every item takes at least one byte
+        if (head.value > quint64(size - p) / (head.major == 5 ? 2 : 1))
+            return -1;
+        for (quint64 i = 0, n = head.value * (head.major == 5 ? 2 : 1); i < n; ++i) {
+            p = skip(p, depth + 1);
+            if (p < 0)
+                return -1;
+        }
+        return p;
+
+    case 6:         // tags
+        return skip(p, depth + 1);
+
+    default:        // simple types and floating point
+        return head.indefinite ? -1 : p;
+    }
+}
+
+/*!
+    \internal
+    Locates at least the first \a count items of the array or map at
+    \a offset, or all of them if there are fewer, and returns the offsets
+    of all items located so far in \a offsets. Sets *\a complete if there
+    are no further items, or if the container is malformed beyond the
+    returned items.
+*/
+void QCborValueViewData::children(qsizetype offset, qsizetype count,
+                                  QVector<qsizetype> *offsets, bool *complete) const
+{
+    QMutexLocker locker(&mutex);
+    auto it = index.find(offset);
+    if (it == index.end()) {
+        ChildIndex entry;
+        Head head;
+        if (!readHead(offset, &head) || (head.major != 4 && head.major != 5)) {
+            entry.complete = true;
+        } else {
+            entry.next = offset + head.size;
+            if (!head.indefinite) {
+                entry.remaining = qint64(head.value) * (head.major == 5 ? 2 : 1);
+                // every item takes at least one byte
+                if (head.value > quint64(size - entry.next))
+                    entry.remaining = 0;
+            }
+        }
+        it = index.insert(offset, entry);
+    }
+
+    ChildIndex &entry = it.value();
+    while (!entry.complete && entry.offsets.size() < count) {
+        if (entry.remaining == 0
+                || (entry.remaining < 0 && entry.next < size && data[entry.next] == Break)) {
+            entry.complete = true;
+            break;
+        }
+        const qsizetype next = skip(entry.next, 1);
+        if (next < 0) {
+            // the item is malformed: it can be looked at, but nothing after it
+            entry.offsets.append(entry.next);
+            entry.complete = true;
+            break;
+        }
+        entry.offsets.append(entry.next);
+        entry.next = next;
+        if (entry.remaining > 0)
+            --entry.remaining;
+    }
+    if (entry.complete)
+        entry.offsets.squeeze();
+    *offsets = entry.offsets;
+    *complete = entry.complete;
+}
+
+/*!
+    \internal
+    Returns the contents of the byte or text string at \a offset,
+    concatenating the chunks of an indefinite-length string.
+*/
+QByteArray QCborValueViewData::stringData(qsizetype offset) const
+{
+    Head head;
+    if (!readHead(offset, &head))
+        return QByteArray();
+    qsizetype p = offset + head.size;
+    if (!head.indefinite) {
+        if (head.value > quint64(size - p))
+            return QByteArray();
+        return QByteArray(reinterpret_cast<const char *>(data + p), int(head.value));
+    }
+
+    QByteArray result;
+    while (p < size && data[p] != Break) {
+        Head chunk;
+        if (!readHead(p, &chunk) || chunk.major != head.major || chunk.indefinite)
+            return QByteArray();
+        p += chunk.size;
+        if (chunk.value > quint64(size - p))
+            return QByteArray();
+        result.append(reinterpret_cast<const char *>(data + p), int(chunk.value));
+        p += qsizetype(chunk.value);
+    }
+    return result;
+}
+
+QCborValue::Type QCborValueViewData::type(qsizetype offset) const
+{
+    Head head;
+    if (!readHead(offset, &head))
+        return QCborValue::Invalid;
+
+    switch (head.major) {
+    case 0:
+    case 1:
+        // like QCborValue, integers that do not fit qint64 become doubles
+        return head.value > quint64(std::numeric_limits<qint64>::max())
+                ? QCborValue::Double : QCborValue::Integer;
+    case 2:
+        return QCborValue::ByteArray;
+    case 3:
+        return QCborValue::String;
+    case 4:
+        return QCborValue::Array;
+    case 5:
+        return QCborValue::Map;
+    case 6: {
+        // Only the item right under the tag decides the extended type, and a
+        // tag on a tag never makes one, so don't follow chains of tags.
+        Head inner;
+        if (!readHead(offset + head.size, &inner) || inner.major == 6)
+            return QCborValue::Tag;
+        const QCborValue::Type tagged = type(offset + head.size);
+        switch (head.value) {
+        case quint64(QCborKnownTags::DateTimeString):
+            if (tagged == QCborValue::String)
+                return QCborValue::DateTime;
+            break;
+        case quint64(QCborKnownTags::UnixTime_t):
+            if (tagged == QCborValue::Integer || tagged == QCborValue::Double)
+                return QCborValue::DateTime;
+            break;
+        case quint64(QCborKnownTags::Url):
+            if (tagged == QCborValue::String)
+                return QCborValue::Url;
+            break;
+        case quint64(QCborKnownTags::RegularExpression):
+            if (tagged == QCborValue::String)
+                return QCborValue::RegularExpression;
+            break;
+        case quint64(QCborKnownTags::Uuid):
+            if (tagged == QCborValue::ByteArray)
+                return QCborValue::Uuid;
+            break;
+        }
+        return QCborValue::Tag;
+    }
+    default:
+        break;
+    }
+
+    // major type 7
+    if (head.indefinite)
+        return QCborValue::Invalid;
+    if (head.info >= 25)
+        return QCborValue::Double;
+    return QCborValue::Type(QCborValue::SimpleType + int(head.value));
+}
+
+double QCborValueViewData::toDouble(const Head &head)
+{
+    switch (head.major) {
+    case 0:
+        return double(head.value);
+    case 1:
+        return -1.0 - double(head.value);
+    case 7:
+        switch (head.info) {
+        case 25: {
+            qfloat16 f;
+            const quint16 bits = quint16(head.value);
+            memcpy(static_cast<void *>(&f), &bits, sizeof f);
+            return double(float(f));
+        }
+        case 26: {
+            float f;
+            const quint32 bits = quint32(head.value);
+            memcpy(&f, &bits, sizeof f);
+            return double(f);
+        }
+        case 27: {
+            double f;
+            memcpy(&f, &head.value, sizeof f);
+            return f;
+        }
+        }
+        break;
+    }
+    return 0;
+}
+
+/*!
+    Constructs a view of type QCborValue::Undefined that refers to no data.
+*/
+QCborValueView::QCborValueView() noexcept
+{
+}
+
+QCborValueView::QCborValueView(QCborValueViewData *dd, qsizetype offset) noexcept
+    : d(dd), pos(offset)
+{
+}
+
+/*!
+    Constructs a view referring to the same value as \a other.
+*/
+QCborValueView::QCborValueView(const QCborValueView &other) noexcept = default;
+
+/*!
+    Makes this view refer to the same value as \a other.
+*/
+QCborValueView &QCborValueView::operator=(const QCborValueView &other) noexcept = default;
+
+/*!
+    Destroys the view. The document's data is released when the last view
+    referring to it is destroyed.
+*/
+QCborValueView::~QCborValueView()
+{
+}
+
+/*!
+    \fn void QCborValueView::swap(QCborValueView &other)
+
+    Swaps this view with \a other. This operation is very fast and never
+    fails.
+*/
+
+/*!
+    Returns a view of the first CBOR item in the \a len bytes starting at
+    \a data. The data is not copied, and must stay valid and unmodified for
+    as long as any view of it exists.
+
+    \sa fromByteArray(), fromFile()
+*/
+QCborValueView QCborValueView::fromRawData(const char *data, qsizetype len)
+{
+    QCborValueViewData *dd = new QCborValueViewData;
+    dd->data = reinterpret_cast<const uchar *>(data);
+    dd->size = len;
+    return QCborValueView(dd, 0);
+}
+
+/*!
+    \fn QCborValueView QCborValueView::fromRawData(const quint8 *data, qsizetype len)
+    \overload
+*/
+
+/*!
+    Returns a view of the first CBOR item in \a data. The byte array is
+    implicitly shared with the view, not copied.
+*/
+QCborValueView QCborValueView::fromByteArray(const QByteArray &data)
+{
+    QCborValueViewData *dd = new QCborValueViewData;
+    dd->bytes = data;
+    dd->data = reinterpret_cast<const uchar *>(dd->bytes.constData());
+    dd->size = dd->bytes.size();
+    return QCborValueView(dd, 0);
+}
+
+/*!
+    Maps the file \a fileName into memory and returns a view of the first
+    CBOR item in it. Only the pages that are accessed are read from disk.
+    If the file cannot be mapped, it is read into memory instead. If it
+    cannot be opened, the returned view is of type QCborValue::Invalid.
+
+    The file must not be modified while any view of it exists.
+
+    \sa QFile::map()
+*/
+QCborValueView QCborValueView::fromFile(const QString &fileName)
+{
+    QScopedPointer<QFile> file(new QFile(fileName));
+    if (!file->open(QIODevice::ReadOnly))
+        return QCborValueView(new QCborValueViewData, 0);
+
+    QCborValueViewData *dd = new QCborValueViewData;
+    const qint64 size = file->size();
+    const uchar *mapped = size > 0 ? file->map(0, size) : nullptr;
+    if (mapped) {
+        dd->data = mapped;
+        dd->size = qsizetype(size);
+        dd->file.reset(file.take());
+    } else {
+        dd->bytes = file->readAll();
+        dd->data = reinterpret_cast<const uchar *>(dd->bytes.constData());
+        dd->size = dd->bytes.size();
+    }
+    return QCborValueView(dd, 0);
+}
+
+/*!
+    Returns the type of the value. Like QCborValue, tags that have a
+    corresponding extended type report that type if the tagged value has
+    the expected type.
+
+    \sa QCborValue::type()
+*/
+QCborValue::Type QCborValueView::type() const
+{
+    if (!d || pos < 0)
+        return QCborValue::Undefined;
+    return d->type(pos);
+}
+
+/*!
+    Returns \c true if this is a tagged value, including the extended
+    types such as QCborValue::DateTime.
+*/
+bool QCborValueView::isTag() const
+{
+    QCborValueViewData::Head head;
+    return d && d->readHead(pos, &head) && head.major == 6;
+}
+
+/*!
+    \fn bool QCborValueView::isInteger() const
+    \fn bool QCborValueView::isByteArray() const
+    \fn bool QCborValueView::isString() const
+    \fn bool QCborValueView::isArray() const
+    \fn bool QCborValueView::isMap() const
+    \fn bool QCborValueView::isFalse() const
+    \fn bool QCborValueView::isTrue() const
+    \fn bool QCborValueView::isBool() const
+    \fn bool QCborValueView::isNull() const
+    \fn bool QCborValueView::isUndefined() const
+    \fn bool QCborValueView::isDouble() const
+    \fn bool QCborValueView::isInvalid() const
+    \fn bool QCborValueView::isContainer() const
+    \fn bool QCborValueView::isSimpleType() const
+
+    These functions return whether type() has the corresponding value; see
+    the functions of the same name in QCborValue.
+*/
+
+/*!
+    \fn QCborSimpleType QCborValueView::toSimpleType(QCborSimpleType defaultValue) const
+
+    Returns the simple type this value is of, or \a defaultValue if it is
+    not a simple type.
+*/
+
+/*!
+    \fn bool QCborValueView::toBool(bool defaultValue) const
+
+    Returns the boolean value, or \a defaultValue if this is not a boolean.
+*/
+
+/*!
+    Returns the integer value, the truncated value of a double, or
+    \a defaultValue for any other type.
+
+    \sa toDouble()
+*/
+qint64 QCborValueView::toInteger(qint64 defaultValue) const
+{
+    QCborValueViewData::Head head;
+    if (!d || !d->readHead(pos, &head))
+        return defaultValue;
+    switch (d->type(pos)) {
+    case QCborValue::Integer:
+        return head.major == 0 ? qint64(head.value) : -1 - qint64(head.value);
+    case QCborValue::Double:
+        return qint64(d->toDouble(head));
+    default:
+        return defaultValue;
+    }
+}
+
+/*!
+    Returns the floating point value, the value of an integer converted to
+    double, or \a defaultValue for any other type.
+
+    \sa toInteger()
+*/
+double QCborValueView::toDouble(double defaultValue) const
+{
+    QCborValueViewData::Head head;
+    if (!d || !d->readHead(pos, &head))
+        return defaultValue;
+    switch (d->type(pos)) {
+    case QCborValue::Integer:
+    case QCborValue::Double:
+        return d->toDouble(head);
+    default:
+        return defaultValue;
+    }
+}
+
+/*!
+    Returns a copy of the contents of a byte array value, or \a defaultValue
+    if this is not a byte array.
+*/
+QByteArray QCborValueView::toByteArray(const QByteArray &defaultValue) const
+{
+    if (!isByteArray())
+        return defaultValue;
+    return d->stringData(pos);
+}
+
+/*!
+    Returns the decoded contents of a string value, or \a defaultValue if
+    this is not a string.
+*/
+QString QCborValueView::toString(const QString &defaultValue) const
+{
+    if (!isString())
+        return defaultValue;
+    return QString::fromUtf8(d->stringData(pos));
+}
+
+/*!
+    Returns the tag of a tagged value, or \a defaultValue if this is not a
+    tagged value.
+
+    \sa taggedValue()
+*/
+QCborTag QCborValueView::tag(QCborTag defaultValue) const
+{
+    QCborValueViewData::Head head;
+    if (!d || !d->readHead(pos, &head) || head.major != 6)
+        return defaultValue;
+    return QCborTag(head.value);
+}
+
+/*!
+    Returns a view of the value that the tag applies to, or an undefined
+    view if this is not a tagged value.
+
+    \sa tag()
+*/
+QCborValueView QCborValueView::taggedValue() const
+{
+    QCborValueViewData::Head head;
+    if (!d || !d->readHead(pos, &head) || head.major != 6)
+        return QCborValueView();
+    return QCborValueView(d.data(), pos + head.size);
+}
+
+/*!
+    Returns the number of elements in an array, the number of key-value
+    pairs in a map, or 0 for any other type.
+*/
+qsizetype QCborValueView::size() const
+{
+    QCborValueViewData::Head head;
+    if (!d || !d->readHead(pos, &head) || (head.major != 4 && head.major != 5))
+        return 0;
+    if (!head.indefinite)
+        return qsizetype(head.value);
+    QVector<qsizetype> offsets;
+    bool complete;
+    d->children(pos, std::numeric_limits<qsizetype>::max(), &offsets, &complete);
+    return offsets.size() / (head.major == 5 ? 2 : 1);
+}
+
+/*!
+    Returns a view of the element at index \a i of an array. If this is not
+    an array or \a i is out of range, returns an undefined view.
+
+    \sa value()
+*/
+QCborValueView QCborValueView::at(qsizetype i) const
+{
+    if (!isArray() || i < 0)
+        return QCborValueView();
+    QVector<qsizetype> offsets;
+    bool complete;
+    d->children(pos, i + 1, &offsets, &complete);
+    if (i >= offsets.size())
+        return QCborValueView();
+    return QCborValueView(d.data(), offsets.at(int(i)));
+}
+
+/*!
+    Returns a view of the key of the \a{i}-th pair of a map, in encoding
+    order. If this is not a map or \a i is out of range, returns an
+    undefined view.
+
+    \sa valueAt()
+*/
+QCborValueView QCborValueView::keyAt(qsizetype i) const
+{
+    if (!isMap() || i < 0)
+        return QCborValueView();
+    QVector<qsizetype> offsets;
+    bool complete;
+    d->children(pos, 2 * i + 2, &offsets, &complete);
+    if (2 * i + 1 >= offsets.size())
+        return QCborValueView();
+    return QCborValueView(d.data(), offsets.at(int(2 * i)));
+}
+
+/*!
+    Returns a view of the value of the \a{i}-th pair of a map, in encoding
+    order. If this is not a map or \a i is out of range, returns an
+    undefined view.
+
+    \sa keyAt()
+*/
+QCborValueView QCborValueView::valueAt(qsizetype i) const
+{
+    if (!isMap() || i < 0)
+        return QCborValueView();
+    QVector<qsizetype> offsets;
+    bool complete;
+    d->children(pos, 2 * i + 2, &offsets, &complete);
+    if (2 * i + 1 >= offsets.size())
+        return QCborValueView();
+    return QCborValueView(d.data(), offsets.at(int(2 * i + 1)));
+}
+
+/*!
+    If this is a map, returns a view of the value for the integer key
+    \a key. If this is an array, returns a view of the element at index
+    \a key. Otherwise, or if there is no such element, returns an undefined
+    view.
+*/
+QCborValueView QCborValueView::value(qint64 key) const
+{
+    if (isArray())
+        return at(qsizetype(key));
+    return lookup(QByteArray(), key, false);
+}
+
+/*!
+    \overload
+
+    Returns a view of the value for the string key \a key in a map, or an
+    undefined view if this is not a map or has no such key.
+*/
+QCborValueView QCborValueView::value(QLatin1String key) const
+{
+    // Latin-1 equals UTF-8 for ASCII, which is by far the common case
+    for (char c : key) {
+        if (uchar(c) >= 0x80)
+            return lookup(QString(key).toUtf8(), 0, true);
+    }
+    return lookup(QByteArray::fromRawData(key.data(), key.size()), 0, true);
+}
+
+/*!
+    \overload
+*/
+QCborValueView QCborValueView::value(const QString &key) const
+{
+    return lookup(key.toUtf8(), 0, true);
+}
+
+/*!
+    \fn QCborValueView QCborValueView::operator[](qint64 key) const
+    \fn QCborValueView QCborValueView::operator[](QLatin1String key) const
+    \fn QCborValueView QCborValueView::operator[](const QString &key) const
+
+    Same as value(\a key).
+*/
+
+QCborValueView QCborValueView::lookup(const QByteArray &utf8Key, qint64 intKey,
+                                      bool isStringKey) const
+{
+    if (!isMap())
+        return QCborValueView();
+
+    // Keys are compared in their encoded form, without decoding them, and
+    // the map is only indexed as far as needed to find the key.
+    QVector<qsizetype> offsets;
+    bool complete = false;
+    for (int i = 0; ; i += 2) {
+        if (i + 1 >= offsets.size()) {
+            if (complete)
+                break;
+            d->children(pos, qMax(qsizetype(i) + 2, qsizetype(offsets.size()) * 2),
+                        &offsets, &complete);
+            if (i + 1 >= offsets.size())
+                break;
+        }
+        QCborValueViewData::Head head;
+        const qsizetype keyOffset = offsets.at(i);
+        if (!d->readHead(keyOffset, &head))
+            continue;
+        bool match = false;
+        if (isStringKey) {
+            if (head.major != 3)
+                continue;
+            if (head.indefinite) {
+                match = d->stringData(keyOffset) == utf8Key;
+            } else {
+                match = head.value == quint64(utf8Key.size())
+                        && memcmp(d->data + keyOffset + head.size, utf8Key.constData(),
+                                  size_t(utf8Key.size())) == 0;
+            }
+        } else if (head.major == 0) {
+            match = intKey >= 0 && head.value == quint64(intKey);
+        } else if (head.major == 1) {
+            match = intKey < 0 && head.value == quint64(-1 - intKey);
+        }
+        if (match)
+            return QCborValueView(d.data(), offsets.at(i + 1));
+    }
+    return QCborValueView();
+}
+
+/*!
+    Decodes this value, including all of its elements if it is a container,
+    into a QCborValue.
+
+    \sa QCborValue::fromCbor()
+*/
+QCborValue QCborValueView::toCborValue() const
+{
+    if (!d || pos < 0)
+        return QCborValue();
+    const qsizetype end = d->skip(pos);
+    if (end < 0)
+        return QCborValue(QCborValue::Invalid);
+    return QCborValue::fromCbor(QByteArray::fromRawData(
+                reinterpret_cast<const char *>(d->data + pos), int(end - pos)));
+}
+
+/*!
+    Returns a copy of the encoded form of this value, or an empty byte array
+    if the value is undefined or malformed.
+*/
+QByteArray QCborValueView::toCbor() const
+{
+    if (!d || pos < 0)
+        return QByteArray();
+    const qsizetype end = d->skip(pos);
+    if (end < 0)
+        return QByteArray();
+    return QByteArray(reinterpret_cast<const char *>(d->data + pos), int(end - pos));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QCBORVALUEVIEW_H
+#define QCBORVALUEVIEW_H
+
+#include <QtCore/qcborvalue.h>
+#include <QtCore/qshareddata.h>
+
+QT_BEGIN_NAMESPACE
+
+class QCborValueViewData;
+
+class Q_CORE_EXPORT QCborValueView
+{
+public:
+    QCborValueView() noexcept;
+    QCborValueView(const QCborValueView &other) noexcept;
+    QCborValueView &operator=(const QCborValueView &other) noexcept;
+    ~QCborValueView();
+
+    void swap(QCborValueView &other) noexcept
+    {
+        qSwap(d, other.d);
+        qSwap(pos, other.pos);
+    }
+
+    static QCborValueView fromRawData(const char *data, qsizetype len);
+    static QCborValueView fromRawData(const quint8 *data, qsizetype len)
+    { return fromRawData(reinterpret_cast<const char *>(data), len); }
+    static QCborValueView fromByteArray(const QByteArray &data);
+    static QCborValueView fromFile(const QString &fileName);
+
+    QCborValue::Type type() const;
+    bool isInteger() const      { return type() == QCborValue::Integer; }
+    bool isByteArray() const    { return type() == QCborValue::ByteArray; }
+    bool isString() const       { return type() == QCborValue::String; }
+    bool isArray() const        { return type() == QCborValue::Array; }
+    bool isMap() const          { return type() == QCborValue::Map; }
+    bool isTag() const;
+    bool isFalse() const        { return type() == QCborValue::False; }
+    bool isTrue() const         { return type() == QCborValue::True; }
+    bool isBool() const         { return isFalse() || isTrue(); }
+    bool isNull() const         { return type() == QCborValue::Null; }
+    bool isUndefined() const    { return type() == QCborValue::Undefined; }
+    bool isDouble() const       { return type() == QCborValue::Double; }
+    bool isInvalid() const      { return type() == QCborValue::Invalid; }
+    bool isContainer() const    { return isMap() || isArray(); }
+    bool isSimpleType() const
+    { return int(type()) >> 8 == int(QCborValue::SimpleType) >> 8; }
+    QCborSimpleType toSimpleType(QCborSimpleType defaultValue = QCborSimpleType::Undefined) const
+    { return isSimpleType() ? QCborSimpleType(type() & 0xff) : defaultValue; }
+
+    qint64 toInteger(qint64 defaultValue = 0) const;
+    bool toBool(bool defaultValue = false) const
+    { return isBool() ? isTrue() : defaultValue; }
+    double toDouble(double defaultValue = 0) const;
+    QByteArray toByteArray(const QByteArray &defaultValue = {}) const;
+    QString toString(const QString &defaultValue = {}) const;
+
+    QCborTag tag(QCborTag defaultValue = QCborTag(-1)) const;
+    QCborValueView taggedValue() const;
+
+    qsizetype size() const;
+    QCborValueView at(qsizetype i) const;
+    QCborValueView keyAt(qsizetype i) const;
+    QCborValueView valueAt(qsizetype i) const;
+    QCborValueView value(qint64 key) const;
+    QCborValueView value(QLatin1String key) const;
+    QCborValueView value(const QString &key) const;
+    QCborValueView operator[](qint64 key) const { return value(key); }
+    QCborValueView operator[](QLatin1String key) const { return value(key); }
+    QCborValueView operator[](const QString &key) const { return value(key); }
+
+    QCborValue toCborValue() const;
+    QByteArray toCbor() const;
+
+private:
+    friend class QCborValueViewData;
+    QCborValueView(QCborValueViewData *dd, qsizetype offset) noexcept;
+    QCborValueView lookup(const QByteArray &utf8Key, qint64 intKey, bool isStringKey) const;
+
+    QExplicitlySharedDataPointer<QCborValueViewData> d;
+    qsizetype pos = -1;
+};
+
+Q_DECLARE_SHARED(QCborValueView)
+
+QT_END_NAMESPACE
+
+#endif // QCBORVALUEVIEW_H
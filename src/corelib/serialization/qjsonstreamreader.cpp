@@ -0,0 +1,1126 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamreader.h"
+
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+#include <private/qlocale_tools_p.h>
+#include <private/qnumeric_p.h>
+#include <private/qsimd_p.h>
+#include <private/qutfcodec_p.h>
+
+#include <cmath>
+#include <limits>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \since 5.14
+    \ingroup json
+    \reentrant
+
+    \brief The QJsonStreamReader class provides a fast, pull-based parser for
+    JSON text.
+
+    QJsonStreamReader is the JSON counterpart of QXmlStreamReader. Instead of
+    building a QJsonDocument for the whole input, the application calls
+    readNext() repeatedly and receives one token at a time: the start and
+    end of objects and arrays, member names, and scalar values. The reader
+    keeps no more state than the current nesting, so arbitrarily large
+    inputs can be processed in constant memory.
+
+    \snippet code/src_corelib_serialization_qjsonstreamreader.cpp 0
+
+    The reader accepts several top-level values one after another, which
+    makes it suitable for newline-delimited JSON ("JSON Lines") streams.
+    When the input is exhausted outside of any value, readNext() returns
+    EndDocument.
+
+    String contents are validated as UTF-8 while scanning, but are only
+    decoded when text() or utf8Text() is called. If a string contains no
+    escape sequences, utf8Text() returns a view into the reader's internal
+    buffer without copying. Both text() and utf8Text() return data that
+    remains valid only until the next call to readNext(), addData() or
+    clear().
+
+    \section1 Incremental parsing
+
+    Data can be supplied either as a QIODevice or in chunks via addData().
+    If a token is split between two chunks, readNext() returns Incomplete
+    and the token is read again once more data has been added. The same
+    happens for a sequential device that has no more data available at the
+    moment; the application should wait for the device's readyRead()
+    signal and call readNext() again.
+
+    A top-level number at the end of the data added so far is only reported
+    once the data that follows it has been added, or once markEndOfData()
+    has been called after the last chunk.
+
+    Note that the reader reads ahead from the device, so the device's read
+    position is generally past the end of the current token.
+
+    \section1 Error handling
+
+    Once a syntax error has been detected, readNext() returns Invalid, and
+    error(), errorString() and currentOffset() describe the problem. The
+    reader stays in the error state until clear() is called.
+
+    \sa QJsonDocument, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader has just read.
+
+    \value NoToken      The reader has not yet read anything.
+    \value Invalid      An error has occurred, reported in error() and
+                        errorString().
+    \value Incomplete   The current token is incomplete. Add more data with
+                        addData(), or wait for the device to receive more
+                        data, and call readNext() again.
+    \value StartObject  The reader reports the start of an object.
+    \value EndObject    The reader reports the end of an object.
+    \value StartArray   The reader reports the start of an array.
+    \value EndArray     The reader reports the end of an array.
+    \value Name         The reader reports the name of an object member,
+                        available through text() and utf8Text().
+    \value String       The reader reports a string value, available
+                        through text() and utf8Text().
+    \value Number       The reader reports a number, available through
+                        toDouble() and toInteger().
+    \value Bool         The reader reports \c true or \c false, available
+                        through toBool().
+    \value Null         The reader reports \c null.
+    \value EndDocument  All available input has been consumed and no value
+                        is open. More values may follow if more data is
+                        added.
+*/
+
+namespace {
+enum {
+    ReadChunkSize = 64 * 1024,
+    NestingLimit = 1024
+};
+
+static const char utf8Bom[] = "\xef\xbb\xbf";
+
+static inline bool isJsonWhitespace(char c) Q_DECL_NOTHROW
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static inline bool isAsciiDigit(char c) Q_DECL_NOTHROW
+{
+    return uint(c - '0') < 10;
+}
+
+static inline int hexDigit(char c) Q_DECL_NOTHROW
+{
+    if (isAsciiDigit(c))
+        return c - '0';
+    const uint lower = uint(c | 0x20) - 'a';
+    return lower < 6 ? int(lower) + 10 : -1;
+}
+
+// Returns the first quote or backslash in [p, end), or end. Sets any bit of
+// *nonAscii if a byte with the high bit set was seen (possibly beyond the
+// returned position).
+static inline const char *findQuoteOrBackslash(const char *p, const char *end, uint *nonAscii) Q_DECL_NOTHROW
+{
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const uint mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                                         _mm_cmpeq_epi8(data, backslash)));
+        *nonAscii |= _mm_movemask_epi8(data);
+        if (mask)
+            return p + qCountTrailingZeroBits(mask);
+        p += 16;
+    }
+#endif
+    for ( ; p < end; ++p) {
+        if (*p == '"' || *p == '\\')
+            return p;
+        *nonAscii |= uchar(*p) & 0x80;
+    }
+    return end;
+}
+
+// Decodes the escape sequence at \a src, which has been validated while
+// scanning, and advances \a src past it.
+static uint decodeEscape(const char *&src) Q_DECL_NOTHROW
+{
+    const char escaped = src[1];
+    src += 2;
+    switch (escaped) {
+    case 'b':
+        return 0x08;
+    case 'f':
+        return 0x0c;
+    case 'n':
+        return 0x0a;
+    case 'r':
+        return 0x0d;
+    case 't':
+        return 0x09;
+    case 'u': {
+        uint ch = 0;
+        for (int i = 0; i < 4; ++i)
+            ch = (ch << 4) | uint(hexDigit(*src++));
+        return ch;
+    }
+    default:
+        // '"', '\\', '/' and, like QJsonDocument, any other ASCII character
+        return uchar(escaped);
+    }
+}
+
+static inline char *encodeUtf8(char *out, uint ch) Q_DECL_NOTHROW
+{
+    if (ch < 0x80) {
+        *out++ = char(ch);
+    } else if (ch < 0x800) {
+        *out++ = char(0xc0 | (ch >> 6));
+        *out++ = char(0x80 | (ch & 0x3f));
+    } else if (ch < 0x10000) {
+        *out++ = char(0xe0 | (ch >> 12));
+        *out++ = char(0x80 | ((ch >> 6) & 0x3f));
+        *out++ = char(0x80 | (ch & 0x3f));
+    } else {
+        *out++ = char(0xf0 | (ch >> 18));
+        *out++ = char(0x80 | ((ch >> 12) & 0x3f));
+        *out++ = char(0x80 | ((ch >> 6) & 0x3f));
+        *out++ = char(0x80 | (ch & 0x3f));
+    }
+    return out;
+}
+} // unnamed namespace
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State : quint8 {
+        ExpectTopLevelValue,
+        ExpectValue,
+        ExpectValueOrEndArray,
+        ExpectNameOrEndObject,
+        ExpectName,
+        ExpectNameSeparator,
+        ExpectValueSeparatorOrEnd
+    };
+
+    // What lies beyond the end of the buffer
+    enum EndOfData {
+        MoreDataAvailable,  // the device may have more; try to read it
+        EndOfChunk,         // addData() mode: the caller may add more
+        NoDataYet,          // sequential device with nothing to read right now
+        EndOfInput          // the device is at its end
+    };
+    enum { NeedMoreData = -1 };
+
+    void reset();
+    int scan(EndOfData endOfData);
+    int scanValue(const char *p, const char *end, EndOfData endOfData);
+    int scanString(const char *p, const char *end, EndOfData endOfData);
+    int scanNumber(const char *p, const char *end, EndOfData endOfData);
+    int scanLiteral(const char *p, const char *end, EndOfData endOfData,
+                    const char *literal, int len, QJsonStreamReader::TokenType type, bool value);
+    int endContainer(const char *p);
+    int outOfData(EndOfData endOfData, QJsonParseError::ParseError errorAtEnd);
+    int setToken(QJsonStreamReader::TokenType type)
+    {
+        token = type;
+        return type;
+    }
+    int setError(QJsonParseError::ParseError error)
+    {
+        lastError = error;
+        return setToken(QJsonStreamReader::Invalid);
+    }
+    bool setRawData(const char *data, qsizetype len);
+    void afterValue()
+    {
+        state = containers.isEmpty() ? ExpectTopLevelValue : ExpectValueSeparatorOrEnd;
+    }
+    void compact();
+    bool fillBuffer(EndOfData *endOfData);
+
+    void decodeText() const;
+    void decodeUtf8() const;
+    const char *value() const { return buffer.constData() + valueStart; }
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qsizetype pos = 0;          // next byte to be scanned
+    qint64 bufferOffset = 0;    // offset of buffer[0] in the input
+
+    qsizetype tokenStart = 0;
+    qsizetype valueStart = 0;   // string contents without quotes, or number
+    qsizetype valueLength = 0;
+    QJsonStreamReader::TokenType token = QJsonStreamReader::NoToken;
+    State state = ExpectTopLevelValue;
+    QJsonParseError::ParseError lastError = QJsonParseError::NoError;
+    bool hasEscapes = false;
+    bool boolValue = false;
+    bool endOfDataMarked = false;   // no more data will be added
+    QVarLengthArray<char, 64> containers;
+
+    mutable bool textDecoded = false;
+    mutable bool utf8Decoded = false;
+    mutable QString textBuffer;
+    mutable QByteArray utf8Buffer;
+};
+
+void QJsonStreamReaderPrivate::reset()
+{
+    buffer.clear();
+    pos = 0;
+    bufferOffset = 0;
+    tokenStart = 0;
+    valueStart = 0;
+    valueLength = 0;
+    token = QJsonStreamReader::NoToken;
+    state = ExpectTopLevelValue;
+    lastError = QJsonParseError::NoError;
+    hasEscapes = false;
+    boolValue = false;
+    endOfDataMarked = false;
+    containers.clear();
+    textDecoded = false;
+    utf8Decoded = false;
+}
+
+int QJsonStreamReaderPrivate::outOfData(EndOfData endOfData, QJsonParseError::ParseError errorAtEnd)
+{
+    switch (endOfData) {
+    case MoreDataAvailable:
+        return NeedMoreData;
+    case EndOfInput:
+        return setError(errorAtEnd);
+    case EndOfChunk:
+    case NoDataYet:
+        break;
+    }
+    // pos stays at the start of the partial token, which is scanned again
+    // once more data has arrived
+    return setToken(QJsonStreamReader::Incomplete);
+}
+
+int QJsonStreamReaderPrivate::scan(EndOfData endOfData)
+{
+    const char *begin = buffer.constData();
+    const char *end = begin + buffer.size();
+    const char *p = begin + pos;
+
+    if (Q_UNLIKELY(bufferOffset == 0 && pos == 0 && state == ExpectTopLevelValue
+                   && end - p >= 3 && memcmp(p, utf8Bom, 3) == 0)) {
+        p += 3;
+    }
+
+    for (;;) {
+        while (p < end && isJsonWhitespace(*p))
+            ++p;
+        pos = p - begin;
+        tokenStart = pos;
+
+        if (p == end) {
+            if (state == ExpectTopLevelValue) {
+                if (endOfData == MoreDataAvailable)
+                    return NeedMoreData;
+                return setToken(endOfData == NoDataYet ? QJsonStreamReader::Incomplete
+                                                       : QJsonStreamReader::EndDocument);
+            }
+            const bool inObject = containers.last() == '{';
+            return outOfData(endOfData, inObject ? QJsonParseError::UnterminatedObject
+                                                 : QJsonParseError::UnterminatedArray);
+        }
+
+        const char c = *p;
+        switch (state) {
+        case ExpectNameSeparator:
+            if (c != ':')
+                return setError(QJsonParseError::MissingNameSeparator);
+            ++p;
+            state = ExpectValue;
+            continue;
+
+        case ExpectValueSeparatorOrEnd: {
+            const bool inObject = containers.last() == '{';
+            if (c == ',') {
+                ++p;
+                state = inObject ? ExpectName : ExpectValue;
+                continue;
+            }
+            if (c == (inObject ? '}' : ']'))
+                return endContainer(p);
+            return setError(inObject ? QJsonParseError::UnterminatedObject
+                                     : QJsonParseError::UnterminatedArray);
+        }
+
+        case ExpectNameOrEndObject:
+            if (c == '}')
+                return endContainer(p);
+            Q_FALLTHROUGH();
+        case ExpectName: {
+            if (c != '"')
+                return setError(QJsonParseError::IllegalValue);
+            const int result = scanString(p, end, endOfData);
+            if (result != QJsonStreamReader::String)
+                return result;
+            state = ExpectNameSeparator;
+            return setToken(QJsonStreamReader::Name);
+        }
+
+        case ExpectValueOrEndArray:
+            if (c == ']')
+                return endContainer(p);
+            Q_FALLTHROUGH();
+        case ExpectTopLevelValue:
+        case ExpectValue:
+            return scanValue(p, end, endOfData);
+        }
+        Q_UNREACHABLE();
+    }
+}
+
+int QJsonStreamReaderPrivate::scanValue(const char *p, const char *end, EndOfData endOfData)
+{
+    switch (*p) {
+    case '{':
+    case '[':
+        if (containers.size() >= NestingLimit)
+            return setError(QJsonParseError::DeepNesting);
+        containers.append(*p);
+        pos = p + 1 - buffer.constData();
+        if (*p == '{') {
+            state = ExpectNameOrEndObject;
+            return setToken(QJsonStreamReader::StartObject);
+        }
+        state = ExpectValueOrEndArray;
+        return setToken(QJsonStreamReader::StartArray);
+    case '"': {
+        const int result = scanString(p, end, endOfData);
+        if (result == QJsonStreamReader::String)
+            afterValue();
+        return result;
+    }
+    case 't':
+        return scanLiteral(p, end, endOfData, "true", 4, QJsonStreamReader::Bool, true);
+    case 'f':
+        return scanLiteral(p, end, endOfData, "false", 5, QJsonStreamReader::Bool, false);
+    case 'n':
+        return scanLiteral(p, end, endOfData, "null", 4, QJsonStreamReader::Null, false);
+    default:
+        if (*p == '-' || isAsciiDigit(*p))
+            return scanNumber(p, end, endOfData);
+        return setError(QJsonParseError::IllegalValue);
+    }
+}
+
+int QJsonStreamReaderPrivate::scanLiteral(const char *p, const char *end, EndOfData endOfData,
+                                          const char *literal, int len,
+                                          QJsonStreamReader::TokenType type, bool value)
+{
+    if (end - p < len) {
+        if (memcmp(p, literal, end - p) != 0)
+            return setError(QJsonParseError::IllegalValue);
+        return outOfData(endOfData, QJsonParseError::IllegalValue);
+    }
+    if (memcmp(p, literal, len) != 0)
+        return setError(QJsonParseError::IllegalValue);
+    pos = p + len - buffer.constData();
+    boolValue = value;
+    afterValue();
+    return setToken(type);
+}
+
+int QJsonStreamReaderPrivate::scanNumber(const char *p, const char *end, EndOfData endOfData)
+{
+    const char *s = p;
+    if (*s == '-')
+        ++s;
+    const char *digits = s;
+    while (s < end && isAsciiDigit(*s))
+        ++s;
+    bool valid = s > digits && !(*digits == '0' && s - digits > 1);
+    if (s < end && *s == '.') {
+        const char *fraction = ++s;
+        while (s < end && isAsciiDigit(*s))
+            ++s;
+        valid = valid && s > fraction;
+    }
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        ++s;
+        if (s < end && (*s == '+' || *s == '-'))
+            ++s;
+        const char *exponent = s;
+        while (s < end && isAsciiDigit(*s))
+            ++s;
+        valid = valid && s > exponent;
+    }
+
+    if (s == end) {
+        // the number may continue in data we have not seen yet; a number at
+        // the very end of the input is only complete at top level
+        if (endOfData != EndOfInput || !containers.isEmpty())
+            return outOfData(endOfData, QJsonParseError::TerminationByNumber);
+    }
+    if (!valid)
+        return setError(QJsonParseError::IllegalNumber);
+
+    const char *begin = buffer.constData();
+    valueStart = p - begin;
+    valueLength = s - p;
+    pos = s - begin;
+    afterValue();
+    return setToken(QJsonStreamReader::Number);
+}
+
+int QJsonStreamReaderPrivate::scanString(const char *p, const char *end, EndOfData endOfData)
+{
+    const char *s = p + 1;
+    uint nonAscii = 0;
+    bool escapes = false;
+    for (;;) {
+        s = findQuoteOrBackslash(s, end, &nonAscii);
+        if (s == end)
+            return outOfData(endOfData, QJsonParseError::UnterminatedString);
+        if (*s == '"')
+            break;
+
+        // validate the escape sequence now, so that decoding cannot fail
+        escapes = true;
+        if (end - s < 2)
+            return outOfData(endOfData, QJsonParseError::UnterminatedString);
+        if (s[1] == 'u') {
+            if (end - s < 6) {
+                for (const char *h = s + 2; h < end; ++h) {
+                    if (hexDigit(*h) < 0)
+                        return setError(QJsonParseError::IllegalEscapeSequence);
+                }
+                return outOfData(endOfData, QJsonParseError::UnterminatedString);
+            }
+            for (int i = 2; i < 6; ++i) {
+                if (hexDigit(s[i]) < 0)
+                    return setError(QJsonParseError::IllegalEscapeSequence);
+            }
+            s += 6;
+        } else {
+            if (uchar(s[1]) >= 0x80)
+                return setError(QJsonParseError::IllegalEscapeSequence);
+            s += 2;
+        }
+    }
+
+    const char *begin = buffer.constData();
+    valueStart = p + 1 - begin;
+    valueLength = s - (p + 1);
+    if (nonAscii && !QUtf8::isValidUtf8(p + 1, valueLength).isValidUtf8) {
+        pos = tokenStart;
+        return setError(QJsonParseError::IllegalUTF8String);
+    }
+    hasEscapes = escapes;
+    pos = s + 1 - begin;
+    return setToken(QJsonStreamReader::String);
+}
+
+int QJsonStreamReaderPrivate::endContainer(const char *p)
+{
+    const char container = containers.last();
+    containers.removeLast();
+    pos = p + 1 - buffer.constData();
+    afterValue();
+    return setToken(container == '{' ? QJsonStreamReader::EndObject
+                                     : QJsonStreamReader::EndArray);
+}
+
+void QJsonStreamReaderPrivate::compact()
+{
+    if (pos == 0)
+        return;
+    // a buffer filled from the device is reused in place; data added by the
+    // caller may be shared or raw, so only copy what is left of it
+    if (device)
+        buffer.remove(0, int(pos));
+    else
+        buffer = buffer.mid(int(pos));
+    bufferOffset += pos;
+    tokenStart -= qMin(tokenStart, pos);
+    pos = 0;
+}
+
+bool QJsonStreamReaderPrivate::fillBuffer(EndOfData *endOfData)
+{
+    compact();
+
+    // a partial token is kept at the start of the buffer; make sure the
+    // next read can at least double it
+    const qsizetype oldSize = buffer.size();
+    const qint64 chunk = qMax<qint64>(ReadChunkSize, oldSize);
+    buffer.resize(int(oldSize + chunk));
+    const qint64 bytesRead = device->read(buffer.data() + oldSize, chunk);
+    buffer.resize(int(oldSize + qMax<qint64>(bytesRead, 0)));
+    if (bytesRead > 0)
+        return true;
+
+    if (bytesRead == 0 && device->isSequential() && device->isOpen())
+        *endOfData = NoDataYet;
+    else
+        *endOfData = EndOfInput;
+    return false;
+}
+
+void QJsonStreamReaderPrivate::decodeText() const
+{
+    const char *src = value();
+    const char *end = src + valueLength;
+
+    // UTF-16 never needs more code units than the UTF-8 input has bytes
+    textBuffer.resize(int(valueLength));
+    QChar *out = textBuffer.data();
+    while (src < end) {
+        const char *escape = hasEscapes
+                ? static_cast<const char *>(memchr(src, '\\', end - src)) : nullptr;
+        if (!escape)
+            escape = end;
+        if (Q_UNLIKELY(escape - src >= 3 && memcmp(src, utf8Bom, 3) == 0)) {
+            // QUtf8 would drop a leading BOM, but here it is content
+            *out++ = QChar(QChar::ByteOrderMark);
+            src += 3;
+        }
+        out = QUtf8::convertToUnicode(out, src, int(escape - src));
+        src = escape;
+        if (src < end)
+            *out++ = QChar(ushort(decodeEscape(src)));
+    }
+    textBuffer.resize(int(out - textBuffer.constData()));
+    textDecoded = true;
+}
+
+void QJsonStreamReaderPrivate::decodeUtf8() const
+{
+    const char *src = value();
+    const char *end = src + valueLength;
+
+    // no escape sequence is shorter than its UTF-8 encoding
+    utf8Buffer.resize(int(valueLength));
+    char *out = utf8Buffer.data();
+    while (src < end) {
+        const char *escape = static_cast<const char *>(memchr(src, '\\', end - src));
+        if (!escape)
+            escape = end;
+        memcpy(out, src, escape - src);
+        out += escape - src;
+        src = escape;
+        if (src == end)
+            break;
+
+        uint ch = decodeEscape(src);
+        if (QChar::isHighSurrogate(ch) && end - src >= 6 && src[0] == '\\' && src[1] == 'u') {
+            const char *next = src;
+            const uint low = decodeEscape(next);
+            if (QChar::isLowSurrogate(low)) {
+                ch = QChar::surrogateToUcs4(ushort(ch), ushort(low));
+                src = next;
+            }
+        }
+        if (QChar::isSurrogate(ch))
+            ch = QChar::ReplacementCharacter;
+        out = encodeUtf8(out, ch);
+    }
+    utf8Buffer.resize(int(out - utf8Buffer.constData()));
+    utf8Decoded = true;
+}
+
+/*!
+    Constructs a stream reader without any input. Use addData() or
+    setDevice() to supply it.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a stream reader that reads the first \a len bytes of \a data,
+    which hold the complete input (see markEndOfData()).
+
+    The data is not copied: it must remain valid and unchanged until the
+    next call to addData(), clear() or setDevice(), or until the reader is
+    destroyed. Inputs of 2 GiB or more are rejected with a
+    QJsonParseError::DocumentTooLarge error.
+*/
+QJsonStreamReader::QJsonStreamReader(const char *data, qsizetype len)
+    : d(new QJsonStreamReaderPrivate)
+{
+    if (d->setRawData(data, len))
+        d->endOfDataMarked = true;
+}
+
+/*!
+    Constructs a stream reader that reads from \a data, which holds the
+    complete input (see markEndOfData()). Since QByteArray is implicitly
+    shared, the data is not copied.
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->buffer = data;
+    d->endOfDataMarked = true;
+}
+
+/*!
+    Constructs a stream reader that reads from \a device. The device must be
+    open for reading.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Destroys the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device and resets the reader to its
+    initial state. Setting the device to \nullptr lets the reader read from
+    data supplied with addData() instead.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    d->reset();
+    d->device = device;
+    if (device)
+        d->buffer.reserve(ReadChunkSize);
+}
+
+/*!
+    Returns the current device, or \nullptr if none has been set.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Appends \a data to the input. If the previous call to readNext()
+    returned Incomplete, the next call continues with the partial token.
+
+    This function does nothing if a device has been set.
+
+    \note Data returned by text() and utf8Text() is invalidated.
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->compact();
+    if (d->buffer.isEmpty())
+        d->buffer = data;
+    else
+        d->buffer.append(data);
+    d->endOfDataMarked = false;
+}
+
+/*!
+    \overload
+
+    Appends the first \a len bytes of \a data to the input.
+
+    If all earlier input has been read, the data is not copied: it must
+    then remain valid and unchanged until the next call to addData(),
+    clear() or setDevice(), or until the reader is destroyed. If the
+    buffered input would reach 2 GiB, the data is rejected with a
+    QJsonParseError::DocumentTooLarge error; add it in smaller chunks,
+    reading in between.
+*/
+void QJsonStreamReader::addData(const char *data, qsizetype len)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->compact();
+    if (d->buffer.isEmpty()) {
+        d->setRawData(data, len);
+    } else if (len > std::numeric_limits<int>::max() - d->buffer.size()) {
+        d->setError(QJsonParseError::DocumentTooLarge);
+        return;
+    } else {
+        d->buffer.append(data, int(len));
+    }
+    d->endOfDataMarked = false;
+}
+
+bool QJsonStreamReaderPrivate::setRawData(const char *data, qsizetype len)
+{
+    // QByteArray holds at most 2 GiB
+    if (len < 0 || len > std::numeric_limits<int>::max()) {
+        setError(QJsonParseError::DocumentTooLarge);
+        return false;
+    }
+    buffer = QByteArray::fromRawData(data, int(len));
+    return true;
+}
+
+/*!
+    Tells the reader that no more data will be added with addData(), so that
+    the end of the buffered input is the end of the document. Until then, a
+    number at the very end of the input might still continue in the next
+    chunk, and readNext() returns Incomplete for it. Afterwards, the number
+    is returned, and a value or container that is cut off is an error.
+
+    The constructors that take the input as an argument mark its end
+    themselves. Adding more data clears the mark again.
+
+    This function does nothing if a device has been set, as the reader then
+    detects the end of the input itself.
+*/
+void QJsonStreamReader::markEndOfData()
+{
+    d->endOfDataMarked = true;
+}
+
+/*!
+    Removes any data from the reader and resets its internal state to the
+    initial state. The device, if any, is kept.
+*/
+void QJsonStreamReader::clear()
+{
+    d->reset();
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    If an error has occurred earlier, this function returns Invalid and
+    does nothing.
+
+    \sa tokenType()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    if (d->lastError != QJsonParseError::NoError)
+        return Invalid;
+
+    d->textDecoded = false;
+    d->utf8Decoded = false;
+    d->hasEscapes = false;
+
+    if (!d->device)
+        return TokenType(d->scan(d->endOfDataMarked ? QJsonStreamReaderPrivate::EndOfInput
+                                                    : QJsonStreamReaderPrivate::EndOfChunk));
+
+    for (;;) {
+        int result = d->scan(QJsonStreamReaderPrivate::MoreDataAvailable);
+        if (result != QJsonStreamReaderPrivate::NeedMoreData)
+            return TokenType(result);
+        QJsonStreamReaderPrivate::EndOfData endOfData;
+        if (!d->fillBuffer(&endOfData))
+            return TokenType(d->scan(endOfData));
+    }
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa readNext()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->token;
+}
+
+/*!
+    Returns \c true if the reader has consumed all of its input outside of
+    any value, or if an error has occurred. If more data is added, reading
+    can continue after EndDocument.
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    return d->token == EndDocument || d->token == Invalid;
+}
+
+/*!
+    Skips the current value. If the current token is StartObject or
+    StartArray, reads up to and including the matching end token. If it is
+    a Name, skips the member's value. Returns \c false if the value could
+    not be skipped completely because of an error or missing data.
+*/
+bool QJsonStreamReader::skipCurrentValue()
+{
+    switch (d->token) {
+    case Name:
+        switch (readNext()) {
+        case StartObject:
+        case StartArray:
+            return skipCurrentValue();
+        case String:
+        case Number:
+        case Bool:
+        case Null:
+            return true;
+        default:
+            return false;
+        }
+    case StartObject:
+    case StartArray: {
+        const int target = depth() - 1;
+        while (depth() > target) {
+            switch (readNext()) {
+            case Invalid:
+            case Incomplete:
+            case EndDocument:
+                return false;
+            default:
+                break;
+            }
+        }
+        return true;
+    }
+    case NoToken:
+    case Invalid:
+    case Incomplete:
+    case EndDocument:
+        return false;
+    default:
+        return true;
+    }
+}
+
+/*!
+    Returns the number of objects and arrays that are currently open.
+*/
+int QJsonStreamReader::depth() const
+{
+    return d->containers.size();
+}
+
+/*!
+    Returns the offset in the input, in bytes, of the current token. After
+    an error, this is the position at which the error was detected.
+*/
+qint64 QJsonStreamReader::currentOffset() const
+{
+    return d->bufferOffset + d->tokenStart;
+}
+
+/*!
+    Returns the text of the current Name or String token, with escape
+    sequences resolved, or the digits of the current Number. For any other
+    token, returns a null view.
+
+    The string is decoded on first use and kept until the next call to
+    readNext().
+
+    \sa utf8Text()
+*/
+QStringView QJsonStreamReader::text() const
+{
+    switch (d->token) {
+    case Name:
+    case String:
+    case Number:
+        if (!d->textDecoded)
+            d->decodeText();
+        return QStringView(d->textBuffer);
+    default:
+        return QStringView();
+    }
+}
+
+/*!
+    Returns the text of the current Name or String token as UTF-8, with
+    escape sequences resolved, or the digits of the current Number. For any
+    other token, returns a null byte array.
+
+    If the text contains no escape sequences, the returned byte array
+    refers directly to the reader's buffer (see QByteArray::fromRawData())
+    and must not be used after the next call to readNext(), addData() or
+    clear(). Use QByteArray::detach() on it if it needs to be kept.
+
+    \sa text()
+*/
+QByteArray QJsonStreamReader::utf8Text() const
+{
+    switch (d->token) {
+    case Name:
+    case String:
+    case Number:
+        break;
+    default:
+        return QByteArray();
+    }
+    if (!d->hasEscapes)
+        return QByteArray::fromRawData(d->value(), int(d->valueLength));
+    if (!d->utf8Decoded)
+        d->decodeUtf8();
+    return QByteArray::fromRawData(d->utf8Buffer.constData(), d->utf8Buffer.size());
+}
+
+/*!
+    Returns the value of the current Number token, or 0 for any other
+    token.
+
+    \sa toInteger()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    if (d->token != Number)
+        return 0;
+    bool ok;
+    int processed;
+    return qt_asciiToDouble(d->value(), int(d->valueLength), ok, processed);
+}
+
+/*!
+    Returns the value of the current Number token as a 64-bit integer. If
+    the number is not an integer or does not fit, returns 0 and sets
+    *\a{ok} to \c false; otherwise sets *\a{ok} to \c true. Numbers such as
+    \c{1.0} or \c{1e3} that have an exact integral value are accepted.
+
+    \sa toDouble()
+*/
+qint64 QJsonStreamReader::toInteger(bool *ok) const
+{
+    if (ok)
+        *ok = false;
+    if (d->token != Number)
+        return 0;
+
+    const char *s = d->value();
+    const char *end = s + d->valueLength;
+    const bool negative = *s == '-';
+    if (negative)
+        ++s;
+    quint64 value = 0;
+    for ( ; s < end; ++s) {
+        if (!isAsciiDigit(*s))
+            break;
+        if (mul_overflow(value, quint64(10), &value)
+                || add_overflow(value, quint64(*s - '0'), &value)) {
+            return 0;
+        }
+    }
+
+    if (s < end) {
+        // fraction or exponent
+        const double number = toDouble();
+        if (number != std::floor(number) || number < -9223372036854775808.0
+                || number >= 9223372036854775808.0) {
+            return 0;
+        }
+        if (ok)
+            *ok = true;
+        return qint64(number);
+    }
+
+    const quint64 limit = quint64(std::numeric_limits<qint64>::max()) + (negative ? 1 : 0);
+    if (value > limit)
+        return 0;
+    if (ok)
+        *ok = true;
+    return negative ? qint64(0 - value) : qint64(value);
+}
+
+/*!
+    Returns the value of the current Bool token, or \c false for any other
+    token.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->token == Bool && d->boolValue;
+}
+
+/*!
+    Returns \c true if an error has occurred.
+
+    \sa error(), errorString()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->lastError != QJsonParseError::NoError;
+}
+
+/*!
+    Returns the type of the current error, or QJsonParseError::NoError.
+
+    \sa errorString(), currentOffset()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    return d->lastError;
+}
+
+/*!
+    Returns a human-readable description of the current error.
+
+    \sa error()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    QJsonParseError error;
+    error.offset = int(currentOffset());
+    error.error = d->lastError;
+    return error.errorString();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
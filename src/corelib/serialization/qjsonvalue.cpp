@@ -257,7 +257,7 @@ QJsonValue::QJsonValue(const QJsonObject &o)
 QJsonValue::~QJsonValue()
 {
     if (t == String && stringData && !stringData->ref.deref())
-        free(stringData);
+        QStringData::deallocate(stringData);
 
     if (d && !d->ref.deref())
         delete d;
@@ -233,6 +233,9 @@ static const int QTEXTSTREAM_BUFFERSIZE = 16384;
 
 #include <locale.h>
 #include "private/qlocale_p.h"
+#include "private/qlocale_tools_p.h"
+#include "private/qsimd_p.h"
+#include "private/qutfcodec_p.h"
 
 #include <stdlib.h>
 #include <limits.h>
@@ -427,13 +430,18 @@ bool QTextStreamPrivate::fillReadBuffer(qint64 maxBytes)
     if (textModeEnabled)
         device->setTextModeEnabled(false);
 
-    // read raw data into a temporary buffer
-    char buf[QTEXTSTREAM_BUFFERSIZE];
+    // decode straight from the device's buffer (or the mapped file) where
+    // possible, instead of copying the raw data into a temporary buffer
+    const qint64 maxRead = (maxBytes != -1) ? qMin<qint64>(QTEXTSTREAM_BUFFERSIZE, maxBytes)
+                                            : qint64(QTEXTSTREAM_BUFFERSIZE);
+    QByteArray view;
+    const char *buf;
     qint64 bytesRead = 0;
 #if defined(Q_OS_WIN)
     // On Windows, there is no non-blocking stdin - so we fall back to reading
     // lines instead. If there is no QOBJECT, we read lines for all sequential
     // devices; otherwise, we read lines only for stdin.
+    char lineBuf[QTEXTSTREAM_BUFFERSIZE];
     QFile *file = 0;
     Q_UNUSED(file);
     if (device->isSequential()
@@ -441,17 +449,14 @@ bool QTextStreamPrivate::fillReadBuffer(qint64 maxBytes)
         && (file = qobject_cast<QFile *>(device)) && file->handle() == 0
 #endif
         ) {
-        if (maxBytes != -1)
-            bytesRead = device->readLine(buf, qMin<qint64>(sizeof(buf), maxBytes));
-        else
-            bytesRead = device->readLine(buf, sizeof(buf));
+        bytesRead = device->readLine(lineBuf, maxRead);
+        buf = lineBuf;
     } else
 #endif
     {
-        if (maxBytes != -1)
-            bytesRead = device->read(buf, qMin<qint64>(sizeof(buf), maxBytes));
-        else
-            bytesRead = device->read(buf, sizeof(buf));
+        view = device->readView(maxRead);
+        bytesRead = view.size();
+        buf = view.constData();
     }
 
     // reset the Text flag.
@@ -481,14 +486,22 @@ bool QTextStreamPrivate::fillReadBuffer(qint64 maxBytes)
 
 #if defined (QTEXTSTREAM_DEBUG)
     qDebug("QTextStreamPrivate::fillReadBuffer(), device->read(\"%s\", %d) == %d",
-           qt_prettyDebug(buf, qMin(32,int(bytesRead)) , int(bytesRead)).constData(), int(sizeof(buf)), int(bytesRead));
+           qt_prettyDebug(buf, qMin(32,int(bytesRead)) , int(bytesRead)).constData(), int(maxRead), int(bytesRead));
 #endif
 
     int oldReadBufferSize = readBuffer.size();
 #if QT_CONFIG(textcodec)
-    // convert to unicode
-    readBuffer += Q_LIKELY(codec) ? codec->toUnicode(buf, bytesRead, &readConverterState)
-                                  : QString::fromLatin1(buf, bytesRead);
+    // convert to unicode; UTF-8 is decoded directly into the read buffer
+    // rather than into a temporary string that is then appended to it
+    if (Q_LIKELY(codec) && codec->mibEnum() == 106) {
+        readBuffer.resize(oldReadBufferSize + int(bytesRead) + 1);
+        const QChar *end = QUtf8::convertToUnicode(readBuffer.data() + oldReadBufferSize,
+                                                   buf, int(bytesRead), &readConverterState);
+        readBuffer.truncate(int(end - readBuffer.constData()));
+    } else {
+        readBuffer += Q_LIKELY(codec) ? codec->toUnicode(buf, bytesRead, &readConverterState)
+                                      : QString::fromLatin1(buf, bytesRead);
+    }
 #else
     readBuffer += QString::fromLatin1(buf, bytesRead);
 #endif
@@ -638,6 +651,50 @@ QString QTextStreamPrivate::read(int maxlen)
     return ret;
 }
 
+/*!
+    \internal
+
+    Returns a pointer to the first character in [\a ptr, \a end) for which
+    QChar::isSpace() returns \a WantSpace, or \a end if there is none.
+    Blocks of ASCII text are checked eight characters at a time.
+*/
+template <bool WantSpace>
+static const QChar *findSpace(const QChar *ptr, const QChar *end)
+{
+#ifdef __SSE2__
+    const __m128i tab = _mm_set1_epi16('\t');
+    const __m128i controlRange = _mm_set1_epi16('\r' - '\t');
+    const __m128i blank = _mm_set1_epi16(' ');
+    const __m128i asciiMax = _mm_set1_epi16(0x7f);
+    const __m128i zero = _mm_setzero_si128();
+    for (; end - ptr >= 8; ptr += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        // '\t' to '\r' and ' ' are the only ASCII spaces
+        const __m128i control = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(data, tab), controlRange), zero);
+        const __m128i spaces = _mm_or_si128(control, _mm_cmpeq_epi16(data, blank));
+        uint mask = uint(_mm_movemask_epi8(spaces));
+        if (WantSpace) {
+            // other characters may be spaces only if they are not ASCII
+            const __m128i ascii = _mm_cmpeq_epi16(_mm_subs_epu16(data, asciiMax), zero);
+            mask |= ~uint(_mm_movemask_epi8(ascii)) & 0xffff;
+        } else {
+            mask = ~mask & 0xffff;
+        }
+        while (mask) {
+            const uint idx = qCountTrailingZeroBits(mask) / 2;
+            if (ptr[idx].isSpace() == WantSpace)
+                return ptr + idx;
+            mask &= ~(3U << (idx * 2));
+        }
+    }
+#endif
+    for (; ptr != end; ++ptr) {
+        if (ptr->isSpace() == WantSpace)
+            return ptr;
+    }
+    return end;
+}
+
 /*!
     \internal
 
@@ -667,33 +724,39 @@ bool QTextStreamPrivate::scan(const QChar **ptr, int *length, int maxlen, TokenD
         }
         chPtr += startOffset;
 
-        for (; !foundToken && startOffset < endOffset && (!maxlen || totalSize < maxlen); ++startOffset) {
-            const QChar ch = *chPtr++;
-            ++totalSize;
+        int available = endOffset - startOffset;
+        if (maxlen)
+            available = qMin(available, maxlen - totalSize);
+        const QChar *const limit = chPtr + qMax(available, 0);
 
-            switch (delimiter) {
-            case Space:
-                if (ch.isSpace()) {
-                    foundToken = true;
-                    delimSize = 1;
-                }
-                break;
-            case NotSpace:
-                if (!ch.isSpace()) {
-                    foundToken = true;
-                    delimSize = 1;
-                }
-                break;
-            case EndOfLine:
-                if (ch == QLatin1Char('\n')) {
-                    foundToken = true;
-                    delimSize = (lastChar == QLatin1Char('\r')) ? 2 : 1;
-                    consumeDelimiter = true;
-                }
-                lastChar = ch;
-                break;
+        const QChar *found = limit;
+        switch (delimiter) {
+        case Space:
+            found = findSpace<true>(chPtr, limit);
+            break;
+        case NotSpace:
+            found = findSpace<false>(chPtr, limit);
+            break;
+        case EndOfLine:
+            found = reinterpret_cast<const QChar *>(QtPrivate::qustrchr(QStringView(chPtr, limit), '\n'));
+            break;
+        }
+
+        if (found != limit) {
+            foundToken = true;
+            delimSize = 1;
+            if (delimiter == EndOfLine) {
+                if ((found != chPtr ? found[-1] : lastChar) == QLatin1Char('\r'))
+                    delimSize = 2;
+                consumeDelimiter = true;
+                lastChar = *found;
             }
+            ++found; // the delimiter is part of the scanned data
+        } else if (delimiter == EndOfLine && found != chPtr) {
+            lastChar = found[-1];
         }
+        totalSize += int(found - chPtr);
+        startOffset += int(found - chPtr);
     } while (!foundToken
              && (!maxlen || totalSize < maxlen)
              && (device && (canStillReadFromDevice = fillReadBuffer())));
@@ -1754,6 +1817,41 @@ QTextStreamPrivate::NumberParsingStatus QTextStreamPrivate::getNumber(qulonglong
     scan(0, 0, 0, NotSpace);
     consumeLastToken();
 
+    // Fast path: a decimal number in the C locale that ends within the
+    // buffered data is parsed in place rather than character by character.
+    if ((params.integerBase == 0 || params.integerBase == 10) && locale == QLocale::c()) {
+        const QChar *const begin = readPtr();
+        const QChar *const end = begin + (string ? string->size() - stringOffset
+                                                 : readBuffer.size() - readBufferOffset);
+        const QChar *ptr = begin;
+        const bool negative = (ptr != end && *ptr == QLatin1Char('-'));
+        if (negative || (ptr != end && *ptr == QLatin1Char('+')))
+            ++ptr;
+        const QChar *const digits = ptr;
+        qulonglong val = 0;
+        for (; ptr != end && uint(ptr->unicode()) - '0' <= 9; ++ptr)
+            val = val * 10 + (ptr->unicode() - '0');
+
+        // Leave the cases where the slow path might read more than we did
+        // to it: non-ASCII digits, data yet to be read, and (when detecting
+        // the base) the prefixes of octal, hex and binary numbers.
+        const bool terminated = ptr != end ? ptr->unicode() < 0x80 : !device;
+        const bool prefixed = params.integerBase == 0 && digits == begin
+                && *digits == QLatin1Char('0') && digits + 1 != end && digits[1].isLetterOrNumber();
+        if (ptr != digits && terminated && !prefixed) {
+            consume(int(ptr - begin));
+            if (negative) {
+                qlonglong ival = qlonglong(val);
+                if (ival > 0)
+                    ival = -ival;
+                val = qulonglong(ival);
+            }
+            if (ret)
+                *ret = val;
+            return npsOk;
+        }
+    }
+
     // detect int encoding
     int base = params.integerBase;
     if (base == 0) {
@@ -1987,46 +2085,82 @@ bool QTextStreamPrivate::getReal(double *f)
     char buf[BufferSize];
     int i = 0;
 
-    QChar c;
-    while (getChar(&c)) {
+    const bool cLocale = (locale == QLocale::c());
+    auto inputFor = [&](QChar c) {
         switch (c.unicode()) {
         case '0': case '1': case '2': case '3': case '4':
         case '5': case '6': case '7': case '8': case '9':
-            input = InputDigit;
-            break;
+            return InputDigit;
         case 'i': case 'I':
-            input = InputI;
-            break;
+            return InputI;
         case 'n': case 'N':
-            input = InputN;
-            break;
+            return InputN;
         case 'f': case 'F':
-            input = InputF;
-            break;
+            return InputF;
         case 'a': case 'A':
-            input = InputA;
-            break;
+            return InputA;
         case 't': case 'T':
-            input = InputT;
+            return InputT;
+        case '.':
+            if (cLocale)
+                return InputDot;
             break;
-        default: {
-            QChar lc = c.toLower();
-            if (lc == locale.decimalPoint().toLower())
-                input = InputDot;
-            else if (lc == locale.exponential().toLower())
-                input = InputExp;
-            else if (lc == locale.negativeSign().toLower()
-                     || lc == locale.positiveSign().toLower())
-                input = InputSign;
-            else if (locale != QLocale::c() // backward-compatibility
-                     && lc == locale.groupSeparator().toLower())
-                input = InputDigit; // well, it isn't a digit, but no one cares.
-            else
-                input = None;
-        }
+        case 'e': case 'E':
+            if (cLocale)
+                return InputExp;
+            break;
+        case '-': case '+':
+            if (cLocale)
+                return InputSign;
             break;
+        default:
+            if (cLocale)
+                return None;
+            break;
+        }
+
+        QChar lc = c.toLower();
+        if (lc == locale.decimalPoint().toLower())
+            return InputDot;
+        if (lc == locale.exponential().toLower())
+            return InputExp;
+        if (lc == locale.negativeSign().toLower()
+                || lc == locale.positiveSign().toLower())
+            return InputSign;
+        if (!cLocale // backward-compatibility
+                && lc == locale.groupSeparator().toLower())
+            return InputDigit; // well, it isn't a digit, but no one cares.
+        return None;
+    };
+
+    // Fast path: if the number ends within the buffered data, run the state
+    // machine over it in place rather than character by character.
+    bool parsed = false;
+    {
+        const QChar *const begin = readPtr();
+        const QChar *const end = begin + (string ? string->size() - stringOffset
+                                                 : readBuffer.size() - readBufferOffset);
+        const QChar *ptr = begin;
+        for (; ptr != end && i <= BufferSize - 5; ++ptr) {
+            input = inputFor(*ptr);
+            state = ParserState(table[state][input]);
+            if (state == Init || state == Done)
+                break;
+            buf[i++] = ptr->toLatin1();
         }
 
+        if (i <= BufferSize - 5 && (ptr != end || !device)) {
+            consume(int(ptr - begin));
+            parsed = true;
+        } else {
+            state = Init;
+            i = 0;
+        }
+    }
+
+    QChar c;
+    while (!parsed && getChar(&c)) {
+        input = inputFor(c);
         state = ParserState(table[state][input]);
 
         if  (state == Init || state == Done || i > (BufferSize - 5)) {
@@ -2066,7 +2200,10 @@ bool QTextStreamPrivate::getReal(double *f)
         return true;
     }
     bool ok;
-    *f = locale.toDouble(QString::fromLatin1(buf), &ok);
+    if (cLocale)
+        *f = QLocaleData::bytearrayToDouble(buf, &ok);
+    else
+        *f = locale.toDouble(QString::fromLatin1(buf), &ok);
     return ok;
 }
 
@@ -1489,9 +1489,19 @@ uint QXmlStreamReaderPrivate::getChar_helper()
 #endif
         nbytesread = 0;
     if (device) {
-        rawReadBuffer.resize(BUFFER_SIZE);
-        int nbytesreadOrMinus1 = device->read(rawReadBuffer.data() + nbytesread, BUFFER_SIZE - nbytesread);
-        nbytesread += qMax(nbytesreadOrMinus1, 0);
+#if QT_CONFIG(textcodec)
+        if (decoder) {
+            // once the encoding is known, decode straight from the device's
+            // memory instead of copying into rawReadBuffer first
+            rawReadBuffer = device->readView(BUFFER_SIZE);
+            nbytesread = rawReadBuffer.size();
+        } else
+#endif
+        {
+            rawReadBuffer.resize(BUFFER_SIZE);
+            int nbytesreadOrMinus1 = device->read(rawReadBuffer.data() + nbytesread, BUFFER_SIZE - nbytesread);
+            nbytesread += qMax(nbytesreadOrMinus1, 0);
+        }
     } else {
         if (nbytesread)
             rawReadBuffer += dataBuffer;
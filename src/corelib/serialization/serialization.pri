@@ -6,6 +6,7 @@ HEADERS += \
     serialization/qcbormap.h \
     serialization/qcborvalue.h \
     serialization/qcborvalue_p.h \
+    serialization/qcborvalueview.h \
     serialization/qcborstream.h \
     serialization/qdatastream.h \
     serialization/qdatastream_p.h \
@@ -16,6 +17,7 @@ HEADERS += \
     serialization/qjsonarray.h \
     serialization/qjsonwriter_p.h \
     serialization/qjsonparser_p.h \
+    serialization/qjsonstreamreader.h \
     serialization/qtextstream.h \
     serialization/qtextstream_p.h \
     serialization/qxmlstream.h \
@@ -26,6 +28,7 @@ SOURCES += \
     serialization/qcborstream.cpp \
     serialization/qcbordiagnostic.cpp \
     serialization/qcborvalue.cpp \
+    serialization/qcborvalueview.cpp \
     serialization/qdatastream.cpp \
     serialization/qjson.cpp \
     serialization/qjsoncbor.cpp \
@@ -35,6 +38,7 @@ SOURCES += \
     serialization/qjsonvalue.cpp \
     serialization/qjsonwriter.cpp \
     serialization/qjsonparser.cpp \
+    serialization/qjsonstreamreader.cpp \
     serialization/qtextstream.cpp \
     serialization/qxmlstream.cpp \
     serialization/qxmlutils.cpp
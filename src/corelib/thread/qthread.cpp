@@ -89,6 +89,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    mergeLockFreePostedEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -101,6 +102,51 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+/*
+    Moves the events posted through QPostEventList::addEventLockFree() into
+    the sorted list. Must be called with postEventList.mutex locked.
+*/
+void QThreadData::mergeLockFreePostedEvents()
+{
+    QPostEventNode *node = postEventList.lockFreeEvents.fetchAndStoreAcquire(nullptr);
+    if (!node)
+        return;
+
+    // the stack has the most recent event on top, restore the posting order
+    QPostEventNode *ordered = nullptr;
+    while (node) {
+        QPostEventNode *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+
+    while (ordered) {
+        QPostEventNode *next = ordered->next;
+        const QPostEvent &pe = ordered->event;
+        QThreadData *receiverData = pe.receiver->d_func()->threadData;
+
+        if (receiverData == this) {
+            postEventList.addEvent(pe);
+            canWait = false;
+            delete ordered;
+        } else if (receiverData) {
+            // the receiver was moved to another thread after the event
+            // was posted, follow it
+            receiverData->postEventList.addEventLockFree(ordered);
+            if (QAbstractEventDispatcher *dispatcher = receiverData->eventDispatcher.loadAcquire())
+                dispatcher->wakeUp();
+        } else {
+            --pe.receiver->d_func()->postedEvents;
+            pe.event->posted = false;
+            delete pe.event;
+            delete ordered;
+        }
+
+        ordered = next;
+    }
+}
+
 void QThreadData::ref()
 {
 #if QT_CONFIG(thread)
@@ -102,6 +102,13 @@ inline bool operator<(const QPostEvent &first, const QPostEvent &second)
     return first.priority > second.priority;
 }
 
+// node of the lock-free stack of QPostEventList
+struct QPostEventNode
+{
+    QPostEvent event;
+    QPostEventNode *next;
+};
+
 // This class holds the list of posted events.
 //  The list has to be kept sorted by priority
 class QPostEventList : public QVector<QPostEvent>
@@ -117,10 +124,26 @@ public:
 
     QMutex mutex;
 
+    // events posted without taking the mutex, most recent first. They are
+    // moved into the list by QThreadData::mergeLockFreePostedEvents(), which
+    // must happen before anyone holding the mutex looks at or adds to the list.
+    QAtomicPointer<QPostEventNode> lockFreeEvents;
+
     inline QPostEventList()
-        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
+        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0),
+          lockFreeEvents(nullptr)
     { }
 
+    void addEventLockFree(QPostEventNode *node) {
+        QPostEventNode *head = lockFreeEvents.load();
+        do {
+            node->next = head;
+        } while (!lockFreeEvents.testAndSetRelease(head, node, head));
+    }
+
+    inline bool hasLockFreeEvents() const
+    { return lockFreeEvents.load() != nullptr; }
+
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
         if (isEmpty() ||
@@ -270,9 +293,11 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasLockFreeEvents();
     }
 
+    void mergeLockFreePostedEvents();
+
     // This class provides per-thread (by way of being a QThreadData
     // member) storage for qFlagLocation()
     class FlaggedDebugSignatures
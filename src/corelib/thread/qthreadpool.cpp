@@ -40,6 +40,7 @@
 #include "qthreadpool.h"
 #include "qthreadpool_p.h"
 #include "qdeadlinetimer.h"
+#include "qthreadstorage.h"
 
 #include <algorithm>
 
@@ -57,11 +58,55 @@ public:
     void run() override;
     void registerThreadInactive();
 
+    QRunnable *takeLocalTask();
+    bool tryTakeLocalTask(QRunnable *runnable);
+
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // runnables started from within this thread in work-stealing mode; the
+    // owner takes from the back, other threads steal from the front
+    QMutex localQueueMutex;
+    QList<QRunnable *> localQueue;
 };
 
+// the pool thread the calling thread is, if any
+#if defined(Q_COMPILER_THREAD_LOCAL)
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
+static inline QThreadPoolThread *currentThreadPoolThread()
+{
+    return currentPoolThread;
+}
+
+static inline void setCurrentThreadPoolThread(QThreadPoolThread *thread)
+{
+    currentPoolThread = thread;
+}
+#else
+namespace {
+struct CurrentPoolThread
+{
+    CurrentPoolThread() : thread(nullptr) { }
+    QThreadPoolThread *thread;
+};
+}
+Q_GLOBAL_STATIC(QThreadStorage<CurrentPoolThread>, g_currentPoolThread)
+
+static inline QThreadPoolThread *currentThreadPoolThread()
+{
+    auto tls = g_currentPoolThread();
+    return tls && tls->hasLocalData() ? tls->localData().thread : nullptr;
+}
+
+static inline void setCurrentThreadPoolThread(QThreadPoolThread *thread)
+{
+    if (auto tls = g_currentPoolThread())
+        tls->localData().thread = thread;
+}
+#endif
+
 /*
     QThreadPool private class.
 */
@@ -81,6 +126,8 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    setCurrentThreadPoolThread(this);
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -106,16 +153,36 @@ void QThreadPoolThread::run()
                     throw;
                 }
 #endif
-                locker.relock();
-
-                if (autoDelete && !--r->ref)
-                    delete r;
+                if (manager->workStealing) {
+                    if (autoDelete && manager->derefRunnable(r))
+                        delete r;
+
+                    // work spawned by this thread is run right away, without
+                    // going through the pool-wide lock
+                    r = takeLocalTask();
+                    if (r)
+                        continue;
+
+                    locker.relock();
+                } else {
+                    locker.relock();
+
+                    if (autoDelete && !--r->ref)
+                        delete r;
+                }
             }
 
             // if too many threads are active, expire this thread
             if (manager->tooManyThreadsActive())
                 break;
 
+            if (manager->workStealing) {
+                r = manager->takeOrStealTask(this);
+                if (!r)
+                    break;
+                continue;
+            }
+
             if (manager->queue.isEmpty()) {
                 r = nullptr;
                 break;
@@ -159,11 +226,32 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+/*
+    \internal
+
+    Takes the runnable this thread queued last, or returns nullptr.
+*/
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    QMutexLocker locker(&localQueueMutex);
+    return localQueue.isEmpty() ? nullptr : localQueue.takeLast();
+}
+
+/*
+    \internal
+*/
+bool QThreadPoolThread::tryTakeLocalTask(QRunnable *runnable)
+{
+    QMutexLocker locker(&localQueueMutex);
+    return localQueue.removeOne(runnable);
+}
+
 
 /*
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
+    : workStealing(qEnvironmentVariableIntValue("QT_THREADPOOL_WORK_STEALING") > 0)
 { }
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
@@ -194,7 +282,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         ++activeThreads;
 
         if (task->autoDelete())
-            ++task->ref;
+            refRunnable(task);
         thread->runnable = task;
         thread->start();
         return true;
@@ -214,7 +302,7 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     Q_ASSERT(runnable != nullptr);
     if (runnable->autoDelete())
-        ++runnable->ref;
+        refRunnable(runnable);
 
     for (QueuePage *page : qAsConst(queue)) {
         if (page->priority() == priority && !page->isFull()) {
@@ -226,6 +314,98 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
 }
 
+/*!
+    \internal
+
+    In work-stealing mode, queues \a runnable on the local queue of the
+    calling pool thread, so that it is run by the same thread (and on the
+    same caches) unless another thread runs out of work and steals it.
+    Returns \c false if the caller is not one of this pool's threads.
+*/
+bool QThreadPoolPrivate::enqueueLocalTask(QRunnable *runnable)
+{
+    QThreadPoolThread *thread = currentThreadPoolThread();
+    if (!thread || thread->manager != this)
+        return false;
+
+    if (runnable->autoDelete())
+        refRunnable(runnable);
+
+    bool wasEmpty;
+    {
+        QMutexLocker locker(&thread->localQueueMutex);
+        wasEmpty = thread->localQueue.isEmpty();
+        thread->localQueue.append(runnable);
+    }
+
+    // a thread that is already stealing from us will pick up the rest
+    if (wasEmpty) {
+        QMutexLocker locker(&mutex);
+        wakeOrStartThread();
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Takes the next runnable for \a thread in work-stealing mode: the shared
+    queue comes first, then the oldest runnable queued locally by another
+    thread. Must be called with mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::takeOrStealTask(QThreadPoolThread *thread)
+{
+    if (!queue.isEmpty()) {
+        QueuePage *page = queue.first();
+        QRunnable *r = page->pop();
+        if (page->isFinished()) {
+            queue.removeFirst();
+            delete page;
+        }
+        return r;
+    }
+
+    QRunnable *r = nullptr;
+    bool moreLeft = false;
+    for (QThreadPoolThread *victim : qAsConst(allThreads)) {
+        if (victim == thread)
+            continue;
+        QMutexLocker locker(&victim->localQueueMutex);
+        if (!victim->localQueue.isEmpty()) {
+            r = victim->localQueue.takeFirst();
+            moreLeft = !victim->localQueue.isEmpty();
+            break;
+        }
+    }
+
+    // get another thread to help with the remaining work
+    if (moreLeft)
+        wakeOrStartThread();
+    return r;
+}
+
+/*!
+    \internal
+
+    Wakes up a waiting thread or, if there is none and the limit allows it,
+    starts a new one, so that it can steal queued work. Must be called with
+    mutex locked.
+*/
+void QThreadPoolPrivate::wakeOrStartThread()
+{
+    if (!waitingThreads.isEmpty()) {
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+    } else if (activeThreadCount() < maxThreadCount) {
+        if (!expiredThreads.isEmpty()) {
+            QThreadPoolThread *thread = expiredThreads.dequeue();
+            ++activeThreads;
+            thread->start();
+        } else {
+            startThread();
+        }
+    }
+}
+
 int QThreadPoolPrivate::activeThreadCount() const
 {
     return (allThreads.count()
@@ -262,15 +442,14 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 */
 void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
-    Q_ASSERT(runnable != nullptr);
     QScopedPointer <QThreadPoolThread> thread(new QThreadPoolThread(this));
     thread->setObjectName(QLatin1String("Thread (pooled)"));
     Q_ASSERT(!allThreads.contains(thread.data())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
     allThreads.insert(thread.data());
     ++activeThreads;
 
-    if (runnable->autoDelete())
-        ++runnable->ref;
+    if (runnable && runnable->autoDelete())
+        refRunnable(runnable);
     thread->runnable = runnable;
     thread.take()->start();
 }
@@ -334,12 +513,26 @@ void QThreadPoolPrivate::clear()
     for (QueuePage *page : qAsConst(queue)) {
         while (!page->isFinished()) {
             QRunnable *r = page->pop();
-            if (r && r->autoDelete() && !--r->ref)
+            if (r && r->autoDelete() && derefRunnable(r))
                 delete r;
         }
     }
     qDeleteAll(queue);
     queue.clear();
+
+    if (workStealing) {
+        for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+            QList<QRunnable *> localQueue;
+            {
+                QMutexLocker localLocker(&thread->localQueueMutex);
+                localQueue.swap(thread->localQueue);
+            }
+            for (QRunnable *r : qAsConst(localQueue)) {
+                if (r->autoDelete() && derefRunnable(r))
+                    delete r;
+            }
+        }
+    }
 }
 
 /*!
@@ -375,10 +568,20 @@ bool QThreadPool::tryTake(QRunnable *runnable)
                     delete page;
                 }
                 if (runnable->autoDelete())
-                    --runnable->ref; // undo ++ref in start()
+                    d->derefRunnable(runnable); // undo ++ref in start()
                 return true;
             }
         }
+
+        if (d->workStealing) {
+            for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+                if (thread->tryTakeLocalTask(runnable)) {
+                    if (runnable->autoDelete())
+                        d->derefRunnable(runnable); // undo ++ref in start()
+                    return true;
+                }
+            }
+        }
     }
 
     return false;
@@ -451,6 +654,16 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     implementing time-consuming operations that are not visible to the
     QThreadPool.
 
+    By default all runnables go through a single queue shared by the threads
+    of the pool. Setting the \c QT_THREADPOOL_WORK_STEALING environment
+    variable to a positive value makes each pool thread keep its own queue
+    for the runnables started from within it with the default priority:
+    the thread runs them itself, most recently started first, and idle
+    threads steal the oldest ones. This keeps related work on the thread
+    that produced it and avoids contention on the shared queue for
+    workloads that spawn many small runnables, such as recursive
+    divide-and-conquer algorithms.
+
     Note that QThreadPool is a low-level class for managing threads, see
     the Qt Concurrent module for higher level alternatives.
 
@@ -502,6 +715,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (d->workStealing && priority == 0 && d->enqueueLocalTask(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
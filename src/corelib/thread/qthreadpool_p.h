@@ -157,8 +157,16 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    bool enqueueLocalTask(QRunnable *runnable);
+    QRunnable *takeOrStealTask(QThreadPoolThread *thread);
+    void wakeOrStartThread();
     int activeThreadCount() const;
 
+    // In work-stealing mode runnables are handed around outside of the
+    // mutex, so QRunnable::ref is atomic.
+    static void refRunnable(QRunnable *runnable) { runnable->ref.ref(); }
+    static bool derefRunnable(QRunnable *runnable) { return !runnable->ref.deref(); }
+
     void tryToStartMoreThreads();
     bool tooManyThreadsActive() const;
 
@@ -182,6 +190,7 @@ public:
     int reservedThreads = 0;
     int activeThreads = 0;
     uint stackSize = 0;
+    const bool workStealing;
 };
 
 QT_END_NAMESPACE
@@ -39,10 +39,18 @@
 ****************************************************************************/
 
 #include <QtCore/qarraydata.h>
+#include <QtCore/qmemoryarena.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/private/qmemoryarena_p.h>
 #include <QtCore/private/qnumeric_p.h>
 #include <QtCore/private/qtools_p.h>
 
 #include <stdlib.h>
+#include <string.h>
+
+#if defined(Q_COMPILER_THREAD_LOCAL) && !defined(QT_BOOTSTRAPPED)
+#  define QT_ARRAYDATA_SMALL_BLOCKS
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -78,8 +86,236 @@ static inline size_t calculateBlockSize(size_t &capacity, size_t objectSize, siz
     }
 }
 
+#ifdef QT_ARRAYDATA_SMALL_BLOCKS
+/*
+    Most QArrayData blocks hold short strings and vectors, and for those the
+    heap's per-block overhead is a large part of the memory used. Blocks of
+    up to 64 bytes come from a pool of three size classes instead, carved
+    out of one reserved address range, one third of it per class. The class
+    of a block follows from its address, so the blocks need no header of
+    their own. Each thread caches free blocks and only exchanges them with
+    the shared depot, under a mutex, in batches.
+
+    The pool is off unless QT_ARRAYDATA_POOL is set: it reserves a large
+    address range up front, pages it commits are never given back to the
+    system, and any code that releases array data with free() instead of
+    QArrayData::deallocate() would crash on pooled blocks.
+*/
+namespace {
+enum {
+    SmallBlockClasses = 3,          // 32, 48 and 64 bytes
+    SmallBlockMaxSize = 64,
+    SmallBlockBatch = 32,
+    SmallBlockMaxCached = 4 * SmallBlockBatch,
+    SmallBlockCommitSize = 256 * 1024
+};
+
+#if QT_POINTER_SIZE == 8
+const size_t SmallBlockClassRange = size_t(1) << 30;
+#else
+const size_t SmallBlockClassRange = size_t(16) << 20;
+#endif
+
+struct SmallBlock
+{
+    SmallBlock *next;
+};
+
+struct SmallBlockDepot
+{
+    SmallBlock *free;
+    size_t used;
+    size_t committed;
+};
+
+// Must stay trivially destructible: blocks can still be freed by the
+// destructors of other thread_local objects after the cache was flushed.
+struct SmallBlockCache
+{
+    SmallBlock *free[SmallBlockClasses];
+    int count[SmallBlockClasses];
+    bool registered;
+    bool flushed;
+};
+
+struct SmallBlockCacheFlusher
+{
+    ~SmallBlockCacheFlusher();
+};
+} // unnamed namespace
+
+static QBasicAtomicInteger<quintptr> smallBlockBase = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicAtomicInteger<quintptr> smallBlockRange = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicAtomicInt smallBlocksDisabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+// protected by smallBlockMutex
+static QBasicMutex smallBlockMutex;
+static SmallBlockDepot smallBlockDepots[SmallBlockClasses];
+
+static thread_local SmallBlockCache smallBlockCache;
+
+static inline size_t smallBlockSize(int blockClass)
+{
+    return size_t(blockClass + 2) * 16;
+}
+
+static inline bool isSmallBlock(const void *ptr)
+{
+    const quintptr range = smallBlockRange.loadAcquire();
+    return quintptr(ptr) - smallBlockBase.load() < range;
+}
+
+static inline int smallBlockClass(const void *ptr)
+{
+    return int((quintptr(ptr) - smallBlockBase.load()) / SmallBlockClassRange);
+}
+
+static void registerSmallBlockCache()
+{
+    // constructing it makes the thread flush its cache when it exits
+    static thread_local SmallBlockCacheFlusher flusher;
+    Q_UNUSED(flusher);
+    smallBlockCache.registered = true;
+}
+
+SmallBlockCacheFlusher::~SmallBlockCacheFlusher()
+{
+    SmallBlockCache &cache = smallBlockCache;
+    QMutexLocker locker(&smallBlockMutex);
+    for (int c = 0; c < SmallBlockClasses; ++c) {
+        while (SmallBlock *block = cache.free[c]) {
+            cache.free[c] = block->next;
+            block->next = smallBlockDepots[c].free;
+            smallBlockDepots[c].free = block;
+        }
+        cache.count[c] = 0;
+    }
+    cache.flushed = true;
+}
+
+static bool refillSmallBlockCache(SmallBlockCache &cache, int blockClass)
+{
+    QMutexLocker locker(&smallBlockMutex);
+    if (!smallBlockRange.load()) {
+        if (smallBlocksDisabled.load())
+            return false;
+        void *base = nullptr;
+        if (qEnvironmentVariableIsSet("QT_ARRAYDATA_POOL"))
+            base = QtPrivate::reserveAddressRange(SmallBlockClasses * SmallBlockClassRange);
+        if (!base) {
+            smallBlocksDisabled.store(1);
+            return false;
+        }
+        smallBlockBase.store(quintptr(base));
+        smallBlockRange.storeRelease(SmallBlockClasses * SmallBlockClassRange);
+    }
+
+    SmallBlockDepot &depot = smallBlockDepots[blockClass];
+    int n = 0;
+    while (depot.free && n < SmallBlockBatch) {
+        SmallBlock *block = depot.free;
+        depot.free = block->next;
+        block->next = cache.free[blockClass];
+        cache.free[blockClass] = block;
+        ++n;
+    }
+
+    if (!n) {
+        const size_t blockSize = smallBlockSize(blockClass);
+        const size_t batchSize = blockSize * SmallBlockBatch;
+        char *range = reinterpret_cast<char *>(smallBlockBase.load())
+                + blockClass * SmallBlockClassRange;
+        if (depot.used + batchSize > SmallBlockClassRange)
+            return false;
+        if (depot.used + batchSize > depot.committed) {
+            if (!QtPrivate::commitAddressRange(range + depot.committed, SmallBlockCommitSize))
+                return false;
+            depot.committed += SmallBlockCommitSize;
+        }
+        for (n = 0; n < SmallBlockBatch; ++n) {
+            SmallBlock *block = reinterpret_cast<SmallBlock *>(range + depot.used);
+            depot.used += blockSize;
+            block->next = cache.free[blockClass];
+            cache.free[blockClass] = block;
+        }
+    }
+    cache.count[blockClass] += n;
+    return true;
+}
+
+static void *allocateSmallBlock(size_t size)
+{
+    const int blockClass = size <= 32 ? 0 : int((size - 1) / 16) - 1;
+    SmallBlockCache &cache = smallBlockCache;
+    if (Q_UNLIKELY(!cache.free[blockClass])) {
+        if (cache.flushed || smallBlocksDisabled.load())
+            return nullptr;
+        if (!cache.registered)
+            registerSmallBlockCache();
+        if (!refillSmallBlockCache(cache, blockClass))
+            return nullptr;
+    }
+    SmallBlock *block = cache.free[blockClass];
+    cache.free[blockClass] = block->next;
+    --cache.count[blockClass];
+    return block;
+}
+
+static void freeSmallBlock(void *ptr)
+{
+    const int blockClass = smallBlockClass(ptr);
+    SmallBlock *block = static_cast<SmallBlock *>(ptr);
+    SmallBlockCache &cache = smallBlockCache;
+    if (Q_UNLIKELY(cache.flushed)) {
+        QMutexLocker locker(&smallBlockMutex);
+        block->next = smallBlockDepots[blockClass].free;
+        smallBlockDepots[blockClass].free = block;
+        return;
+    }
+
+    block->next = cache.free[blockClass];
+    cache.free[blockClass] = block;
+    if (Q_LIKELY(++cache.count[blockClass] <= SmallBlockMaxCached))
+        return;
+
+    // give a batch back, so that threads that mostly free don't hoard blocks
+    if (!cache.registered)
+        registerSmallBlockCache();
+    QMutexLocker locker(&smallBlockMutex);
+    SmallBlockDepot &depot = smallBlockDepots[blockClass];
+    for (int n = 0; n < SmallBlockBatch; ++n) {
+        block = cache.free[blockClass];
+        cache.free[blockClass] = block->next;
+        block->next = depot.free;
+        depot.free = block;
+    }
+    cache.count[blockClass] -= SmallBlockBatch;
+}
+#endif // QT_ARRAYDATA_SMALL_BLOCKS
+
+static QArrayData *allocateBlock(size_t allocSize)
+{
+#ifdef QT_ARRAYDATA_SMALL_BLOCKS
+    if (allocSize <= SmallBlockMaxSize) {
+        if (void *block = allocateSmallBlock(allocSize))
+            return static_cast<QArrayData *>(block);
+    }
+#endif
+    return static_cast<QArrayData *>(::malloc(allocSize));
+}
+
 static QArrayData *reallocateData(QArrayData *header, size_t allocSize, uint options)
 {
+#ifdef QT_ARRAYDATA_SMALL_BLOCKS
+    if (isSmallBlock(header)) {
+        QArrayData *block = allocateBlock(allocSize);
+        if (!block)
+            return nullptr;
+        ::memcpy(static_cast<void *>(block), header, qMin(allocSize, smallBlockSize(smallBlockClass(header))));
+        freeSmallBlock(header);
+        header = block;
+    } else
+#endif
     header = static_cast<QArrayData *>(::realloc(header, allocSize));
     if (header)
         header->capacityReserved = bool(options & QArrayData::CapacityReserved);
@@ -93,8 +329,10 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
     Q_ASSERT(alignment >= Q_ALIGNOF(QArrayData)
             && !(alignment & (alignment - 1)));
 
-    // Don't allocate empty headers
-    if (!(options & RawData) && !capacity) {
+    // Don't allocate empty headers, except for a container that opts in to
+    // an arena: its arena header is what records that choice
+    if (!(options & RawData) && !capacity
+            && !((options & ArenaAllocatable) && QMemoryArena::current())) {
 #if !defined(QT_NO_UNSHARABLE_CONTAINERS)
         if (options & Unsharable)
             return const_cast<QArrayData *>(&qt_array_unsharable_empty);
@@ -115,13 +353,28 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
         return 0;
 
     size_t allocSize = calculateBlockSize(capacity, objectSize, headerSize, options);
-    QArrayData *header = static_cast<QArrayData *>(::malloc(allocSize));
+    QArrayData *header = nullptr;
+#if !defined(QT_NO_UNSHARABLE_CONTAINERS)
+    // Arena memory is never shared: it is marked unsharable, so that copies
+    // are deep and the arena can be released without leaving other owners
+    // dangling. Only containers that honor unsharable data ask for it.
+    bool unsharable = options & Unsharable;
+    if (options & ArenaAllocatable) {
+        if (QMemoryArena *arena = QMemoryArena::current()) {
+            header = static_cast<QArrayData *>(arena->allocate(allocSize, Q_ALIGNOF(QArrayData)));
+            if (header)
+                unsharable = true;
+        }
+    }
+#endif
+    if (!header)
+        header = allocateBlock(allocSize);
     if (header) {
         quintptr data = (quintptr(header) + sizeof(QArrayData) + alignment - 1)
                 & ~(alignment - 1);
 
 #if !defined(QT_NO_UNSHARABLE_CONTAINERS)
-        header->ref.atomic.store(bool(!(options & Unsharable)));
+        header->ref.atomic.store(!unsharable);
 #else
         header->ref.atomic.store(1);
 #endif
@@ -140,6 +393,7 @@ QArrayData *QArrayData::reallocateUnaligned(QArrayData *data, size_t objectSize,
     Q_ASSERT(data);
     Q_ASSERT(data->isMutable());
     Q_ASSERT(!data->ref.isShared());
+    Q_ASSERT(!QMemoryArena::owns(data));
 
     size_t headerSize = sizeof(QArrayData);
     size_t allocSize = calculateBlockSize(capacity, objectSize, headerSize, options);
@@ -164,6 +418,14 @@ void QArrayData::deallocate(QArrayData *data, size_t objectSize,
 
     Q_ASSERT_X(data == 0 || !data->ref.isStatic(), "QArrayData::deallocate",
                "Static data cannot be deleted");
+    if (QMemoryArena::owns(data))
+        return;
+#ifdef QT_ARRAYDATA_SMALL_BLOCKS
+    if (isSmallBlock(data)) {
+        freeSmallBlock(data);
+        return;
+    }
+#endif
     ::free(data);
 }
 
@@ -83,6 +83,7 @@ struct Q_CORE_EXPORT QArrayData
 #endif
         RawData             = 0x4,
         Grow                = 0x8,
+        ArenaAllocatable    = 0x10,
 
         Default = 0
     };
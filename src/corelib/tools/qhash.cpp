@@ -59,7 +59,8 @@
 #include <qdatetime.h>
 #include <qbasicatomic.h>
 #include <qendian.h>
-#include <private/qsimd_p.h>
+#include <qmemoryarena.h>
+#include <private/qnumeric_p.h>
 
 #ifndef QT_BOOTSTRAPPED
 #include <qcoreapplication.h>
@@ -89,120 +90,112 @@ QT_BEGIN_NAMESPACE
     (for instance, gcc 4.4 does that even at -O0).
 */
 
-#if QT_COMPILER_SUPPORTS_HERE(SSE4_2)
-static inline bool hasFastCrc32()
+/*
+    When a seed is in use, we hash with a variant of wyhash by Wang Yi (released
+    into the public domain, see https://github.com/wangyi-fudan/wyhash). It reads
+    the input eight bytes at a time and mixes it with 64x64->128-bit multiplies,
+    which are cheap on all 64-bit architectures we support, and it passes the
+    SMHasher distribution tests. Unlike a CRC, it is not linear in the seed, so
+    it is not trivial to find inputs that collide for every seed.
+
+    With a zero seed, which users request to get predictable results, we keep
+    using the simple loop above.
+*/
+static const quint64 hashSecret[4] = {
+    Q_UINT64_C(0xa0761d6478bd642f), Q_UINT64_C(0xe7037ed1a0b428db),
+    Q_UINT64_C(0x8ebc6af09c88c6e3), Q_UINT64_C(0x589965cc75374cc3)
+};
+
+// replaces a and b with the low and high halves of their product
+static inline void hashMultiply(quint64 &a, quint64 &b) Q_DECL_NOTHROW
 {
-    return qCpuHasFeature(SSE4_2);
+#if defined(Q_CC_GNU) && defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 Product;
+    const Product r = Product(a) * b;
+    a = quint64(r);
+    b = quint64(r >> 64);
+#elif defined(Q_INTRINSIC_MUL_OVERFLOW64)
+    const quint64 high = Q_UMULH(a, b);
+    a *= b;
+    b = high;
+#else
+    const quint64 ha = a >> 32, hb = b >> 32, la = quint32(a), lb = quint32(b);
+    const quint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const quint64 t = rl + (rm0 << 32);
+    const quint64 lo = t + (rm1 << 32);
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+    a = lo;
+#endif
 }
 
-template <typename Char>
-QT_FUNCTION_TARGET(SSE4_2)
-static uint crc32(const Char *ptr, size_t len, uint h)
+static inline quint64 hashMix(quint64 a, quint64 b) Q_DECL_NOTHROW
 {
-    // The CRC32 instructions from Nehalem calculate a 32-bit CRC32 checksum
-    const uchar *p = reinterpret_cast<const uchar *>(ptr);
-    const uchar *const e = p + (len * sizeof(Char));
-#  ifdef Q_PROCESSOR_X86_64
-    // The 64-bit instruction still calculates only 32-bit, but without this
-    // variable GCC 4.9 still tries to clear the high bits on every loop
-    qulonglong h2 = h;
-
-    p += 8;
-    for ( ; p <= e; p += 8)
-        h2 = _mm_crc32_u64(h2, qFromUnaligned<qlonglong>(p - 8));
-    h = h2;
-    p -= 8;
-
-    len = e - p;
-    if (len & 4) {
-        h = _mm_crc32_u32(h, qFromUnaligned<uint>(p));
-        p += 4;
-    }
-#  else
-    p += 4;
-    for ( ; p <= e; p += 4)
-        h = _mm_crc32_u32(h, qFromUnaligned<uint>(p - 4));
-    p -= 4;
-    len = e - p;
-#  endif
-    if (len & 2) {
-        h = _mm_crc32_u16(h, qFromUnaligned<ushort>(p));
-        p += 2;
-    }
-    if (sizeof(Char) == 1 && len & 1)
-        h = _mm_crc32_u8(h, *p);
-    return h;
+    hashMultiply(a, b);
+    return a ^ b;
 }
-#elif defined(__ARM_FEATURE_CRC32)
-static inline bool hasFastCrc32()
+
+static inline quint64 hashRead8(const uchar *p) Q_DECL_NOTHROW
 {
-    return qCpuHasFeature(CRC32);
+    return qFromLittleEndian<quint64>(p);
 }
 
-template <typename Char>
-#if defined(Q_PROCESSOR_ARM_64)
-QT_FUNCTION_TARGET(CRC32)
-#endif
-static uint crc32(const Char *ptr, size_t len, uint h)
+static inline quint64 hashRead4(const uchar *p) Q_DECL_NOTHROW
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+static uint wyhash(const uchar *p, size_t len, uint seed32) Q_DECL_NOTHROW
 {
-    // The crc32[whbd] instructions on Aarch64/Aarch32 calculate a 32-bit CRC32 checksum
-    const uchar *p = reinterpret_cast<const uchar *>(ptr);
-    const uchar *const e = p + (len * sizeof(Char));
-
-#ifndef __ARM_FEATURE_UNALIGNED
-    if (Q_UNLIKELY(reinterpret_cast<quintptr>(p) & 7)) {
-        if ((sizeof(Char) == 1) && (reinterpret_cast<quintptr>(p) & 1) && (e - p > 0)) {
-            h = __crc32b(h, *p);
-            ++p;
+    quint64 seed = seed32;
+    seed ^= hashMix(seed ^ hashSecret[0], hashSecret[1]);
+
+    quint64 a, b;
+    if (Q_LIKELY(len <= 16)) {
+        if (Q_LIKELY(len >= 4)) {
+            const size_t offset = (len >> 3) << 2;
+            a = (hashRead4(p) << 32) | hashRead4(p + offset);
+            b = (hashRead4(p + len - 4) << 32) | hashRead4(p + len - 4 - offset);
+        } else if (len > 0) {
+            a = (quint64(p[0]) << 16) | (quint64(p[len >> 1]) << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
         }
-        if ((reinterpret_cast<quintptr>(p) & 2) && (e >= p + 2)) {
-            h = __crc32h(h, *reinterpret_cast<const uint16_t *>(p));
-            p += 2;
+    } else {
+        size_t i = len;
+        if (Q_UNLIKELY(i > 48)) {
+            quint64 see1 = seed, see2 = seed;
+            do {
+                seed = hashMix(hashRead8(p) ^ hashSecret[1], hashRead8(p + 8) ^ seed);
+                see1 = hashMix(hashRead8(p + 16) ^ hashSecret[2], hashRead8(p + 24) ^ see1);
+                see2 = hashMix(hashRead8(p + 32) ^ hashSecret[3], hashRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (Q_LIKELY(i > 48));
+            seed ^= see1 ^ see2;
         }
-        if ((reinterpret_cast<quintptr>(p) & 4) && (e >= p + 4)) {
-            h = __crc32w(h, *reinterpret_cast<const uint32_t *>(p));
-            p += 4;
+        while (Q_UNLIKELY(i > 16)) {
+            seed = hashMix(hashRead8(p) ^ hashSecret[1], hashRead8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
         }
+        a = hashRead8(p + i - 16);
+        b = hashRead8(p + i - 8);
     }
-#endif
-
-    for ( ; p + 8 <= e; p += 8)
-        h = __crc32d(h, *reinterpret_cast<const uint64_t *>(p));
-
-    len = e - p;
-    if (len == 0)
-        return h;
-    if (len & 4) {
-        h = __crc32w(h, *reinterpret_cast<const uint32_t *>(p));
-        p += 4;
-    }
-    if (len & 2) {
-        h = __crc32h(h, *reinterpret_cast<const uint16_t *>(p));
-        p += 2;
-    }
-    if (sizeof(Char) == 1 && len & 1)
-        h = __crc32b(h, *p);
-    return h;
-}
-#else
-static inline bool hasFastCrc32()
-{
-    return false;
-}
 
-static uint crc32(...)
-{
-    Q_UNREACHABLE();
-    return 0;
+    a ^= hashSecret[1];
+    b ^= seed;
+    hashMultiply(a, b);
+    const quint64 h = hashMix(a ^ hashSecret[0] ^ len, b ^ hashSecret[1]);
+    return uint(h ^ (h >> 32));
 }
-#endif
 
 static inline uint hash(const uchar *p, size_t len, uint seed) Q_DECL_NOTHROW
 {
     uint h = seed;
 
-    if (seed && hasFastCrc32())
-        return crc32(p, len, h);
+    if (seed)
+        return wyhash(p, len, seed);
 
     for (size_t i = 0; i < len; ++i)
         h = 31 * h + p[i];
@@ -212,15 +205,15 @@ static inline uint hash(const uchar *p, size_t len, uint seed) Q_DECL_NOTHROW
 
 uint qHashBits(const void *p, size_t len, uint seed) Q_DECL_NOTHROW
 {
-    return hash(static_cast<const uchar*>(p), int(len), seed);
+    return hash(static_cast<const uchar*>(p), len, seed);
 }
 
 static inline uint hash(const QChar *p, size_t len, uint seed) Q_DECL_NOTHROW
 {
     uint h = seed;
 
-    if (seed && hasFastCrc32())
-        return crc32(p, len, h);
+    if (seed)
+        return wyhash(reinterpret_cast<const uchar *>(p), len * sizeof(QChar), seed);
 
     for (size_t i = 0; i < len; ++i)
         h = 31 * h + p[i].unicode();
@@ -471,11 +464,20 @@ static int countBits(int hint)
 const int MinNumBits = 4;
 
 const QHashData QHashData::shared_null = {
-    0, 0, Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, MinNumBits, 0, 0, 0, true, false, 0
+    0, 0, Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, MinNumBits, 0, 0, 0, true, false, false, false, 0
 };
 
 void *QHashData::allocateNode(int nodeAlign)
 {
+    QMemoryArena *arena = arenaAllocatable ? QMemoryArena::current() : nullptr;
+    if (arena) {
+        if (void *ptr = arena->allocate(nodeSize, qMax<size_t>(nodeAlign, 2 * sizeof(void *)))) {
+            // a hash holding arena nodes must never be shared, see QMemoryArena
+            sharable = false;
+            arenaNodes = true;
+            return ptr;
+        }
+    }
     void *ptr = strictAlignment ? qMallocAligned(nodeSize, nodeAlign) : malloc(nodeSize);
     Q_CHECK_PTR(ptr);
     return ptr;
@@ -483,6 +485,8 @@ void *QHashData::allocateNode(int nodeAlign)
 
 void QHashData::freeNode(void *node)
 {
+    if (QMemoryArena::owns(node))
+        return;
     if (strictAlignment)
         qFreeAligned(node);
     else
@@ -512,6 +516,8 @@ QHashData *QHashData::detach_helper(void (*node_duplicate)(Node *, void *),
     d->seed = (this == &shared_null) ? uint(qt_qhash_seed.load()) : seed;
     d->sharable = true;
     d->strictAlignment = nodeAlign > 8;
+    d->arenaAllocatable = false;
+    d->arenaNodes = false;
     d->reserved = 0;
 
     if (numBuckets) {
@@ -531,12 +537,12 @@ QHashData *QHashData::detach_helper(void (*node_duplicate)(Node *, void *),
             Node *oldNode = buckets[i];
             while (oldNode != this_e) {
                 QT_TRY {
-                    Node *dup = static_cast<Node *>(allocateNode(nodeAlign));
+                    Node *dup = static_cast<Node *>(d->allocateNode(nodeAlign));
 
                     QT_TRY {
                         node_duplicate(oldNode, dup);
                     } QT_CATCH(...) {
-                        freeNode( dup );
+                        d->freeNode( dup );
                         QT_RETHROW;
                     }
 
@@ -1409,6 +1415,19 @@ uint qHash(long double key, uint seed) Q_DECL_NOTHROW
     \internal
 */
 
+/*! \fn template <class Key, class T> void QHash<Key, T>::allocateFromArena()
+    \since 5.14
+
+    Makes this hash allocate its nodes from the QMemoryArena that is
+    current in the calling thread whenever it grows, and from the heap when
+    there is none. The hash must be empty.
+
+    Copies of the hash, and the hash itself after clear() or an assignment,
+    allocate from the heap again.
+
+    \sa QMemoryArena
+*/
+
 /*! \fn template <class Key, class T> bool QHash<Key, T>::isSharedWith(const QHash &other) const
 
     \internal
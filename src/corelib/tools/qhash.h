@@ -79,7 +79,9 @@ struct Q_CORE_EXPORT QHashData
     uint seed;
     uint sharable : 1;
     uint strictAlignment : 1;
-    uint reserved : 30;
+    uint arenaAllocatable : 1;
+    uint arenaNodes : 1;
+    uint reserved : 28;
 
     void *allocateNode(int nodeAlign);
     void freeNode(void *node);
@@ -275,8 +277,16 @@ public:
     inline void detach() { if (d->ref.isShared()) detach_helper(); }
     inline bool isDetached() const { return !d->ref.isShared(); }
 #if !defined(QT_NO_UNSHARABLE_CONTAINERS)
-    inline void setSharable(bool sharable) { if (!sharable) detach(); if (d != &QHashData::shared_null) d->sharable = sharable; }
+    inline void setSharable(bool sharable) { if (!sharable) detach(); if (d != &QHashData::shared_null && !d->arenaNodes) d->sharable = sharable; }
 #endif
+    inline void allocateFromArena()
+    {
+        Q_ASSERT_X(isEmpty(), "QHash::allocateFromArena", "Only an empty hash can move to an arena");
+        if (!isEmpty())
+            return;
+        detach();
+        d->arenaAllocatable = true;
+    }
     bool isSharedWith(const QHash &other) const { return d == other.d; }
 
     void clear();
@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qmap.h"
+#include "qmemoryarena.h"
 
 #include <stdlib.h>
 
@@ -290,7 +291,8 @@ void QMapDataBase::freeNodeAndRebalance(QMapNodeBase *z)
     if (x)
         x->setColor(QMapNodeBase::Black);
     }
-    free(y);
+    if (!QMemoryArena::owns(y))
+        free(y);
     --size;
 }
 
@@ -309,8 +311,13 @@ static inline int qMapAlignmentThreshold()
     return 2 * sizeof(void*);
 }
 
-static inline void *qMapAllocate(int alloc, int alignment)
+static inline void *qMapAllocate(int alloc, int alignment, bool arenaAllocatable)
 {
+    QMemoryArena *arena = arenaAllocatable ? QMemoryArena::current() : nullptr;
+    if (arena) {
+        if (void *ptr = arena->allocate(alloc, qMax(alignment, qMapAlignmentThreshold())))
+            return ptr;
+    }
     return alignment > qMapAlignmentThreshold()
         ? qMallocAligned(alloc, alignment)
         : ::malloc(alloc);
@@ -318,6 +325,8 @@ static inline void *qMapAllocate(int alloc, int alignment)
 
 static inline void qMapDeallocate(QMapNodeBase *node, int alignment)
 {
+    if (QMemoryArena::owns(node))
+        return;
     if (alignment > qMapAlignmentThreshold())
         qFreeAligned(node);
     else
@@ -326,12 +335,18 @@ static inline void qMapDeallocate(QMapNodeBase *node, int alignment)
 
 QMapNodeBase *QMapDataBase::createNode(int alloc, int alignment, QMapNodeBase *parent, bool left)
 {
-    QMapNodeBase *node = static_cast<QMapNodeBase *>(qMapAllocate(alloc, alignment));
+    QMapNodeBase *node = static_cast<QMapNodeBase *>(qMapAllocate(alloc, alignment, isArenaAllocatable()));
     Q_CHECK_PTR(node);
 
     memset(node, 0, alloc);
     ++size;
 
+    // a map holding arena nodes must never be shared, see QMemoryArena
+    if (isArenaAllocatable() && QMemoryArena::owns(node)) {
+        ref.setSharable(false);
+        header.p |= ArenaNodes;
+    }
+
     if (parent) {
         if (left) {
             parent->left = node;
@@ -661,6 +676,19 @@ void QMapDataBase::freeData(QMapDataBase *d)
     \internal
 */
 
+/*! \fn template <class Key, class T> void QMap<Key, T>::allocateFromArena()
+    \since 5.14
+
+    Makes this map allocate its nodes from the QMemoryArena that is current
+    in the calling thread whenever it grows, and from the heap when there is
+    none. The map must be empty.
+
+    Copies of the map, and the map itself after clear() or an assignment,
+    allocate from the heap again.
+
+    \sa QMemoryArena
+*/
+
 /*! \fn template <class Key, class T> bool QMap<Key, T>::isSharedWith(const QMap<Key, T> &other) const
 
     \internal
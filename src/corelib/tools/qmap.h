@@ -187,6 +187,12 @@ struct Q_CORE_EXPORT QMapDataBase
     QMapNodeBase header;
     QMapNodeBase *mostLeftNode;
 
+    // The header has neither a parent nor a color, so the bits of header.p
+    // that nodes keep those in record how this map allocates its nodes.
+    enum { ArenaAllocatable = 1, ArenaNodes = 2 };
+    bool isArenaAllocatable() const { return header.p & ArenaAllocatable; }
+    bool hasArenaNodes() const { return header.p & ArenaNodes; }
+
     void rotateLeft(QMapNodeBase *x);
     void rotateRight(QMapNodeBase *x);
     void rebalance(QMapNodeBase *x);
@@ -370,10 +376,20 @@ public:
             return;
         if (!sharable)
             detach();
+        else if (d->hasArenaNodes())
+            return; // arena memory is never shared
         // Don't call on shared_null
         d->ref.setSharable(sharable);
     }
 #endif
+    inline void allocateFromArena()
+    {
+        Q_ASSERT_X(isEmpty(), "QMap::allocateFromArena", "Only an empty map can move to an arena");
+        if (!isEmpty())
+            return;
+        detach();
+        d->header.p |= QMapDataBase::ArenaAllocatable;
+    }
     inline bool isSharedWith(const QMap<Key, T> &other) const { return d == other.d; }
 
     void clear();
@@ -0,0 +1,406 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmemoryarena.h"
+#include "qmemoryarena_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qmutex.h>
+
+#if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
+#  define QT_ARENA_USE_VIRTUALALLOC
+#  include <qt_windows.h>
+#elif defined(Q_OS_UNIX) && !defined(Q_OS_INTEGRITY) && !defined(Q_OS_WASM)
+#  define QT_ARENA_USE_MMAP
+#  include <sys/mman.h>
+#  ifndef MAP_ANONYMOUS
+#    define MAP_ANONYMOUS MAP_ANON
+#  endif
+#  ifndef MAP_NORESERVE
+#    define MAP_NORESERVE 0
+#  endif
+#endif
+
+QT_BEGIN_NAMESPACE
+
+void *QtPrivate::reserveAddressRange(size_t size) Q_DECL_NOTHROW
+{
+#if defined(QT_ARENA_USE_VIRTUALALLOC)
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#elif defined(QT_ARENA_USE_MMAP)
+    void *base = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return base == MAP_FAILED ? nullptr : base;
+#else
+    Q_UNUSED(size);
+    return nullptr;
+#endif
+}
+
+bool QtPrivate::commitAddressRange(void *ptr, size_t size) Q_DECL_NOTHROW
+{
+#if defined(QT_ARENA_USE_VIRTUALALLOC)
+    return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#elif defined(QT_ARENA_USE_MMAP)
+    return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#else
+    Q_UNUSED(ptr);
+    Q_UNUSED(size);
+    return false;
+#endif
+}
+
+void QtPrivate::discardAddressRange(void *ptr, size_t size) Q_DECL_NOTHROW
+{
+#if defined(QT_ARENA_USE_VIRTUALALLOC)
+    VirtualAlloc(ptr, size, MEM_RESET, PAGE_READWRITE);
+#elif defined(QT_ARENA_USE_MMAP) && defined(MADV_DONTNEED)
+    madvise(ptr, size, MADV_DONTNEED);
+#else
+    Q_UNUSED(ptr);
+    Q_UNUSED(size);
+#endif
+}
+
+/*
+    All arenas carve their chunks out of a single address range that is
+    reserved, but not committed, the first time an arena needs memory. This
+    keeps QMemoryArena::owns() down to one subtraction and one comparison, so
+    the container deallocation paths can afford to ask it on every free.
+*/
+enum {
+    ArenaChunkSize = 64 * 1024,
+    ArenaChunkHeaderSize = 64,
+    // larger blocks go to the heap, so that one big vector doesn't waste
+    // most of a chunk
+    ArenaMaxAllocation = ArenaChunkSize / 4,
+    // chunks cached beyond this have their pages handed back to the system
+    ArenaMaxCachedChunks = 64
+};
+
+#if QT_POINTER_SIZE == 8
+static const size_t ArenaRegionSize = size_t(1) << 30;
+#else
+static const size_t ArenaRegionSize = size_t(64) << 20;
+#endif
+
+struct QMemoryArenaChunk
+{
+    QMemoryArenaChunk *next;
+};
+
+static QBasicAtomicPointer<char> arenaRegionBase = Q_BASIC_ATOMIC_INITIALIZER(nullptr);
+static QBasicAtomicInt arenaRegionSize = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+// protected by arenaMutex
+static QBasicMutex arenaMutex;
+static QMemoryArenaChunk *arenaFreeChunks = nullptr;
+static int arenaFreeChunkCount = 0;
+static size_t arenaRegionUsed = 0;
+static bool arenaRegionFailed = false;
+
+static QMemoryArenaChunk *acquireArenaChunk()
+{
+    QMutexLocker locker(&arenaMutex);
+    if (QMemoryArenaChunk *chunk = arenaFreeChunks) {
+        arenaFreeChunks = chunk->next;
+        --arenaFreeChunkCount;
+        return chunk;
+    }
+
+    if (arenaRegionFailed)
+        return nullptr;
+    if (!arenaRegionSize.load()) {
+        void *base = QtPrivate::reserveAddressRange(ArenaRegionSize);
+        if (!base) {
+            arenaRegionFailed = true;
+            return nullptr;
+        }
+        arenaRegionBase.store(static_cast<char *>(base));
+        arenaRegionSize.storeRelease(int(ArenaRegionSize));
+    }
+    if (arenaRegionUsed + ArenaChunkSize > ArenaRegionSize)
+        return nullptr;
+
+    void *chunk = arenaRegionBase.load() + arenaRegionUsed;
+    if (!QtPrivate::commitAddressRange(chunk, ArenaChunkSize))
+        return nullptr;
+    arenaRegionUsed += ArenaChunkSize;
+    return static_cast<QMemoryArenaChunk *>(chunk);
+}
+
+static void releaseArenaChunks(QMemoryArenaChunk *chunks)
+{
+    QMutexLocker locker(&arenaMutex);
+    while (QMemoryArenaChunk *chunk = chunks) {
+        chunks = chunk->next;
+        if (arenaFreeChunkCount >= ArenaMaxCachedChunks)
+            QtPrivate::discardAddressRange(chunk, ArenaChunkSize);
+        chunk->next = arenaFreeChunks;
+        arenaFreeChunks = chunk;
+        ++arenaFreeChunkCount;
+    }
+}
+
+#if defined(Q_COMPILER_THREAD_LOCAL)
+static thread_local QMemoryArena *currentArena = nullptr;
+#endif
+
+/*!
+    \class QMemoryArena
+    \inmodule QtCore
+    \since 5.14
+    \brief The QMemoryArena class provides a monotonic memory resource for
+    QVector, QHash and QMap.
+
+    \ingroup tools
+    \ingroup shared
+
+    A QMemoryArena hands out memory by bumping a pointer through 64 KiB
+    chunks, and gives it all back at once in release() or when it is
+    destroyed. Freeing an individual block is a no-op. This makes it well
+    suited for containers that are built up, used and thrown away together,
+    such as the temporary data structures of one frame or one request.
+
+    Containers do not take an arena as an argument. Instead, a
+    QMemoryArenaScope installs an arena for the current thread, and a
+    QVector, QHash, QMap or QSet (or a container built on top of them, such
+    as QStack) that has opted in by calling allocateFromArena() while it was
+    empty allocates its array or nodes from the current arena whenever it
+    grows:
+
+    \code
+    QMemoryArena arena;
+    {
+        QMemoryArenaScope scope(&arena);
+        QHash<int, QPointF> nearest;
+        nearest.allocateFromArena();
+        for (const QPointF &p : points)
+            nearest.insert(bucketFor(p), p);
+        process(nearest);
+    }
+    arena.release();
+    \endcode
+
+    Containers that have not opted in always use the heap, even while a
+    scope is active, so that long-lived containers that happen to grow
+    inside a scope never end up pointing into released memory. A container
+    that already holds heap memory is never moved to an arena.
+
+    Blocks larger than 16 KiB, and everything allocated when the address
+    range reserved for arenas is exhausted, come from the heap as usual.
+    QString, QByteArray and QList never use an arena.
+
+    Containers keep implicit sharing safe by never sharing arena memory:
+    copying a container that holds arena memory makes a deep copy on the
+    heap. A vector that grows while no arena is current moves to the heap
+    and stays there. setSharable(true) is ignored for containers that hold
+    arena memory.
+
+    The memory handed out by an arena stays valid until release() is called
+    or the arena is destroyed. All containers that hold memory from an arena
+    must have been destroyed, or have let go of that memory, before then.
+
+    QMemoryArena is not thread-safe: an arena must only be used by one thread
+    at a time. Chunks given back by release() are cached and reused by other
+    arenas, in any thread.
+
+    \sa QMemoryArenaScope
+*/
+
+/*!
+    Constructs an empty arena. No memory is reserved until the first
+    allocation.
+*/
+QMemoryArena::QMemoryArena() Q_DECL_NOTHROW
+    : m_chunks(nullptr), m_ptr(nullptr), m_end(nullptr),
+      m_allocated(0), m_reserved(0), m_scopes(0)
+{
+}
+
+/*!
+    Destroys the arena and releases all memory allocated from it.
+
+    The arena must not be installed by any QMemoryArenaScope anymore.
+*/
+QMemoryArena::~QMemoryArena()
+{
+    Q_ASSERT_X(!m_scopes, "QMemoryArena::~QMemoryArena", "Arena destroyed while still in use by a QMemoryArenaScope");
+    release();
+}
+
+/*!
+    Allocates \a size bytes aligned to \a alignment, which must be a power of
+    two, and returns a pointer to them. Returns \nullptr if the block is too
+    large for the arena or no arena memory is available; the caller is
+    expected to fall back to the heap then.
+
+    The block is freed when the arena is released.
+*/
+void *QMemoryArena::allocate(size_t size, size_t alignment) Q_DECL_NOTHROW
+{
+    Q_ASSERT(alignment && !(alignment & (alignment - 1)));
+    if (size + alignment > size_t(ArenaMaxAllocation))
+        return nullptr;
+
+    quintptr p = (quintptr(m_ptr) + alignment - 1) & ~quintptr(alignment - 1);
+    if (!m_ptr || p + size > quintptr(m_end)) {
+        if (!grow())
+            return nullptr;
+        p = (quintptr(m_ptr) + alignment - 1) & ~quintptr(alignment - 1);
+    }
+    m_ptr = reinterpret_cast<char *>(p + size);
+    m_allocated += qsizetype(size);
+    return reinterpret_cast<void *>(p);
+}
+
+bool QMemoryArena::grow() Q_DECL_NOTHROW
+{
+    QMemoryArenaChunk *chunk = acquireArenaChunk();
+    if (!chunk)
+        return false;
+    chunk->next = static_cast<QMemoryArenaChunk *>(m_chunks);
+    m_chunks = chunk;
+    m_ptr = reinterpret_cast<char *>(chunk) + ArenaChunkHeaderSize;
+    m_end = reinterpret_cast<char *>(chunk) + ArenaChunkSize;
+    m_reserved += ArenaChunkSize;
+    return true;
+}
+
+/*!
+    Releases all memory allocated from this arena at once. Any container
+    still holding memory from the arena is left dangling.
+
+    The arena can be used again afterwards.
+*/
+void QMemoryArena::release() Q_DECL_NOTHROW
+{
+    if (m_chunks)
+        releaseArenaChunks(static_cast<QMemoryArenaChunk *>(m_chunks));
+    m_chunks = nullptr;
+    m_ptr = m_end = nullptr;
+    m_allocated = 0;
+    m_reserved = 0;
+}
+
+/*!
+    \fn qsizetype QMemoryArena::bytesAllocated() const
+
+    Returns the number of bytes handed out by allocate() since the arena was
+    created or last released.
+*/
+
+/*!
+    \fn qsizetype QMemoryArena::bytesReserved() const
+
+    Returns the number of bytes in the chunks the arena currently holds.
+*/
+
+/*!
+    Returns the arena installed for the current thread by the innermost
+    QMemoryArenaScope, or \nullptr if there is none.
+*/
+QMemoryArena *QMemoryArena::current() Q_DECL_NOTHROW
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    return currentArena;
+#else
+    return nullptr;
+#endif
+}
+
+/*!
+    Returns \c true if \a ptr points into memory handed out by any
+    QMemoryArena, released or not.
+*/
+bool QMemoryArena::owns(const void *ptr) Q_DECL_NOTHROW
+{
+    const quintptr size = quintptr(arenaRegionSize.loadAcquire());
+    return quintptr(ptr) - quintptr(arenaRegionBase.load()) < size;
+}
+
+/*!
+    \class QMemoryArenaScope
+    \inmodule QtCore
+    \since 5.14
+    \brief The QMemoryArenaScope class makes a QMemoryArena the current arena
+    of a thread for its lifetime.
+
+    \ingroup tools
+
+    While a QMemoryArenaScope exists, containers of the thread that created
+    it that have opted in with allocateFromArena() allocate from its arena. Scopes can be nested; destroying
+    a scope reinstalls the arena that was current before it. Scopes must be
+    destroyed in the reverse order of their creation, and in the thread that
+    created them.
+
+    On compilers without \c thread_local support, scopes have no effect and
+    all containers allocate from the heap.
+
+    \sa QMemoryArena
+*/
+
+/*!
+    Installs \a arena as the current arena of the calling thread. Passing
+    \nullptr makes all containers allocate from the heap until the scope ends.
+*/
+QMemoryArenaScope::QMemoryArenaScope(QMemoryArena *arena) Q_DECL_NOTHROW
+    : m_arena(arena), m_previous(QMemoryArena::current())
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    currentArena = arena;
+#endif
+    if (arena)
+        ++arena->m_scopes;
+}
+
+/*!
+    Reinstalls the arena that was current when this scope was created.
+*/
+QMemoryArenaScope::~QMemoryArenaScope()
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    Q_ASSERT_X(currentArena == m_arena, "QMemoryArenaScope::~QMemoryArenaScope",
+               "Scopes must be destroyed in reverse order");
+    currentArena = m_previous;
+#endif
+    if (m_arena)
+        --m_arena->m_scopes;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMEMORYARENA_H
+#define QMEMORYARENA_H
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class Q_CORE_EXPORT QMemoryArena
+{
+public:
+    QMemoryArena() Q_DECL_NOTHROW;
+    ~QMemoryArena();
+
+    void *allocate(size_t size, size_t alignment = 2 * sizeof(void *)) Q_DECL_NOTHROW;
+    void release() Q_DECL_NOTHROW;
+
+    qsizetype bytesAllocated() const Q_DECL_NOTHROW { return m_allocated; }
+    qsizetype bytesReserved() const Q_DECL_NOTHROW { return m_reserved; }
+
+    static QMemoryArena *current() Q_DECL_NOTHROW;
+    static bool owns(const void *ptr) Q_DECL_NOTHROW;
+
+private:
+    Q_DISABLE_COPY(QMemoryArena)
+    friend class QMemoryArenaScope;
+
+    bool grow() Q_DECL_NOTHROW;
+
+    void *m_chunks;
+    char *m_ptr;
+    char *m_end;
+    qsizetype m_allocated;
+    qsizetype m_reserved;
+    int m_scopes;
+};
+
+class Q_CORE_EXPORT QMemoryArenaScope
+{
+public:
+    explicit QMemoryArenaScope(QMemoryArena *arena) Q_DECL_NOTHROW;
+    ~QMemoryArenaScope();
+
+private:
+    Q_DISABLE_COPY(QMemoryArenaScope)
+
+    QMemoryArena *m_arena;
+    QMemoryArena *m_previous;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMEMORYARENA_H
@@ -330,6 +330,32 @@ qint64 QRingBuffer::peek(char *data, qint64 maxLength, qint64 pos) const
     return readSoFar;
 }
 
+/*!
+    \internal
+
+    Returns up to \a maxLength bytes from position \a pos that are stored
+    contiguously, as a byte array referring to the buffer's memory (see
+    QByteArray::fromRawData()). \a owner is set to share the chunk holding
+    them; while it does, the chunk is neither reused nor released, so the
+    returned data stays valid even if the buffer is freed or refilled.
+*/
+QByteArray QRingBuffer::peekView(qint64 pos, qint64 maxLength, QByteArray *owner) const
+{
+    Q_ASSERT(pos >= 0 && maxLength >= 0);
+
+    for (const QRingChunk &chunk : buffers) {
+        const qint64 length = chunk.size();
+        if (length > pos) {
+            *owner = chunk.storage();
+            return QByteArray::fromRawData(chunk.data() + pos, int(qMin(length - pos, maxLength)));
+        }
+        pos -= length;
+    }
+
+    owner->clear();
+    return QByteArray();
+}
+
 /*!
     \internal
 
@@ -143,6 +143,10 @@ public:
             detach();
         return chunk.data() + headOffset;
     }
+    inline const QByteArray &storage() const
+    {
+        return chunk;
+    }
 
     // array management
     inline void advance(int offset)
@@ -248,6 +252,7 @@ public:
     Q_CORE_EXPORT qint64 read(char *data, qint64 maxLength);
     Q_CORE_EXPORT QByteArray read();
     Q_CORE_EXPORT qint64 peek(char *data, qint64 maxLength, qint64 pos = 0) const;
+    Q_CORE_EXPORT QByteArray peekView(qint64 pos, qint64 maxLength, QByteArray *owner) const;
     Q_CORE_EXPORT void append(const char *data, qint64 size);
     Q_CORE_EXPORT void append(const QByteArray &qba);
 
@@ -88,6 +88,7 @@ public:
 #if !defined(QT_NO_UNSHARABLE_CONTAINERS)
     inline void setSharable(bool sharable) { q_hash.setSharable(sharable); }
 #endif
+    inline void allocateFromArena() { q_hash.allocateFromArena(); }
 
     inline void clear() { q_hash.clear(); }
 
@@ -45,6 +45,7 @@
 #include <QtCore/qrefcount.h>
 #include <QtCore/qarraydata.h>
 #include <QtCore/qhashfunctions.h>
+#include <QtCore/qmemoryarena.h>
 
 #include <iterator>
 #include <vector>
@@ -116,6 +117,8 @@ public:
             return;
         if (!sharable)
             detach();
+        else if (QMemoryArena::owns(d))
+            return; // arena memory is never shared
 
         if (d == Data::unsharableEmpty()) {
             if (sharable)
@@ -127,6 +130,8 @@ public:
     }
 #endif
 
+    void allocateFromArena();
+
     inline bool isSharedWith(const QVector<T> &other) const { return d == other.d; }
 
     inline T *data() { detach(); return d->begin(); }
@@ -303,6 +308,9 @@ public:
     { return std::vector<T>(d->begin(), d->end()); }
 private:
     // ### Qt6: remove methods, they are unused
+    // only vectors that opted in with allocateFromArena() keep their data in an arena
+    QArrayData::AllocationOptions arenaOption() const
+    { return QMemoryArena::owns(d) ? QArrayData::ArenaAllocatable : QArrayData::Default; }
     void reallocData(const int size, const int alloc, QArrayData::AllocationOptions options = QArrayData::Default);
     void reallocData(const int sz) { reallocData(sz, d->alloc); }
     void realloc(int alloc, QArrayData::AllocationOptions options = QArrayData::Default);
@@ -427,6 +435,27 @@ void QVector<T>::resize(int asize)
         defaultConstruct(end(), begin() + asize);
     d->size = asize;
 }
+template <typename T>
+void QVector<T>::allocateFromArena()
+{
+    Q_ASSERT_X(isEmpty(), "QVector::allocateFromArena", "Only an empty vector can move to an arena");
+    if (!isEmpty() || !QMemoryArena::current() || QMemoryArena::owns(d))
+        return;
+    QArrayData::AllocationOptions options = QArrayData::ArenaAllocatable;
+    if (d->capacityReserved)
+        options |= QArrayData::CapacityReserved;
+    Data *x = Data::allocate(d->alloc, options);
+    Q_CHECK_PTR(x);
+    if (!QMemoryArena::owns(x)) {
+        // no arena memory left, stay on the heap
+        Data::deallocate(x);
+        return;
+    }
+    if (!d->ref.deref())
+        Data::deallocate(d);
+    d = x;
+}
+
 template <typename T>
 inline void QVector<T>::clear()
 {
@@ -571,11 +600,12 @@ void QVector<T>::reallocData(const int asize, const int aalloc, QArrayData::Allo
         if (aalloc != int(d->alloc) || isShared) {
             QT_TRY {
                 // allocate memory
-                x = Data::allocate(aalloc, options);
+                x = Data::allocate(aalloc, options | arenaOption());
                 Q_CHECK_PTR(x);
                 // aalloc is bigger then 0 so it is not [un]sharedEmpty
 #if !defined(QT_NO_UNSHARABLE_CONTAINERS)
-                Q_ASSERT(x->ref.isSharable() || options.testFlag(QArrayData::Unsharable));
+                Q_ASSERT(x->ref.isSharable() || options.testFlag(QArrayData::Unsharable)
+                         || QMemoryArena::owns(x));
 #endif
                 Q_ASSERT(!x->ref.isStatic());
                 x->size = asize;
@@ -675,11 +705,12 @@ void QVector<T>::realloc(int aalloc, QArrayData::AllocationOptions options)
 
     QT_TRY {
         // allocate memory
-        x = Data::allocate(aalloc, options);
+        x = Data::allocate(aalloc, options | arenaOption());
         Q_CHECK_PTR(x);
         // aalloc is bigger then 0 so it is not [un]sharedEmpty
 #if !defined(QT_NO_UNSHARABLE_CONTAINERS)
-        Q_ASSERT(x->ref.isSharable() || options.testFlag(QArrayData::Unsharable));
+        Q_ASSERT(x->ref.isSharable() || options.testFlag(QArrayData::Unsharable)
+                 || QMemoryArena::owns(x));
 #endif
         Q_ASSERT(!x->ref.isStatic());
         x->size = d->size;
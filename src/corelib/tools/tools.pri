@@ -36,6 +36,8 @@ HEADERS +=  \
         tools/qlocale_data_p.h \
         tools/qmakearray_p.h \
         tools/qmap.h \
+        tools/qmemoryarena.h \
+        tools/qmemoryarena_p.h \
         tools/qmargins.h \
         tools/qmessageauthenticationcode.h \
         tools/qcontiguouscache.h \
@@ -96,6 +98,7 @@ SOURCES += \
         tools/qlocale_tools.cpp \
         tools/qpoint.cpp \
         tools/qmap.cpp \
+        tools/qmemoryarena.cpp \
         tools/qmargins.cpp \
         tools/qmessageauthenticationcode.cpp \
         tools/qcontiguouscache.cpp \
@@ -59,9 +59,13 @@ qtConfig(ftp) {
 qtConfig(networkdiskcache) {
     HEADERS += \
         access/qnetworkdiskcache_p.h \
-        access/qnetworkdiskcache.h
+        access/qnetworkdiskcache.h \
+        access/qnetworkindexeddiskcache_p.h \
+        access/qnetworkindexeddiskcache.h
 
-    SOURCES += access/qnetworkdiskcache.cpp
+    SOURCES += \
+        access/qnetworkdiskcache.cpp \
+        access/qnetworkindexeddiskcache.cpp
 }
 
 qtConfig(settings) {
@@ -95,8 +95,8 @@ uchar Frame::padding() const
     case FrameType::DATA:
     case FrameType::PUSH_PROMISE:
     case FrameType::HEADERS:
-        Q_ASSERT(buffer.size() > frameHeaderSize);
-        return buffer[frameHeaderSize];
+        Q_ASSERT(bufferedPayloadSize());
+        return *payloadBegin();
     default:
         return 0;
     }
@@ -106,10 +106,10 @@ bool Frame::priority(quint32 *streamID, uchar *weight) const
 {
     Q_ASSERT(validatePayload() == FrameStatus::goodFrame);
 
-    if (buffer.size() <= frameHeaderSize)
+    if (!bufferedPayloadSize())
         return false;
 
-    const uchar *src = &buffer[0] + frameHeaderSize;
+    const uchar *src = payloadBegin();
     if (type() == FrameType::HEADERS && flags().testFlag(FrameFlag::PADDED))
         ++src;
 
@@ -191,9 +191,9 @@ FrameStatus Frame::validatePayload() const
         return FrameStatus::goodFrame;
 
     auto size = payloadSize();
-    Q_ASSERT(buffer.size() >= frameHeaderSize && size == buffer.size() - frameHeaderSize);
+    Q_ASSERT(buffer.size() >= frameHeaderSize && size == bufferedPayloadSize());
 
-    const uchar *src = size ? &buffer[0] + frameHeaderSize : nullptr;
+    const uchar *src = size ? payloadBegin() : nullptr;
     const auto frameFlags = flags();
     switch (type()) {
     // 6.1 DATA, 6.2 HEADERS
@@ -265,10 +265,10 @@ quint32 Frame::hpackBlockSize() const
 const uchar *Frame::dataBegin() const
 {
     Q_ASSERT(validatePayload() == FrameStatus::goodFrame);
-    if (buffer.size() <= frameHeaderSize)
+    if (!bufferedPayloadSize())
         return nullptr;
 
-    const uchar *src = &buffer[0] + frameHeaderSize;
+    const uchar *src = payloadBegin();
     if (padding())
         ++src;
 
@@ -293,6 +293,35 @@ const uchar *Frame::hpackBlockBegin() const
     return begin;
 }
 
+QByteArray Frame::dataPayload() const
+{
+    Q_ASSERT(type() == FrameType::DATA);
+
+    const quint32 size = dataSize();
+    if (!size)
+        return QByteArray();
+
+    if (quint32(dataBuffer.size()) == size)
+        return dataBuffer;
+
+    return QByteArray(reinterpret_cast<const char *>(dataBegin()), int(size));
+}
+
+quint32 Frame::bufferedPayloadSize() const
+{
+    Q_ASSERT(buffer.size() >= frameHeaderSize);
+    return quint32(buffer.size() - frameHeaderSize) + quint32(dataBuffer.size());
+}
+
+const uchar *Frame::payloadBegin() const
+{
+    if (!dataBuffer.isEmpty())
+        return reinterpret_cast<const uchar *>(dataBuffer.constData());
+    if (buffer.size() > frameHeaderSize)
+        return &buffer[0] + frameHeaderSize;
+    return nullptr;
+}
+
 FrameStatus FrameReader::read(QAbstractSocket &socket)
 {
     if (offset < frameHeaderSize) {
@@ -308,10 +337,17 @@ FrameStatus FrameReader::read(QAbstractSocket &socket)
         if (Http2PredefinedParameters::maxFrameSize < frame.payloadSize())
             return FrameStatus::sizeError;
 
-        frame.buffer.resize(frame.payloadSize() + frameHeaderSize);
+        if (frame.type() == FrameType::DATA) {
+            frame.buffer.resize(frameHeaderSize);
+            // A fresh (not shared with any reply) array for this payload:
+            frame.dataBuffer = QByteArray(int(frame.payloadSize()), Qt::Uninitialized);
+        } else {
+            frame.dataBuffer.clear();
+            frame.buffer.resize(frame.payloadSize() + frameHeaderSize);
+        }
     }
 
-    if (offset < frame.buffer.size() && !readPayload(socket))
+    if (offset < frameHeaderSize + frame.payloadSize() && !readPayload(socket))
         return FrameStatus::incompleteFrame;
 
     // Reset the offset, our frame can be re-used
@@ -339,17 +375,21 @@ bool FrameReader::readHeader(QAbstractSocket &socket)
 
 bool FrameReader::readPayload(QAbstractSocket &socket)
 {
-    Q_ASSERT(offset < frame.buffer.size());
-    Q_ASSERT(frame.buffer.size() > frameHeaderSize);
+    const quint32 frameSize = frameHeaderSize + frame.payloadSize();
+    Q_ASSERT(offset < frameSize);
+    Q_ASSERT(frame.bufferedPayloadSize() == frame.payloadSize());
 
-    auto &buffer = frame.buffer;
-    // Casts and ugliness - to deal with MSVC. Values are guaranteed to fit into quint32.
-    const auto chunkSize = socket.read(reinterpret_cast<char *>(&buffer[offset]),
-                                       qint64(buffer.size() - offset));
+    char *dst = nullptr;
+    if (frame.dataBuffer.size())
+        dst = frame.dataBuffer.data() + (offset - frameHeaderSize);
+    else
+        dst = reinterpret_cast<char *>(&frame.buffer[offset]);
+
+    const auto chunkSize = socket.read(dst, qint64(frameSize - offset));
     if (chunkSize > 0)
         offset += quint32(chunkSize);
 
-    return offset == buffer.size();
+    return offset == frameSize;
 }
 
 FrameWriter::FrameWriter()
@@ -372,6 +412,7 @@ void FrameWriter::start(FrameType type, FrameFlags flags, quint32 streamID)
     auto &buffer = frame.buffer;
 
     buffer.resize(frameHeaderSize);
+    frame.dataBuffer.clear();
     // The first three bytes - payload size, which is 0 for now.
     buffer[0] = 0;
     buffer[1] = 0;
@@ -54,6 +54,7 @@
 #include "http2protocol_p.h"
 #include "hpack_p.h"
 
+#include <QtCore/qbytearray.h>
 #include <QtCore/qendian.h>
 #include <QtCore/qglobal.h>
 
@@ -94,8 +95,18 @@ struct Q_AUTOTEST_EXPORT Frame
     const uchar *dataBegin() const;
     // HEADERS data beginning for HEADERS, PUSH_PROMISE and CONTINUATION streams:
     const uchar *hpackBlockBegin() const;
+    // DATA frame's payload without padding. Shares (not copies) 'dataBuffer'
+    // unless the frame is padded:
+    QByteArray dataPayload() const;
+
+    // Payload bytes we have, either in 'buffer' or in 'dataBuffer':
+    quint32 bufferedPayloadSize() const;
+    const uchar *payloadBegin() const;
 
     std::vector<uchar> buffer;
+    // FrameReader reads the payload of DATA frames here and not in 'buffer',
+    // so that it can be passed to a reply without copying it:
+    QByteArray dataBuffer;
 };
 
 class Q_AUTOTEST_EXPORT FrameReader
@@ -173,6 +173,14 @@ struct Q_AUTOTEST_EXPORT ProtocolParameters
     // 64 KB to the possible maximum. Let's use a half of it:
     qint32 maxSessionReceiveWindowSize = Http2::maxSessionReceiveWindowSize / 2;
 
+    // Receive window auto-tuning. If enabled, our streams start with the
+    // SETTINGS_INITIAL_WINDOW_SIZE window (see below) and the window grows,
+    // up to maxSessionReceiveWindowSize, when it limits the throughput. To
+    // find out if it does, we estimate the bandwidth-delay product: the bytes
+    // our peer sends us between our PING and its ACK. This allows to announce
+    // small initial windows without slowing down fast or distant peers.
+    bool autoTuneReceiveWindows = false;
+
     // This is our default SETTINGS frame:
     //
     // SETTINGS_INITIAL_WINDOW_SIZE: (2^31 - 1) / 100
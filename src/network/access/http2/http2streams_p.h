@@ -102,6 +102,10 @@ struct Q_AUTOTEST_EXPORT Stream
     // Signed as window sizes can become negative:
     qint32 sendWindow = 65535;
     qint32 recvWindow = 65535;
+    // Receive window auto-tuning: bytes received since
+    // the handler's PING with the given payload:
+    quint64 bdpPingData = 0;
+    qint64 bdpBytesReceived = 0;
 
     StreamState state = idle;
     QString key; // for PUSH_PROMISE
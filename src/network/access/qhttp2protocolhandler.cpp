@@ -151,6 +151,13 @@ QUrl urlkey_from_request(const QHttpNetworkRequest &request)
     return url;
 }
 
+bool is_preconnect(const QHttpNetworkRequest &request)
+{
+    const QString scheme(request.url().scheme());
+    return scheme == QLatin1String("preconnect-http")
+           || scheme == QLatin1String("preconnect-https");
+}
+
 bool sum_will_overflow(qint32 windowSize, qint32 delta)
 {
     if (windowSize > 0)
@@ -178,6 +185,7 @@ QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *chan
     Q_ASSERT(params.validate());
 
     maxSessionReceiveWindowSize = params.maxSessionReceiveWindowSize;
+    autoTuneReceiveWindows = params.autoTuneReceiveWindows;
 
     const RawSettings &data = params.settingsFrameData;
     for (auto param = data.cbegin(), end = data.cend(); param != end; ++param) {
@@ -199,6 +207,8 @@ QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *chan
         }
     }
 
+    streamReceiveWindowSize = streamInitialReceiveWindowSize;
+
     if (!channel->ssl && m_connection->connectionType() != QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
         // We upgraded from HTTP/1.1 to HTTP/2. channel->request was already sent
         // as HTTP/1.1 request. The response with status code 101 triggered
@@ -346,31 +356,29 @@ bool QHttp2ProtocolHandler::sendRequest()
         return false;
     }
 
-    // Process 'fake' (created by QNetworkAccessManager::connectToHostEncrypted())
-    // requests first:
     auto &requests = m_channel->spdyRequestsToSend;
-    for (auto it = requests.begin(), endIt = requests.end(); it != endIt;) {
-        const auto &pair = *it;
-        const QString scheme(pair.first.url().scheme());
-        if (scheme == QLatin1String("preconnect-http")
-            || scheme == QLatin1String("preconnect-https")) {
+    if (!prefaceSent) {
+        // Process 'fake' (created by QNetworkAccessManager::connectToHostEncrypted())
+        // requests first:
+        const auto preconnects = requests.takeIf([](const HttpMessagePair &message) {
+            return is_preconnect(message.first);
+        });
+        for (const auto &pair : preconnects) {
             m_connection->preConnectFinished();
             emit pair.second->finished();
-            it = requests.erase(it);
-            if (!requests.size()) {
-                // Normally, after a connection was established and H2
-                // was negotiated, we send a client preface. connectToHostEncrypted
-                // though is not meant to send any data, it's just a 'preconnect'.
-                // Thus we return early:
-                return true;
-            }
-        } else {
-            ++it;
         }
-    }
 
-    if (!prefaceSent && !sendClientPreface())
-        return false;
+        if (preconnects.size() && !requests.size()) {
+            // Normally, after a connection was established and H2
+            // was negotiated, we send a client preface. connectToHostEncrypted
+            // though is not meant to send any data, it's just a 'preconnect'.
+            // Thus we return early:
+            return true;
+        }
+
+        if (!sendClientPreface())
+            return false;
+    }
 
     if (!requests.size())
         return true;
@@ -378,31 +386,39 @@ bool QHttp2ProtocolHandler::sendRequest()
     m_channel->state = QHttpNetworkConnectionChannel::WritingState;
     // Check what was promised/pushed, maybe we do not have to send a request
     // and have a response already?
+    if (!promisedData.isEmpty()) {
+        QStringList keys;
+        const auto pushed = requests.takeIf([this, &keys](const HttpMessagePair &message) {
+            const auto key = urlkey_from_request(message.first).toString();
+            if (!promisedData.contains(key) || keys.contains(key))
+                return false;
+            keys.append(key);
+            return true;
+        });
+        // Woo-hoo, we do not have to ask, the answer is ready for us:
+        for (int i = 0; i < pushed.size(); ++i)
+            initReplyFromPushPromise(pushed.at(i), keys.at(i));
+    }
 
-    for (auto it = requests.begin(), endIt = requests.end(); it != endIt;) {
-        const auto key = urlkey_from_request(it->first).toString();
-        if (!promisedData.contains(key)) {
-            ++it;
+    // Requests are queued by priority, taking the next one is O(1), no matter
+    // how many of them are waiting for a free stream:
+    while (requests.size() && quint32(activeStreams.size()) < maxConcurrentStreams) {
+        if (is_preconnect(requests.head().first)) {
+            // Does not need a stream:
+            const HttpMessagePair pair = requests.dequeue();
+            m_connection->preConnectFinished();
+            emit pair.second->finished();
             continue;
         }
-        // Woo-hoo, we do not have to ask, the answer is ready for us:
-        HttpMessagePair message = *it;
-        it = requests.erase(it);
-        initReplyFromPushPromise(message, key);
-    }
 
-    const auto streamsToUse = std::min<quint32>(maxConcurrentStreams - activeStreams.size(),
-                                                requests.size());
-    auto it = requests.begin();
-    for (quint32 i = 0; i < streamsToUse; ++i) {
-        const qint32 newStreamID = createNewStream(*it);
+        const qint32 newStreamID = createNewStream(requests.head());
         if (!newStreamID) {
             // TODO: actually we have to open a new connection.
             qCCritical(QT_HTTP2, "sendRequest: out of stream IDs");
             break;
         }
 
-        it = requests.erase(it);
+        requests.dequeue();
 
         Stream &newStream = activeStreams[newStreamID];
         if (!sendHEADERS(newStream)) {
@@ -573,6 +589,15 @@ bool QHttp2ProtocolHandler::sendWINDOW_UPDATE(quint32 streamID, quint32 delta)
     return frameWriter.write(*m_socket);
 }
 
+bool QHttp2ProtocolHandler::sendPING(quint64 opaqueData)
+{
+    Q_ASSERT(m_socket);
+
+    frameWriter.start(FrameType::PING, FrameFlag::EMPTY, connectionStreamID);
+    frameWriter.append(opaqueData);
+    return frameWriter.write(*m_socket);
+}
+
 bool QHttp2ProtocolHandler::sendRST_STREAM(quint32 streamID, quint32 errorCode)
 {
     Q_ASSERT(m_socket);
@@ -619,17 +644,19 @@ void QHttp2ProtocolHandler::handleDATA()
             deleteActiveStream(streamID);
         } else {
             stream.recvWindow -= inboundFrame.payloadSize();
+            if (autoTuneReceiveWindows)
+                sampleBandwidthDelayProduct(stream, inboundFrame.payloadSize());
             // Uncompress data if needed and append it ...
             updateStream(stream, inboundFrame);
 
             if (inboundFrame.flags().testFlag(FrameFlag::END_STREAM)) {
                 finishStream(stream);
                 deleteActiveStream(stream.streamID);
-            } else if (stream.recvWindow < streamInitialReceiveWindowSize / 2) {
+            } else if (stream.recvWindow < streamReceiveWindowSize / 2) {
                 QMetaObject::invokeMethod(this, "sendWINDOW_UPDATE", Qt::QueuedConnection,
                                           Q_ARG(quint32, stream.streamID),
-                                          Q_ARG(quint32, streamInitialReceiveWindowSize - stream.recvWindow));
-                stream.recvWindow = streamInitialReceiveWindowSize;
+                                          Q_ARG(quint32, streamReceiveWindowSize - stream.recvWindow));
+                stream.recvWindow = streamReceiveWindowSize;
             }
         }
     }
@@ -827,11 +854,16 @@ void QHttp2ProtocolHandler::handlePING()
     if (inboundFrame.streamID() != connectionStreamID)
         return connectionError(PROTOCOL_ERROR, "PING on invalid stream");
 
-    if (inboundFrame.flags() & FrameFlag::ACK)
-        return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
-
     Q_ASSERT(inboundFrame.dataSize() == 8);
 
+    if (inboundFrame.flags() & FrameFlag::ACK) {
+        // The only PING we ever send is the one estimating the BDP.
+        if (!bdpPingSent || qFromBigEndian<quint64>(inboundFrame.dataBegin()) != bdpPingData)
+            return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
+        bdpPingSent = false;
+        return growStreamReceiveWindow();
+    }
+
     frameWriter.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
     frameWriter.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + 8);
     frameWriter.write(*m_socket);
@@ -1036,6 +1068,57 @@ void QHttp2ProtocolHandler::handleContinuedHEADERS()
     }
 }
 
+void QHttp2ProtocolHandler::sampleBandwidthDelayProduct(Stream &stream, quint32 bytesReceived)
+{
+    Q_ASSERT(autoTuneReceiveWindows);
+
+    if (bdpPingSent) {
+        if (stream.bdpPingData != bdpPingData) {
+            stream.bdpPingData = bdpPingData;
+            stream.bdpBytesReceived = 0;
+        }
+        stream.bdpBytesReceived += bytesReceived;
+        bdpBytesReceived = std::max(bdpBytesReceived, stream.bdpBytesReceived);
+        return;
+    }
+
+    // The window cannot grow any more, no need to measure:
+    if (streamReceiveWindowSize >= maxSessionReceiveWindowSize)
+        return;
+
+    // Our peer is sending us data, so the bytes we receive until its PING ACK
+    // arrives are (roughly) what it can send within a round-trip:
+    if (sendPING(++bdpPingData)) {
+        bdpPingSent = true;
+        bdpBytesReceived = 0;
+    }
+}
+
+void QHttp2ProtocolHandler::growStreamReceiveWindow()
+{
+    Q_ASSERT(autoTuneReceiveWindows);
+
+    // As we top up a stream's window only after a half of it was consumed
+    // (see handleDATA), a stream limited by its window receives between a half
+    // and a full window per round-trip. If none of our streams came close to
+    // that, it's not the window that limits the throughput:
+    if (bdpBytesReceived * 8 < qint64(streamReceiveWindowSize) * 3)
+        return;
+
+    streamReceiveWindowSize = qint32(std::min(qint64(streamReceiveWindowSize) * 2,
+                                              qint64(maxSessionReceiveWindowSize)));
+    qCDebug(QT_HTTP2) << "stream receive window grows to" << streamReceiveWindowSize;
+
+    // Let the streams we're receiving on use the new window immediately:
+    for (auto &stream : activeStreams) {
+        if ((stream.state == Stream::open || stream.state == Stream::halfClosedLocal)
+            && stream.recvWindow < streamReceiveWindowSize) {
+            sendWINDOW_UPDATE(stream.streamID, quint32(streamReceiveWindowSize - stream.recvWindow));
+            stream.recvWindow = streamReceiveWindowSize;
+        }
+    }
+}
+
 bool QHttp2ProtocolHandler::acceptSetting(Http2::Settings identifier, quint32 newValue)
 {
     if (identifier == Settings::HEADER_TABLE_SIZE_ID) {
@@ -1205,13 +1288,14 @@ void QHttp2ProtocolHandler::updateStream(Stream &stream, const Frame &frame,
     }
 
     if (const auto length = frame.dataSize()) {
-        const char *data = reinterpret_cast<const char *>(frame.dataBegin());
         auto &httpRequest = stream.request();
         auto replyPrivate = httpReply->d_func();
 
         replyPrivate->totalProgress += length;
 
-        const QByteArray wrapped(data, length);
+        // Normally shares the frame's payload, so the data is not copied on its
+        // way to the reply's buffer:
+        const QByteArray wrapped(frame.dataPayload());
         if (httpRequest.d->autoDecompress && replyPrivate->isCompressed()) {
             QByteDataBuffer inDataBuffer;
             inDataBuffer.append(wrapped);
@@ -108,6 +108,7 @@ private:
     bool sendHEADERS(Stream &stream);
     bool sendDATA(Stream &stream);
     Q_INVOKABLE bool sendWINDOW_UPDATE(quint32 streamID, quint32 delta);
+    bool sendPING(quint64 opaqueData);
     bool sendRST_STREAM(quint32 streamID, quint32 errorCoder);
     bool sendGOAWAY(quint32 errorCode);
 
@@ -125,6 +126,9 @@ private:
     void handleContinuedHEADERS();
 
     bool acceptSetting(Http2::Settings identifier, quint32 newValue);
+    // Receive window auto-tuning:
+    void sampleBandwidthDelayProduct(Stream &stream, quint32 bytesReceived);
+    void growStreamReceiveWindow();
 
     void updateStream(Stream &stream, const HPack::HttpHeader &headers,
                       Qt::ConnectionType connectionType = Qt::DirectConnection);
@@ -195,6 +199,16 @@ private:
     // Our per-stream receive window size, default is 64 Kb, will be updated
     // from QNAM's Http2::ProtocolParameters. Again, signed - can become negative.
     qint32 streamInitialReceiveWindowSize = Http2::defaultSessionWindowSize;
+    // The window we keep our streams' receive windows at. Equals
+    // streamInitialReceiveWindowSize, unless auto-tuning (see
+    // Http2::ProtocolParameters) makes it bigger.
+    qint32 streamReceiveWindowSize = Http2::defaultSessionWindowSize;
+    bool autoTuneReceiveWindows = false;
+    // The bandwidth-delay product estimation: the most bytes a single stream
+    // has received since our last PING (if it was not ACKed yet).
+    bool bdpPingSent = false;
+    quint64 bdpPingData = 0;
+    qint64 bdpBytesReceived = 0;
 
     // These are our peer's receive window sizes, they will be updated by the
     // peer's SETTINGS and WINDOW_UPDATE frames.
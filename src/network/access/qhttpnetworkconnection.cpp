@@ -104,14 +104,21 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 connectionC
                                                              quint16 port, bool encrypt,
                                                              QHttpNetworkConnection::ConnectionType type)
 : state(RunningState), networkLayerState(Unknown),
-  hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  activeChannelCount(connectionCount), channelCount(connectionCount)
+  hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true)
+  , activeChannelCount(type == QHttpNetworkConnection::ConnectionTypeHTTP2
+                       || type == QHttpNetworkConnection::ConnectionTypeHTTP2Direct
+#ifndef QT_NO_SSL
+                       || type == QHttpNetworkConnection::ConnectionTypeSPDY
+#endif
+                       ? 1 : connectionCount)
+  , channelCount(connectionCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
   , preConnectRequests(0)
   , connectionType(type)
 {
+    Q_ASSERT(channelCount >= activeChannelCount);
     channels = new QHttpNetworkConnectionChannel[channelCount];
 }
 
@@ -628,6 +635,8 @@ QHttpNetworkReply* QHttpNetworkConnectionPrivate::queueRequest(const QHttpNetwor
 
     if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP
         || (!encrypt && connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2 && !channels[0].switchedToHttp2)) {
+        reply->d_func()->queueDepth = highPriorityQueue.size() + lowPriorityQueue.size();
+        reply->d_func()->queueTimer.start();
         switch (request.priority()) {
         case QHttpNetworkRequest::HighPriority:
             highPriorityQueue.prepend(pair);
@@ -641,7 +650,7 @@ QHttpNetworkReply* QHttpNetworkConnectionPrivate::queueRequest(const QHttpNetwor
     else { // SPDY, HTTP/2 ('h2' mode)
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
-        channels[0].spdyRequestsToSend.insert(request.priority(), pair);
+        channels[0].spdyRequestsToSend.enqueue(pair);
     }
 
 #ifndef Q_OS_WINRT
@@ -677,7 +686,7 @@ void QHttpNetworkConnectionPrivate::fillHttp2Queue()
     for (auto &pair : highPriorityQueue) {
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
-        channels[0].spdyRequestsToSend.insert(QHttpNetworkRequest::HighPriority, pair);
+        channels[0].spdyRequestsToSend.enqueue(pair);
     }
 
     highPriorityQueue.clear();
@@ -685,7 +694,7 @@ void QHttpNetworkConnectionPrivate::fillHttp2Queue()
     for (auto &pair : lowPriorityQueue) {
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
-        channels[0].spdyRequestsToSend.insert(pair.first.priority(), pair);
+        channels[0].spdyRequestsToSend.enqueue(pair);
     }
 
     lowPriorityQueue.clear();
@@ -742,6 +751,7 @@ void QHttpNetworkConnectionPrivate::updateChannel(int i, const HttpMessagePair &
     // Now that reply is assigned a channel, correct reply to channel association
     // previously set in queueRequest.
     channels[i].reply->d_func()->connectionChannel = &channels[i];
+    channels[i].trackAssignedReply(channels[i].reply);
 }
 
 QHttpNetworkRequest QHttpNetworkConnectionPrivate::predictNextRequest() const
@@ -982,15 +992,9 @@ void QHttpNetworkConnectionPrivate::removeReply(QHttpNetworkReply *reply)
         }
 #ifndef QT_NO_SSL
         // is the reply inside the SPDY pipeline of this channel already?
-        QMultiMap<int, HttpMessagePair>::iterator it = channels[i].spdyRequestsToSend.begin();
-        QMultiMap<int, HttpMessagePair>::iterator end = channels[i].spdyRequestsToSend.end();
-        for (; it != end; ++it) {
-            if (it.value().second == reply) {
-                channels[i].spdyRequestsToSend.remove(it.key());
-
-                QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
-                return;
-            }
+        if (channels[i].spdyRequestsToSend.removeOne(reply)) {
+            QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
+            return;
         }
 #endif
     }
@@ -1234,7 +1238,8 @@ void QHttpNetworkConnectionPrivate::_q_hostLookupFinished(const QHostInfo &info)
         } else if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY
                    || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
                    || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
-            for (const HttpMessagePair &spdyPair : qAsConst(channels[0].spdyRequestsToSend)) {
+            const QList<HttpMessagePair> spdyPairs = channels[0].spdyRequestsToSend.values();
+            for (const HttpMessagePair &spdyPair : spdyPairs) {
                 // emit error for all replies
                 QHttpNetworkReply *currentReply = spdyPair.second;
                 Q_ASSERT(currentReply);
@@ -1552,7 +1557,7 @@ void QHttpNetworkConnectionPrivate::emitProxyAuthenticationRequired(const QHttpN
         // but that does not matter because the signal will ultimately be emitted
         // by the QNetworkAccessManager.
         Q_ASSERT(chan->spdyRequestsToSend.count() > 0);
-        reply = chan->spdyRequestsToSend.cbegin().value().second;
+        reply = chan->spdyRequestsToSend.head().second;
     } else { // HTTP
         reply = chan->reply;
     }
@@ -94,6 +94,7 @@ QHttpNetworkConnectionChannel::QHttpNetworkConnectionChannel()
     , lastStatus(0)
     , pendingEncrypt(false)
     , reconnectAttempts(reconnectAttemptsDefault)
+    , requestsOnConnection(0)
     , authMethod(QAuthenticatorPrivate::None)
     , proxyAuthMethod(QAuthenticatorPrivate::None)
     , authenticationCredentialsSent(false)
@@ -749,6 +750,7 @@ void QHttpNetworkConnectionChannel::pipelineInto(HttpMessagePair &pair)
     reply->d_func()->connectionChannel = this;
     reply->d_func()->autoDecompress = request.d->autoDecompress;
     reply->d_func()->pipeliningUsed = true;
+    trackAssignedReply(reply);
 
 #ifndef QT_NO_NETWORKPROXY
     pipeline.append(QHttpNetworkRequestPrivate::header(request,
@@ -762,6 +764,15 @@ void QHttpNetworkConnectionChannel::pipelineInto(HttpMessagePair &pair)
     // pipelineFlush() needs to be called at some point afterwards
 }
 
+// records on the reply whether it reuses this connection and how long it was queued
+void QHttpNetworkConnectionChannel::trackAssignedReply(QHttpNetworkReply *reply)
+{
+    QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+    replyPrivate->connectionReused = requestsOnConnection++ > 0;
+    if (replyPrivate->queueTimer.isValid())
+        replyPrivate->connectionWaitTime = replyPrivate->queueTimer.elapsed();
+}
+
 void QHttpNetworkConnectionChannel::pipelineFlush()
 {
     if (pipeline.isEmpty())
@@ -901,6 +912,7 @@ void QHttpNetworkConnectionChannel::_q_connected()
     socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
 
     pipeliningSupported = QHttpNetworkConnectionChannel::PipeliningSupportUnknown;
+    requestsOnConnection = 0;
 
     // ### FIXME: if the server closes the connection unexpectedly, we shouldn't send the same broken request again!
     //channels[i].reconnectAttempts = 2;
@@ -76,6 +76,7 @@
 #   include <QtNetwork/qtcpsocket.h>
 #endif
 
+#include <QtCore/qqueue.h>
 #include <QtCore/qscopedpointer.h>
 
 QT_REQUIRE_CONFIG(http);
@@ -90,6 +91,102 @@ class QByteArray;
 typedef QPair<QHttpNetworkRequest, QHttpNetworkReply*> HttpMessagePair;
 #endif
 
+// Requests waiting for a multiplexed (SPDY or HTTP/2) connection. There is
+// one FIFO queue per priority, so queueing a request and taking the next one
+// are constant time operations and requests of the same priority are sent in
+// the order they were queued.
+class QHttpMultiplexedRequestQueue
+{
+public:
+    void enqueue(const HttpMessagePair &pair)
+    {
+        queues[pair.first.priority()].enqueue(pair);
+        ++total;
+    }
+
+    // The request with the highest priority, the queue must not be empty.
+    const HttpMessagePair &head() const
+    {
+        Q_ASSERT(total);
+        return queues[firstNonEmpty()].head();
+    }
+
+    HttpMessagePair dequeue()
+    {
+        Q_ASSERT(total);
+        --total;
+        return queues[firstNonEmpty()].dequeue();
+    }
+
+    bool removeOne(const QHttpNetworkReply *reply)
+    {
+        for (auto &queue : queues) {
+            for (auto it = queue.begin(), end = queue.end(); it != end; ++it) {
+                if (it->second == reply) {
+                    queue.erase(it);
+                    --total;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Removes the requests 'predicate' returns true for and returns them,
+    // in priority order:
+    template <typename Predicate>
+    QList<HttpMessagePair> takeIf(Predicate predicate)
+    {
+        QList<HttpMessagePair> taken;
+        for (auto &queue : queues) {
+            for (auto it = queue.begin(); it != queue.end();) {
+                if (predicate(*it)) {
+                    taken.append(*it);
+                    it = queue.erase(it);
+                    --total;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return taken;
+    }
+
+    // All requests, in priority order:
+    QList<HttpMessagePair> values() const
+    {
+        QList<HttpMessagePair> all;
+        all.reserve(total);
+        for (const auto &queue : queues)
+            all += queue;
+        return all;
+    }
+
+    int size() const { return total; }
+    int count() const { return total; }
+    bool isEmpty() const { return !total; }
+
+    void clear()
+    {
+        for (auto &queue : queues)
+            queue.clear();
+        total = 0;
+    }
+
+private:
+    int firstNonEmpty() const
+    {
+        int i = QHttpNetworkRequest::HighPriority;
+        while (queues[i].isEmpty())
+            ++i;
+        return i;
+    }
+
+    // One queue per priority: High, Normal, Low.
+    QQueue<HttpMessagePair> queues[3];
+    int total = 0;
+};
+
 class QHttpNetworkConnectionChannel : public QObject {
     Q_OBJECT
 public:
@@ -116,6 +213,7 @@ public:
     int lastStatus; // last status received on this channel
     bool pendingEncrypt; // for https (send after encrypted)
     int reconnectAttempts; // maximum 2 reconnection attempts
+    int requestsOnConnection; // requests assigned since the socket connected
     QAuthenticatorPrivate::Method authMethod;
     QAuthenticatorPrivate::Method proxyAuthMethod;
     QAuthenticator authenticator;
@@ -125,8 +223,8 @@ public:
     QScopedPointer<QAbstractProtocolHandler> protocolHandler;
     // SPDY or HTTP/2 requests; SPDY is TLS-only, but
     // HTTP/2 can be cleartext also, that's why it's
-    // outside of QT_NO_SSL section. Sorted by priority:
-    QMultiMap<int, HttpMessagePair> spdyRequestsToSend;
+    // outside of QT_NO_SSL section. Queued by priority:
+    QHttpMultiplexedRequestQueue spdyRequestsToSend;
     bool switchedToHttp2 = false;
 #ifndef QT_NO_SSL
     bool ignoreAllSslErrors;
@@ -153,6 +251,7 @@ public:
     QList<HttpMessagePair> alreadyPipelinedRequests;
     QByteArray pipeline; // temporary buffer that gets sent to socket in pipelineFlush
     void pipelineInto(HttpMessagePair &pair);
+    void trackAssignedReply(QHttpNetworkReply *reply);
     void pipelineFlush();
     void requeueCurrentlyPipelinedRequests();
     void detectPipeliningSupport();
@@ -297,6 +297,21 @@ void QHttpNetworkReply::setSpdyWasUsed(bool spdy)
     d_func()->spdyUsed = spdy;
 }
 
+bool QHttpNetworkReply::isConnectionReused() const
+{
+    return d_func()->connectionReused;
+}
+
+qint64 QHttpNetworkReply::connectionWaitTime() const
+{
+    return d_func()->connectionWaitTime;
+}
+
+int QHttpNetworkReply::queueDepth() const
+{
+    return d_func()->queueDepth;
+}
+
 qint64 QHttpNetworkReply::removedContentLength() const
 {
     return d_func()->removedContentLength;
@@ -333,6 +348,7 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
       connection(0),
       autoDecompress(false), responseData(), requestIsPrepared(false)
       ,pipeliningUsed(false), spdyUsed(false), downstreamLimited(false)
+      ,connectionReused(false), queueDepth(0), connectionWaitTime(0)
       ,userProvidedDownloadBuffer(0)
 #ifndef QT_NO_COMPRESS
       ,inflateStrm(0)
@@ -67,6 +67,7 @@ struct z_stream_s;
 #include <QtNetwork/qnetworkrequest.h>
 #include <QtNetwork/qnetworkreply.h>
 #include <qbuffer.h>
+#include <qelapsedtimer.h>
 
 #include <private/qobject_p.h>
 #include <private/qhttpnetworkheader_p.h>
@@ -139,6 +140,9 @@ public:
     bool isPipeliningUsed() const;
     bool isSpdyUsed() const;
     void setSpdyWasUsed(bool spdy);
+    bool isConnectionReused() const;
+    qint64 connectionWaitTime() const;
+    int queueDepth() const;
     qint64 removedContentLength() const;
 
     bool isRedirecting() const;
@@ -270,6 +274,12 @@ public:
     bool spdyUsed;
     bool downstreamLimited;
 
+    // how the request got its channel; HTTP/1.1 only
+    bool connectionReused;
+    int queueDepth;
+    qint64 connectionWaitTime;
+    QElapsedTimer queueTimer;
+
     char* userProvidedDownloadBuffer;
     QUrl redirectUrl;
 
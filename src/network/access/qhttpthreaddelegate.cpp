@@ -182,21 +182,29 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
     // Q_OBJECT
 public:
 #ifdef QT_NO_BEARERMANAGEMENT
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 connectionCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+        : QHttpNetworkConnection(connectionCount, hostName, port, encrypt, /*parent=*/0,
+                                 connectionType)
 #else
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 connectionCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType,
                                        QSharedPointer<QNetworkSession> networkSession)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType, /*parent=*/0,
-                                 qMove(networkSession))
+        : QHttpNetworkConnection(connectionCount, hostName, port, encrypt, /*parent=*/0,
+                                 qMove(networkSession), connectionType)
 #endif
     {
         setExpires(true);
         setShareable(true);
     }
 
+    void setIdleTimeout(int seconds)
+    {
+        setExpiryTimeout(seconds);
+    }
+
     virtual void dispose() override
     {
 #if 0  // sample code; do this right with the API
@@ -237,9 +245,14 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
     , isSpdyUsed(false)
+    , isConnectionReused(false)
+    , connectionWaitTime(0)
+    , queueDepth(0)
     , incomingContentLength(-1)
     , removedContentLength(-1)
     , incomingErrorCode(QNetworkReply::NoError)
+    , connectionsPerHost(0)
+    , connectionIdleTimeout(0)
     , downloadBuffer()
     , httpConnection(0)
     , httpReply(0)
@@ -340,20 +353,33 @@ void QHttpThreadDelegate::startRequest()
 #endif
         cacheKey = makeCacheKey(urlCopy, nullptr, httpRequest.peerVerifyName());
 
+    // connections of a differently configured pool must not be shared
+    if (connectionsPerHost > 0 || connectionIdleTimeout > 0) {
+        cacheKey += ":pool=" + QByteArray::number(connectionsPerHost)
+                    + ',' + QByteArray::number(connectionIdleTimeout);
+    }
+    const int connectionCount = connectionsPerHost > 0
+            ? connectionsPerHost : QHttpNetworkConnectionPrivate::defaultHttpChannelCount;
+
     // the http object is actually a QHttpNetworkConnection
     httpConnection = static_cast<QNetworkAccessCachedHttpConnection *>(connections.localData()->requestEntryNow(cacheKey));
     if (!httpConnection) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
 #ifdef QT_NO_BEARERMANAGEMENT
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(connectionCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType);
 #else
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(connectionCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType,
                                                                 networkSession);
 #endif // QT_NO_BEARERMANAGEMENT
-        if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
+        if (connectionIdleTimeout > 0)
+            httpConnection->setIdleTimeout(connectionIdleTimeout);
+        if ((connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
+             || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2Direct)
             && http2Parameters.validate()) {
             httpConnection->setHttp2Parameters(http2Parameters);
         } // else we ignore invalid parameters and use our own defaults.
@@ -653,6 +679,9 @@ void QHttpThreadDelegate::headerChangedSlot()
     incomingContentLength = httpReply->contentLength();
     removedContentLength = httpReply->removedContentLength();
     isSpdyUsed = httpReply->isSpdyUsed();
+    isConnectionReused = httpReply->isConnectionReused();
+    connectionWaitTime = httpReply->connectionWaitTime();
+    queueDepth = httpReply->queueDepth();
 
     emit downloadMetaData(incomingHeaders,
                           incomingStatusCode,
@@ -661,7 +690,10 @@ void QHttpThreadDelegate::headerChangedSlot()
                           downloadBuffer,
                           incomingContentLength,
                           removedContentLength,
-                          isSpdyUsed);
+                          isSpdyUsed,
+                          isConnectionReused,
+                          connectionWaitTime,
+                          queueDepth);
 }
 
 void QHttpThreadDelegate::synchronousHeaderChangedSlot()
@@ -678,6 +710,9 @@ void QHttpThreadDelegate::synchronousHeaderChangedSlot()
     incomingReasonPhrase = httpReply->reasonPhrase();
     isPipeliningUsed = httpReply->isPipeliningUsed();
     isSpdyUsed = httpReply->isSpdyUsed();
+    isConnectionReused = httpReply->isConnectionReused();
+    connectionWaitTime = httpReply->connectionWaitTime();
+    queueDepth = httpReply->queueDepth();
     incomingContentLength = httpReply->contentLength();
 }
 
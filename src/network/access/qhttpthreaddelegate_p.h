@@ -112,11 +112,17 @@ public:
     QString incomingReasonPhrase;
     bool isPipeliningUsed;
     bool isSpdyUsed;
+    bool isConnectionReused;
+    qint64 connectionWaitTime;
+    int queueDepth;
     qint64 incomingContentLength;
     qint64 removedContentLength;
     QNetworkReply::NetworkError incomingErrorCode;
     QString incomingErrorDetail;
     Http2::ProtocolParameters http2Parameters;
+    // HTTP/1.1 connection pool of the host; 0 means the default
+    int connectionsPerHost;
+    int connectionIdleTimeout;
 #ifndef QT_NO_BEARERMANAGEMENT
     QSharedPointer<QNetworkSession> networkSession;
 #endif
@@ -144,7 +150,7 @@ signals:
     void preSharedKeyAuthenticationRequired(QSslPreSharedKeyAuthenticator *);
 #endif
     void downloadMetaData(const QList<QPair<QByteArray,QByteArray> > &, int, const QString &, bool,
-                          QSharedPointer<char>, qint64, qint64, bool);
+                          QSharedPointer<char>, qint64, qint64, bool, bool, qint64, int);
     void downloadProgress(qint64, qint64);
     void downloadData(const QByteArray &);
     void error(QNetworkReply::NetworkError, const QString &);
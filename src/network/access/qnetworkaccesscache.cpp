@@ -77,8 +77,9 @@ struct QNetworkAccessCache::Node
 };
 
 QNetworkAccessCache::CacheableObject::CacheableObject()
+    : expiryTimeout(ExpiryTime)
 {
-    // leave the members uninitialized
+    // leave the other members uninitialized
     // they must be initialized by the derived class's constructor
 }
 
@@ -101,6 +102,12 @@ void QNetworkAccessCache::CacheableObject::setShareable(bool enable)
     shareable = enable;
 }
 
+// number of seconds the object stays in the cache after its last release
+void QNetworkAccessCache::CacheableObject::setExpiryTimeout(int seconds)
+{
+    expiryTimeout = seconds;
+}
+
 QNetworkAccessCache::QNetworkAccessCache()
     : oldest(0), newest(0)
 {
@@ -147,18 +154,25 @@ void QNetworkAccessCache::linkEntry(const QByteArray &key)
     Q_ASSERT(node->older == 0 && node->newer == 0);
     Q_ASSERT(node->useCount == 0);
 
-    if (newest) {
-        Q_ASSERT(newest->newer == 0);
-        newest->newer = node;
-        node->older = newest;
-    }
-    if (!oldest) {
-        // there are no entries, so this is the oldest one too
-        oldest = node;
-    }
+    Q_ASSERT(!newest || newest->newer == 0);
+    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(node->object->expiryTimeout);
+
+    // keep the list sorted by expiry time, objects can have shorter
+    // timeouts than the ones released before them
+    Node *older = newest;
+    while (older && node->timestamp < older->timestamp)
+        older = older->older;
 
-    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(ExpiryTime);
-    newest = node;
+    node->older = older;
+    node->newer = older ? older->newer : oldest;
+    if (node->older)
+        node->older->newer = node;
+    else
+        oldest = node;
+    if (node->newer)
+        node->newer->older = node;
+    else
+        newest = node;
 }
 
 /*!
@@ -197,14 +211,11 @@ void QNetworkAccessCache::updateTimer()
         return;
 
     int interval = QDateTime::currentDateTimeUtc().secsTo(oldest->timestamp);
-    if (interval <= 0) {
+    if (interval <= 0)
         interval = 0;
-    } else {
-        // round up the interval
-        interval = (interval + 15) & ~16;
-    }
 
-    timer.start(interval * 1000, this);
+    // expiry has a granularity of seconds, so let the timer be coarse
+    timer.start(interval * 1000, Qt::VeryCoarseTimer, this);
 }
 
 bool QNetworkAccessCache::emitEntryReady(Node *node, QObject *target, const char *member)
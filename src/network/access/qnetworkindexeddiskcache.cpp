@@ -0,0 +1,1121 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//#define QNETWORKINDEXEDDISKCACHE_DEBUG
+
+#include "qnetworkindexeddiskcache.h"
+#include "qnetworkindexeddiskcache_p.h"
+
+#include <qcryptographichash.h>
+#include <qdatastream.h>
+#include <qdebug.h>
+#include <qdir.h>
+#include <qendian.h>
+#include <qsavefile.h>
+#include <qscopedpointer.h>
+#include <qurl.h>
+
+#include <algorithm>
+#include <limits>
+
+#define STORAGE_DIR QLatin1String("indexed1/")
+#define SEGMENT_POSTFIX QLatin1String(".seg")
+#define DEDICATED_SEGMENT_POSTFIX QLatin1String(".blob")
+#define TEMPORARY_POSTFIX QLatin1String(".tmp")
+
+#define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
+
+QT_BEGIN_NAMESPACE
+
+using namespace QNetworkIndexedDiskCacheStorage;
+
+enum {
+    RecordMagic = 0x524e4351,           // "QCNR"
+    JournalMagic = 0x4a4e4351,          // "QCNJ"
+    JournalVersion = 1,
+    JournalHeaderSize = 8,
+    JournalEntrySize = 1 + KeySize,
+    JournalLocationSize = 4 + 8 + 4 + 8 + 1,
+    // rewrite the journal once it is this much larger than the index
+    JournalSlack = 4096
+};
+
+/*!
+    \class QNetworkIndexedDiskCache
+    \since 5.14
+    \inmodule QtNetwork
+
+    \brief The QNetworkIndexedDiskCache class provides a disk cache that
+    scales to large numbers of entries.
+
+    QNetworkIndexedDiskCache implements the same interface as
+    QNetworkDiskCache, but instead of storing each URL in its own file and
+    scanning the cache directory to enforce the size limit, it keeps an index
+    of all entries in memory and on disk:
+
+    \list
+    \li Responses are stored as records that are appended to segment files
+        of up to 16 MB. Bodies larger than 1 MB get a segment of their own.
+    \li A journal records every insertion, removal and access. It is
+        replayed when the cache directory is set, and is rewritten as a
+        compact snapshot when it has grown much larger than the index. If the
+        journal is missing or damaged, the index is rebuilt from the
+        segments, which may bring back entries that had been removed but
+        not yet compacted away.
+    \li Entries are evicted in least recently used order. Each eviction
+        takes constant time and does not touch the file system except when
+        a segment becomes empty and is removed.
+    \li Segments in which more than half of the data belongs to evicted or
+        replaced entries are compacted incrementally, one at a time, on
+        subsequent insertions.
+    \endlist
+
+    Looking up an entry therefore costs a hash lookup and a single read,
+    independent of the number of entries in the cache. cacheSize() reports
+    the size of the live records; the files on disk may additionally hold
+    up to the same amount of data that is waiting for compaction.
+
+    Like QNetworkDiskCache, files with a text MIME type are compressed
+    using qCompress(), and the cache directory must not be shared between
+    several cache objects. The directory layout is not compatible with
+    QNetworkDiskCache, but both can use the same directory.
+
+    \sa QNetworkDiskCache
+*/
+
+QByteArray RecordHeader::toByteArray() const
+{
+    QByteArray result(RecordHeaderSize, Qt::Uninitialized);
+    char *p = result.data();
+    qToLittleEndian<quint32>(RecordMagic, p);
+    qToLittleEndian<quint32>(flags, p + 4);
+    memcpy(p + 8, key, KeySize);
+    qToLittleEndian<quint32>(metaDataSize, p + 8 + KeySize);
+    qToLittleEndian<quint64>(bodySize, p + 12 + KeySize);
+    return result;
+}
+
+bool RecordHeader::fromByteArray(const char *data)
+{
+    if (qFromLittleEndian<quint32>(data) != RecordMagic)
+        return false;
+    flags = qFromLittleEndian<quint32>(data + 4);
+    memcpy(key, data + 8, KeySize);
+    metaDataSize = qFromLittleEndian<quint32>(data + 8 + KeySize);
+    bodySize = qFromLittleEndian<quint64>(data + 12 + KeySize);
+    return bodySize < quint64(std::numeric_limits<qint64>::max()) / 2;
+}
+
+/*!
+    Creates a new disk cache. The \a parent argument is passed to
+    QAbstractNetworkCache's constructor.
+*/
+QNetworkIndexedDiskCache::QNetworkIndexedDiskCache(QObject *parent)
+    : QAbstractNetworkCache(*new QNetworkIndexedDiskCachePrivate, parent)
+{
+}
+
+/*!
+    Destroys the cache object and writes outstanding index updates to disk.
+    This does not clear the disk cache.
+*/
+QNetworkIndexedDiskCache::~QNetworkIndexedDiskCache()
+{
+}
+
+QNetworkIndexedDiskCachePrivate::~QNetworkIndexedDiskCachePrivate()
+{
+    close();
+    qDeleteAll(inserting);
+}
+
+/*!
+    Returns the location where cached files are stored.
+*/
+QString QNetworkIndexedDiskCache::cacheDirectory() const
+{
+    Q_D(const QNetworkIndexedDiskCache);
+    return d->cacheDirectory;
+}
+
+/*!
+    Sets the directory where cached files are stored to \a cacheDir and
+    loads the index of that directory.
+
+    QNetworkIndexedDiskCache creates the directory if it does not exist.
+*/
+void QNetworkIndexedDiskCache::setCacheDirectory(const QString &cacheDir)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::setCacheDirectory()" << cacheDir;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    if (cacheDir.isEmpty())
+        return;
+    d->close();
+    d->cacheDirectory = QDir(cacheDir).absolutePath();
+    if (!d->cacheDirectory.endsWith(QLatin1Char('/')))
+        d->cacheDirectory += QLatin1Char('/');
+    d->storageDirectory = d->cacheDirectory + STORAGE_DIR;
+    d->open();
+}
+
+/*!
+    Returns the maximum size of the disk cache.
+
+    \sa setMaximumCacheSize()
+*/
+qint64 QNetworkIndexedDiskCache::maximumCacheSize() const
+{
+    Q_D(const QNetworkIndexedDiskCache);
+    return d->maximumCacheSize;
+}
+
+/*!
+    Sets the maximum size of the disk cache to \a size. The default is 50MB.
+
+    Whenever the cache grows beyond this size, the least recently used
+    entries are removed until the size is less than 90% of \a size.
+
+    \sa maximumCacheSize()
+*/
+void QNetworkIndexedDiskCache::setMaximumCacheSize(qint64 size)
+{
+    Q_D(QNetworkIndexedDiskCache);
+    d->maximumCacheSize = size;
+    d->expire();
+}
+
+/*!
+    \reimp
+*/
+qint64 QNetworkIndexedDiskCache::cacheSize() const
+{
+    Q_D(const QNetworkIndexedDiskCache);
+    return d->currentCacheSize;
+}
+
+/*!
+    \reimp
+*/
+QNetworkCacheMetaData QNetworkIndexedDiskCache::metaData(const QUrl &url)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::metaData()" << url;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    if (!url.isValid())
+        return QNetworkCacheMetaData();
+    const QByteArray key = d->cacheKey(url);
+    if (key == d->lastKey)
+        return d->lastMetaData;
+
+    Entry *entry = d->lookup(key, true);
+    if (!entry)
+        return QNetworkCacheMetaData();
+
+    QFile file(d->segmentFileName(entry->segment, d->segments.value(entry->segment).dedicated));
+    QNetworkCacheMetaData metaData;
+    if (file.open(QIODevice::ReadOnly) && file.seek(entry->offset + RecordHeaderSize)) {
+        const QByteArray blob = file.read(entry->metaDataSize);
+        QDataStream in(blob);
+        in.setVersion(QDataStream::Qt_5_13);
+        in >> metaData;
+        if (in.status() != QDataStream::Ok || d->cacheKey(metaData.url()) != key)
+            metaData = QNetworkCacheMetaData();
+    }
+    if (!metaData.isValid()) {
+        qWarning() << "QNetworkIndexedDiskCache: dropping unreadable cache entry for" << url;
+        d->removeEntry(entry, true);
+        return metaData;
+    }
+
+    d->lastKey = key;
+    d->lastMetaData = metaData;
+    return metaData;
+}
+
+/*!
+    \reimp
+*/
+QIODevice *QNetworkIndexedDiskCache::data(const QUrl &url)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::data()" << url;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    if (!url.isValid())
+        return nullptr;
+    Entry *entry = d->lookup(d->cacheKey(url), true);
+    if (!entry)
+        return nullptr;
+
+    QScopedPointer<QFile> file(new QFile(d->segmentFileName(entry->segment,
+                                                            d->segments.value(entry->segment).dedicated)));
+    if (!file->open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        d->removeEntry(entry, true);
+        return nullptr;
+    }
+
+    QScopedPointer<QBuffer> buffer(new QBuffer);
+    const qint64 bodyOffset = entry->offset + RecordHeaderSize + entry->metaDataSize;
+    if (entry->compressed) {
+        file->seek(bodyOffset);
+        buffer->setData(qUncompress(file->read(entry->bodySize)));
+    } else {
+        const uchar *p = nullptr;
+#if !defined(Q_OS_INTEGRITY)
+        if (entry->bodySize)
+            p = file->map(bodyOffset, entry->bodySize);
+#endif
+        if (p) {
+            // segments are only ever appended to, so the mapping stays valid
+            // for as long as the buffer keeps the file open
+            buffer->setData(QByteArray::fromRawData(reinterpret_cast<const char *>(p),
+                                                    int(entry->bodySize)));
+            file.take()->setParent(buffer.data());
+        } else {
+            file->seek(bodyOffset);
+            buffer->setData(file->read(entry->bodySize));
+        }
+    }
+    buffer->open(QBuffer::ReadOnly);
+    return buffer.take();
+}
+
+/*!
+    \reimp
+*/
+void QNetworkIndexedDiskCache::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::updateMetaData()" << metaData.url();
+#endif
+    QScopedPointer<QIODevice> oldDevice(data(metaData.url()));
+    if (!oldDevice)
+        return;
+    QIODevice *newDevice = prepare(metaData);
+    if (!newDevice)
+        return;
+    char buffer[4096];
+    while (!oldDevice->atEnd()) {
+        const qint64 s = oldDevice->read(buffer, sizeof buffer);
+        if (s <= 0)
+            break;
+        newDevice->write(buffer, s);
+    }
+    insert(newDevice);
+}
+
+/*!
+    \reimp
+*/
+bool QNetworkIndexedDiskCache::remove(const QUrl &url)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::remove()" << url;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+
+    // remove is also used to cancel insertions, not a common operation
+    for (auto it = d->inserting.begin(), end = d->inserting.end(); it != end; ++it) {
+        if (it.value()->metaData.url() == url) {
+            delete it.value();
+            d->inserting.erase(it);
+            return true;
+        }
+    }
+
+    if (!url.isValid())
+        return false;
+    Entry *entry = d->lookup(d->cacheKey(url), false);
+    if (!entry)
+        return false;
+    d->removeEntry(entry, true);
+    return true;
+}
+
+/*!
+    \reimp
+*/
+QIODevice *QNetworkIndexedDiskCache::prepare(const QNetworkCacheMetaData &metaData)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::prepare()" << metaData.url();
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    if (!metaData.isValid() || !metaData.url().isValid() || !metaData.saveToDisk())
+        return nullptr;
+
+    if (d->cacheDirectory.isEmpty()) {
+        qWarning("QNetworkIndexedDiskCache::prepare() The cache directory is not set");
+        return nullptr;
+    }
+
+    qint64 contentLength = -1;
+    const auto headers = metaData.rawHeaders();
+    for (const auto &header : headers) {
+        if (header.first.compare("content-length", Qt::CaseInsensitive) == 0) {
+            contentLength = header.second.toLongLong();
+            if (contentLength > (d->maximumCacheSize * 3) / 4)
+                return nullptr;
+            break;
+        }
+    }
+
+    QScopedPointer<QNetworkIndexedDiskCachePrivate::PendingItem> item(
+                new QNetworkIndexedDiskCachePrivate::PendingItem);
+    item->metaData = metaData;
+    item->metaDataBlob = d->serializeMetaData(metaData);
+    item->compress = d->canCompress(metaData);
+
+    QIODevice *device;
+    if (!item->compress && contentLength > DedicatedSegmentThreshold) {
+        // stream large bodies straight into what becomes their segment; the
+        // record header is completed in insert()
+        item->file = new QTemporaryFile(d->storageDirectory + QLatin1String("XXXXXX")
+                                        + TEMPORARY_POSTFIX);
+        if (!item->file->open()) {
+            qWarning("QNetworkIndexedDiskCache::prepare() unable to open temporary file");
+            return nullptr;
+        }
+        RecordHeader header = {};
+        item->file->write(header.toByteArray());
+        item->file->write(item->metaDataBlob);
+        device = item->file;
+    } else {
+        item->buffer.open(QBuffer::ReadWrite);
+        device = &item->buffer;
+    }
+    d->inserting.insert(device, item.take());
+    return device;
+}
+
+/*!
+    \reimp
+*/
+void QNetworkIndexedDiskCache::insert(QIODevice *device)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::insert()" << device;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    const auto it = d->inserting.constFind(device);
+    if (Q_UNLIKELY(it == d->inserting.cend())) {
+        qWarning() << "QNetworkIndexedDiskCache::insert() called on a device we don't know about" << device;
+        return;
+    }
+
+    QScopedPointer<QNetworkIndexedDiskCachePrivate::PendingItem> item(it.value());
+    d->inserting.erase(it);
+    d->storeItem(item.data());
+}
+
+/*!
+    \reimp
+*/
+void QNetworkIndexedDiskCache::clear()
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug("QNetworkIndexedDiskCache::clear()");
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    d->removeAll();
+}
+
+/*!
+    Writes a compact snapshot of the index to disk. This happens
+    automatically when the journal has grown large enough, so calling this
+    function is only needed to make sure that recent accesses are reflected
+    in the on-disk eviction order, for example before the application is
+    suspended.
+*/
+void QNetworkIndexedDiskCache::flush()
+{
+    Q_D(QNetworkIndexedDiskCache);
+    if (!d->storageDirectory.isEmpty())
+        d->writeSnapshot();
+}
+
+QByteArray QNetworkIndexedDiskCachePrivate::cacheKey(const QUrl &url)
+{
+    QUrl cleanUrl = url;
+    cleanUrl.setPassword(QString());
+    cleanUrl.setFragment(QString());
+    return QCryptographicHash::hash(cleanUrl.toEncoded(), QCryptographicHash::Sha1);
+}
+
+/*!
+    We compress small text and JavaScript files, like QNetworkDiskCache.
+*/
+bool QNetworkIndexedDiskCachePrivate::canCompress(const QNetworkCacheMetaData &metaData)
+{
+    bool sizeOk = false;
+    bool typeOk = false;
+    const auto headers = metaData.rawHeaders();
+    for (const auto &header : headers) {
+        if (header.first.compare("content-length", Qt::CaseInsensitive) == 0) {
+            if (header.second.toLongLong() > MAX_COMPRESSION_SIZE)
+                return false;
+            sizeOk = true;
+        }
+
+        if (header.first.compare("content-type", Qt::CaseInsensitive) == 0) {
+            const QByteArray &type = header.second;
+            if (type.startsWith("text/")
+                    || (type.startsWith("application/")
+                        && (type.endsWith("javascript") || type.endsWith("ecmascript"))))
+                typeOk = true;
+            else
+                return false;
+        }
+        if (sizeOk && typeOk)
+            return true;
+    }
+    return false;
+}
+
+QByteArray QNetworkIndexedDiskCachePrivate::serializeMetaData(const QNetworkCacheMetaData &metaData)
+{
+    QByteArray blob;
+    QDataStream out(&blob, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_13);
+    out << metaData;
+    return blob;
+}
+
+QString QNetworkIndexedDiskCachePrivate::segmentFileName(quint32 segment, bool dedicated) const
+{
+    return storageDirectory + QString::number(segment, 16).rightJustified(8, QLatin1Char('0'))
+            + (dedicated ? DEDICATED_SEGMENT_POSTFIX : SEGMENT_POSTFIX);
+}
+
+QString QNetworkIndexedDiskCachePrivate::journalFileName() const
+{
+    return storageDirectory + QLatin1String("journal");
+}
+
+void QNetworkIndexedDiskCachePrivate::open()
+{
+    QDir().mkpath(storageDirectory);
+
+    bool needsSnapshot = false;
+    if (!replayJournal(&needsSnapshot)) {
+        if (QFile::exists(journalFileName()))
+            qWarning() << "QNetworkIndexedDiskCache: damaged index in" << storageDirectory;
+        rebuildFromSegments();
+        needsSnapshot = true;
+    }
+    reconcileSegments();
+
+    if (needsSnapshot || journalRecords > 2 * entries.size() + JournalSlack) {
+        writeSnapshot();
+    } else {
+        journal.setFileName(journalFileName());
+        if (!journal.open(QIODevice::WriteOnly | QIODevice::Append))
+            qWarning() << "QNetworkIndexedDiskCache: cannot open" << journal.fileName();
+    }
+    expire();
+
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::open()" << entries.size() << "entries in"
+             << segments.size() << "segments," << currentCacheSize << "bytes";
+#endif
+}
+
+void QNetworkIndexedDiskCachePrivate::close()
+{
+    journal.close();
+    currentSegmentFile.close();
+    qDeleteAll(entries);
+    entries.clear();
+    mostRecent = leastRecent = nullptr;
+    segments.clear();
+    pendingCompaction.clear();
+    currentSegment = 0;
+    nextSegment = 1;
+    currentCacheSize = 0;
+    journalRecords = 0;
+    lastKey.clear();
+    lastMetaData = QNetworkCacheMetaData();
+}
+
+/*!
+    Reads the journal into the in-memory index. Returns \c false if there is
+    no usable journal. Sets *\a needsSnapshot if the journal ends with a
+    partially written record.
+*/
+bool QNetworkIndexedDiskCachePrivate::replayJournal(bool *needsSnapshot)
+{
+    QFile file(journalFileName());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = file.readAll();
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    if (end - p < JournalHeaderSize || qFromLittleEndian<quint32>(p) != JournalMagic
+            || qFromLittleEndian<quint32>(p + 4) != JournalVersion) {
+        return false;
+    }
+    p += JournalHeaderSize;
+
+    while (end - p >= JournalEntrySize) {
+        const JournalOp op = JournalOp(*p);
+        const QByteArray key(p + 1, KeySize);
+        const bool hasLocation = op == JournalInsert || op == JournalMove;
+        if (hasLocation && end - p < JournalEntrySize + JournalLocationSize)
+            break;
+        p += JournalEntrySize;
+        ++journalRecords;
+
+        Entry *entry = entries.value(key);
+        switch (op) {
+        case JournalInsert:
+        case JournalMove: {
+            const quint32 segment = qFromLittleEndian<quint32>(p);
+            const qint64 offset = qFromLittleEndian<qint64>(p + 4);
+            RecordHeader header;
+            header.metaDataSize = qFromLittleEndian<quint32>(p + 12);
+            header.bodySize = qFromLittleEndian<quint64>(p + 16);
+            header.flags = quint8(p[24]);
+            p += JournalLocationSize;
+            if (op == JournalInsert || entry) {
+                entry = placeEntry(key, segment, offset, header);
+                if (op == JournalInsert && entry != mostRecent) {
+                    unlink(entry);
+                    linkFront(entry);
+                }
+            }
+            break;
+        }
+        case JournalTouch:
+            if (entry && entry != mostRecent) {
+                unlink(entry);
+                linkFront(entry);
+            }
+            break;
+        case JournalRemove:
+            if (entry) {
+                unlink(entry);
+                entries.remove(key);
+                delete entry;
+            }
+            break;
+        default:
+            // unknown record: the rest of the journal cannot be trusted
+            *needsSnapshot = true;
+            return true;
+        }
+    }
+    if (p != end)
+        *needsSnapshot = true;
+    return true;
+}
+
+/*!
+    Recreates the index from the record headers in the segment files, in
+    segment order. Used when the journal is missing or damaged.
+*/
+void QNetworkIndexedDiskCachePrivate::rebuildFromSegments()
+{
+    qDeleteAll(entries);
+    entries.clear();
+    mostRecent = leastRecent = nullptr;
+
+    QVector<QPair<quint32, bool>> found;
+    const QStringList names = QDir(storageDirectory).entryList(
+                { QLatin1String("*") + SEGMENT_POSTFIX, QLatin1String("*") + DEDICATED_SEGMENT_POSTFIX },
+                QDir::Files);
+    for (const QString &name : names) {
+        bool ok;
+        const quint32 segment = name.leftRef(name.indexOf(QLatin1Char('.'))).toUInt(&ok, 16);
+        if (ok)
+            found.append(qMakePair(segment, name.endsWith(DEDICATED_SEGMENT_POSTFIX)));
+    }
+    std::sort(found.begin(), found.end());
+
+    for (const auto &segment : qAsConst(found)) {
+        scanSegment(segment.first, segment.second,
+                    [this, &segment](const RecordHeader &header, qint64 offset, QFile &) {
+            placeEntry(QByteArray(header.key, KeySize), segment.first, offset, header);
+            return true;
+        });
+    }
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::rebuildFromSegments()" << entries.size() << "records";
+#endif
+}
+
+/*!
+    Matches the index against the segment files on disk: drops entries
+    whose data is missing, removes files that hold no live records, and
+    computes the size accounting.
+*/
+void QNetworkIndexedDiskCachePrivate::reconcileSegments()
+{
+    QDir dir(storageDirectory);
+    const QFileInfoList files = dir.entryInfoList(QDir::Files);
+    for (const QFileInfo &info : files) {
+        const QString name = info.fileName();
+        const bool dedicated = name.endsWith(DEDICATED_SEGMENT_POSTFIX);
+        if (name.endsWith(TEMPORARY_POSTFIX)) {
+            // left over from an insertion that was interrupted
+            QFile::remove(info.filePath());
+            continue;
+        }
+        if (!dedicated && !name.endsWith(SEGMENT_POSTFIX))
+            continue;
+        bool ok;
+        const quint32 id = name.leftRef(name.indexOf(QLatin1Char('.'))).toUInt(&ok, 16);
+        if (!ok)
+            continue;
+        Segment segment;
+        segment.size = info.size();
+        segment.dedicated = dedicated;
+        segments.insert(id, segment);
+        nextSegment = qMax(nextSegment, id + 1);
+    }
+
+    currentCacheSize = 0;
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        Entry *entry = it.value();
+        const auto segment = segments.find(entry->segment);
+        if (segment == segments.end() || entry->offset + entry->recordSize() > segment->size) {
+            unlink(entry);
+            delete entry;
+            it = entries.erase(it);
+            continue;
+        }
+        segment->liveBytes += entry->recordSize();
+        currentCacheSize += entry->recordSize();
+        ++it;
+    }
+
+    quint32 reusable = 0;
+    for (auto it = segments.begin(); it != segments.end(); ) {
+        if (it->liveBytes == 0) {
+            QFile::remove(segmentFileName(it.key(), it->dedicated));
+            it = segments.erase(it);
+            continue;
+        }
+        if (!it->dedicated) {
+            if (it->size < SegmentSize && it.key() > reusable)
+                reusable = it.key();
+            if (it->liveBytes * 2 < it->size)
+                pendingCompaction.append(it.key());
+        }
+        ++it;
+    }
+
+    // keep appending to the newest segment that still has room
+    if (reusable) {
+        currentSegmentFile.setFileName(segmentFileName(reusable, false));
+        if (currentSegmentFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            currentSegment = reusable;
+            pendingCompaction.removeOne(reusable);
+        }
+    }
+}
+
+void QNetworkIndexedDiskCachePrivate::writeSnapshot()
+{
+    journal.close();
+
+    QByteArray data;
+    data.reserve(JournalHeaderSize + entries.size() * (JournalEntrySize + JournalLocationSize));
+    char header[JournalHeaderSize];
+    qToLittleEndian<quint32>(JournalMagic, header);
+    qToLittleEndian<quint32>(JournalVersion, header + 4);
+    data.append(header, JournalHeaderSize);
+
+    // least recently used first, so that replaying restores the order
+    for (const Entry *entry = leastRecent; entry; entry = entry->prev) {
+        char record[JournalEntrySize + JournalLocationSize];
+        record[0] = char(JournalInsert);
+        memcpy(record + 1, entry->key.constData(), KeySize);
+        char *p = record + JournalEntrySize;
+        qToLittleEndian<quint32>(entry->segment, p);
+        qToLittleEndian<qint64>(entry->offset, p + 4);
+        qToLittleEndian<quint32>(entry->metaDataSize, p + 12);
+        qToLittleEndian<quint64>(quint64(entry->bodySize), p + 16);
+        p[24] = entry->compressed ? char(RecordHeader::Compressed) : char(0);
+        data.append(record, sizeof record);
+    }
+
+    QSaveFile file(journalFileName());
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+        qWarning() << "QNetworkIndexedDiskCache: cannot write" << journalFileName();
+    journalRecords = entries.size();
+
+    journal.setFileName(journalFileName());
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append))
+        qWarning() << "QNetworkIndexedDiskCache: cannot open" << journal.fileName();
+}
+
+void QNetworkIndexedDiskCachePrivate::appendJournal(JournalOp op, const Entry *entry)
+{
+    if (!journal.isOpen())
+        return;
+
+    char record[JournalEntrySize + JournalLocationSize];
+    record[0] = char(op);
+    memcpy(record + 1, entry->key.constData(), KeySize);
+    int size = JournalEntrySize;
+    if (op == JournalInsert || op == JournalMove) {
+        char *p = record + JournalEntrySize;
+        qToLittleEndian<quint32>(entry->segment, p);
+        qToLittleEndian<qint64>(entry->offset, p + 4);
+        qToLittleEndian<quint32>(entry->metaDataSize, p + 12);
+        qToLittleEndian<quint64>(quint64(entry->bodySize), p + 16);
+        p[24] = entry->compressed ? char(RecordHeader::Compressed) : char(0);
+        size += JournalLocationSize;
+    }
+    journal.write(record, size);
+    ++journalRecords;
+
+    // accesses may stay buffered; losing them only affects the eviction order
+    if (op != JournalTouch)
+        journal.flush();
+}
+
+template <typename Visitor>
+bool QNetworkIndexedDiskCachePrivate::scanSegment(quint32 segment, bool dedicated,
+                                                  Visitor visitor) const
+{
+    QFile file(segmentFileName(segment, dedicated));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const qint64 size = file.size();
+    qint64 offset = 0;
+    while (offset + RecordHeaderSize <= size) {
+        RecordHeader header;
+        if (!file.seek(offset))
+            return false;
+        const QByteArray raw = file.read(RecordHeaderSize);
+        if (raw.size() != RecordHeaderSize || !header.fromByteArray(raw.constData())
+                || offset + header.recordSize() > size) {
+            break;
+        }
+        if (!visitor(header, offset, file))
+            return false;
+        offset += header.recordSize();
+    }
+    return true;
+}
+
+QNetworkIndexedDiskCachePrivate::Entry *QNetworkIndexedDiskCachePrivate::lookup(const QByteArray &key, bool touch)
+{
+    Entry *entry = entries.value(key);
+    if (entry && touch && entry != mostRecent) {
+        unlink(entry);
+        linkFront(entry);
+        appendJournal(JournalTouch, entry);
+    }
+    return entry;
+}
+
+/*!
+    Sets the location of the entry for \a key, creating it as the most
+    recently used entry if needed. Does no size accounting.
+*/
+QNetworkIndexedDiskCachePrivate::Entry *QNetworkIndexedDiskCachePrivate::placeEntry(
+        const QByteArray &key, quint32 segment, qint64 offset, const RecordHeader &header)
+{
+    Entry *&entry = entries[key];
+    if (!entry) {
+        entry = new Entry;
+        entry->key = key;
+        linkFront(entry);
+    }
+    entry->segment = segment;
+    entry->offset = offset;
+    entry->metaDataSize = header.metaDataSize;
+    entry->bodySize = qint64(header.bodySize);
+    entry->compressed = header.flags & RecordHeader::Compressed;
+    return entry;
+}
+
+bool QNetworkIndexedDiskCachePrivate::appendToCurrentSegment(const QByteArray &record,
+                                                            quint32 *segment, qint64 *offset)
+{
+    auto current = segments.find(currentSegment);
+    if (!currentSegmentFile.isOpen() || current == segments.end()
+            || current->size + record.size() > SegmentSize) {
+        currentSegmentFile.close();
+        if (current != segments.end() && current->liveBytes * 2 < current->size)
+            pendingCompaction.append(currentSegment);
+        currentSegment = nextSegment++;
+        currentSegmentFile.setFileName(segmentFileName(currentSegment, false));
+        if (!currentSegmentFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qWarning() << "QNetworkIndexedDiskCache: cannot open" << currentSegmentFile.fileName();
+            return false;
+        }
+        current = segments.insert(currentSegment, Segment());
+    }
+
+    *segment = currentSegment;
+    *offset = current->size;
+    const qint64 written = currentSegmentFile.write(record);
+    currentSegmentFile.flush();
+    if (written != record.size()) {
+        // whatever made it to disk is dead space now
+        qWarning() << "QNetworkIndexedDiskCache: cannot write to" << currentSegmentFile.fileName();
+        current->size = currentSegmentFile.size();
+        currentSegmentFile.close();
+        return false;
+    }
+    current->size += record.size();
+    return true;
+}
+
+bool QNetworkIndexedDiskCachePrivate::writeDedicatedSegment(const QByteArray &record, quint32 *segment)
+{
+    const quint32 id = nextSegment++;
+    QSaveFile file(segmentFileName(id, true));
+    if (!file.open(QIODevice::WriteOnly) || file.write(record) != record.size() || !file.commit()) {
+        qWarning() << "QNetworkIndexedDiskCache: cannot write" << file.fileName();
+        return false;
+    }
+    Segment s;
+    s.size = record.size();
+    s.dedicated = true;
+    segments.insert(id, s);
+    *segment = id;
+    return true;
+}
+
+void QNetworkIndexedDiskCachePrivate::storeItem(PendingItem *item)
+{
+    RecordHeader header;
+    header.flags = 0;
+    const QByteArray key = cacheKey(item->metaData.url());
+    memcpy(header.key, key.constData(), KeySize);
+    header.metaDataSize = quint32(item->metaDataBlob.size());
+
+    quint32 segment;
+    qint64 offset = 0;
+    if (item->file) {
+        const qint64 size = item->file->size();
+        header.bodySize = quint64(size - RecordHeaderSize - header.metaDataSize);
+        if (!item->file->seek(0) || item->file->write(header.toByteArray()) != RecordHeaderSize
+                || !item->file->flush()) {
+            qWarning() << "QNetworkIndexedDiskCache: cannot write" << item->file->fileName();
+            return;
+        }
+        segment = nextSegment++;
+        item->file->setAutoRemove(false);
+        if (!item->file->rename(segmentFileName(segment, true))) {
+            item->file->setAutoRemove(true);
+            qWarning() << "QNetworkIndexedDiskCache: cannot store" << item->file->fileName();
+            return;
+        }
+        Segment s;
+        s.size = size;
+        s.dedicated = true;
+        segments.insert(segment, s);
+    } else {
+        QByteArray body = item->buffer.data();
+        if (item->compress) {
+            body = qCompress(body);
+            header.flags |= RecordHeader::Compressed;
+        }
+        header.bodySize = quint64(body.size());
+
+        QByteArray record;
+        record.reserve(int(header.recordSize()));
+        record += header.toByteArray();
+        record += item->metaDataBlob;
+        record += body;
+        const bool stored = body.size() > DedicatedSegmentThreshold
+                ? writeDedicatedSegment(record, &segment)
+                : appendToCurrentSegment(record, &segment, &offset);
+        if (!stored)
+            return;
+    }
+
+    if (Entry *old = entries.value(key))
+        removeEntry(old, false);
+    Entry *entry = placeEntry(key, segment, offset, header);
+    currentCacheSize += entry->recordSize();
+    segments[segment].liveBytes += entry->recordSize();
+    appendJournal(JournalInsert, entry);
+
+    expire();
+
+    // incremental maintenance: at most one segment per insertion
+    if (!pendingCompaction.isEmpty())
+        compactSegment(pendingCompaction.takeFirst());
+    if (journalRecords > 2 * entries.size() + JournalSlack)
+        writeSnapshot();
+}
+
+/*!
+    Accounts for a record of \a size bytes in \a segment no longer being
+    referenced, and removes or schedules the segment for compaction.
+*/
+void QNetworkIndexedDiskCachePrivate::releaseRecord(quint32 segment, qint64 size)
+{
+    const auto it = segments.find(segment);
+    if (it == segments.end())
+        return;
+    it->liveBytes -= size;
+    if (segment == currentSegment)
+        return;
+    if (it->liveBytes <= 0) {
+        QFile::remove(segmentFileName(segment, it->dedicated));
+        segments.erase(it);
+        pendingCompaction.removeOne(segment);
+    } else if (!it->dedicated && it->liveBytes * 2 < it->size
+               && !pendingCompaction.contains(segment)) {
+        pendingCompaction.append(segment);
+    }
+}
+
+void QNetworkIndexedDiskCachePrivate::removeEntry(Entry *entry, bool writeJournal)
+{
+    if (writeJournal)
+        appendJournal(JournalRemove, entry);
+    if (entry->key == lastKey)
+        lastKey.clear();
+    unlink(entry);
+    entries.remove(entry->key);
+    currentCacheSize -= entry->recordSize();
+    releaseRecord(entry->segment, entry->recordSize());
+    delete entry;
+}
+
+void QNetworkIndexedDiskCachePrivate::expire()
+{
+    if (currentCacheSize <= maximumCacheSize)
+        return;
+
+    const qint64 goal = (maximumCacheSize * 9) / 10;
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    const int count = entries.size();
+#endif
+    while (leastRecent && currentCacheSize > goal)
+        removeEntry(leastRecent, true);
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::expire()"
+             << "Removed:" << count - entries.size()
+             << "Kept:" << entries.size();
+#endif
+}
+
+/*!
+    Moves the live records of \a segment to the end of the current segment
+    and removes it.
+*/
+void QNetworkIndexedDiskCachePrivate::compactSegment(quint32 segment)
+{
+    const auto it = segments.constFind(segment);
+    if (it == segments.cend() || it->dedicated || segment == currentSegment)
+        return;
+
+    bool ok = scanSegment(segment, false,
+                          [this, segment](const RecordHeader &header, qint64 offset, QFile &file) {
+        Entry *entry = entries.value(QByteArray::fromRawData(header.key, KeySize));
+        if (!entry || entry->segment != segment || entry->offset != offset)
+            return true;
+        const QByteArray record = file.read(header.recordSize() - RecordHeaderSize);
+        if (record.size() != header.recordSize() - RecordHeaderSize)
+            return false;
+        quint32 newSegment;
+        qint64 newOffset;
+        if (!appendToCurrentSegment(header.toByteArray() + record, &newSegment, &newOffset))
+            return false;
+        segments[segment].liveBytes -= entry->recordSize();
+        segments[newSegment].liveBytes += entry->recordSize();
+        entry->segment = newSegment;
+        entry->offset = newOffset;
+        appendJournal(JournalMove, entry);
+        return true;
+    });
+
+    const auto compacted = segments.find(segment);
+    if (ok && compacted != segments.end() && compacted->liveBytes <= 0) {
+        QFile::remove(segmentFileName(segment, false));
+        segments.erase(compacted);
+    }
+}
+
+void QNetworkIndexedDiskCachePrivate::removeAll()
+{
+    if (storageDirectory.isEmpty())
+        return;
+    currentSegmentFile.close();
+    for (auto it = segments.cbegin(), end = segments.cend(); it != end; ++it)
+        QFile::remove(segmentFileName(it.key(), it->dedicated));
+    qDeleteAll(entries);
+    entries.clear();
+    mostRecent = leastRecent = nullptr;
+    segments.clear();
+    pendingCompaction.clear();
+    currentSegment = 0;
+    currentCacheSize = 0;
+    lastKey.clear();
+    lastMetaData = QNetworkCacheMetaData();
+    writeSnapshot();
+}
+
+void QNetworkIndexedDiskCachePrivate::linkFront(Entry *entry)
+{
+    entry->prev = nullptr;
+    entry->next = mostRecent;
+    if (mostRecent)
+        mostRecent->prev = entry;
+    mostRecent = entry;
+    if (!leastRecent)
+        leastRecent = entry;
+}
+
+void QNetworkIndexedDiskCachePrivate::unlink(Entry *entry)
+{
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        mostRecent = entry->next;
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        leastRecent = entry->prev;
+    entry->prev = entry->next = nullptr;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QNETWORKINDEXEDDISKCACHE_H
+#define QNETWORKINDEXEDDISKCACHE_H
+
+#include <QtNetwork/qtnetworkglobal.h>
+#include <QtNetwork/qabstractnetworkcache.h>
+
+QT_REQUIRE_CONFIG(networkdiskcache);
+
+QT_BEGIN_NAMESPACE
+
+class QNetworkIndexedDiskCachePrivate;
+class Q_NETWORK_EXPORT QNetworkIndexedDiskCache : public QAbstractNetworkCache
+{
+    Q_OBJECT
+
+public:
+    explicit QNetworkIndexedDiskCache(QObject *parent = nullptr);
+    ~QNetworkIndexedDiskCache();
+
+    QString cacheDirectory() const;
+    void setCacheDirectory(const QString &cacheDir);
+
+    qint64 maximumCacheSize() const;
+    void setMaximumCacheSize(qint64 size);
+
+    qint64 cacheSize() const override;
+    QNetworkCacheMetaData metaData(const QUrl &url) override;
+    void updateMetaData(const QNetworkCacheMetaData &metaData) override;
+    QIODevice *data(const QUrl &url) override;
+    bool remove(const QUrl &url) override;
+    QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
+    void insert(QIODevice *device) override;
+
+public Q_SLOTS:
+    void clear() override;
+    void flush();
+
+private:
+    Q_DECLARE_PRIVATE(QNetworkIndexedDiskCache)
+    Q_DISABLE_COPY(QNetworkIndexedDiskCache)
+};
+
+QT_END_NAMESPACE
+
+#endif // QNETWORKINDEXEDDISKCACHE_H
@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QNETWORKINDEXEDDISKCACHE_P_H
+#define QNETWORKINDEXEDDISKCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include "private/qabstractnetworkcache_p.h"
+
+#include <qbuffer.h>
+#include <qfile.h>
+#include <qhash.h>
+#include <qtemporaryfile.h>
+#include <qvector.h>
+
+QT_REQUIRE_CONFIG(networkdiskcache);
+
+QT_BEGIN_NAMESPACE
+
+class QNetworkIndexedDiskCache;
+
+namespace QNetworkIndexedDiskCacheStorage {
+
+enum {
+    KeySize = 20,                       // SHA-1 of the URL
+    RecordHeaderSize = 40,
+    SegmentSize = 16 * 1024 * 1024,     // small records are packed into segments of this size
+    DedicatedSegmentThreshold = 1024 * 1024
+};
+
+// Record header at the start of each record in a segment file
+struct RecordHeader
+{
+    enum Flag { Compressed = 0x1 };
+
+    quint32 flags;
+    char key[KeySize];
+    quint32 metaDataSize;
+    quint64 bodySize;
+
+    QByteArray toByteArray() const;
+    bool fromByteArray(const char *data);
+    qint64 recordSize() const
+    { return RecordHeaderSize + qint64(metaDataSize) + qint64(bodySize); }
+};
+
+struct Entry
+{
+    QByteArray key;
+    Entry *prev = nullptr;              // towards the most recently used entry
+    Entry *next = nullptr;              // towards the least recently used entry
+    qint64 offset = 0;
+    qint64 bodySize = 0;
+    quint32 segment = 0;
+    quint32 metaDataSize = 0;
+    bool compressed = false;
+
+    qint64 recordSize() const
+    { return RecordHeaderSize + qint64(metaDataSize) + bodySize; }
+};
+
+struct Segment
+{
+    qint64 size = 0;
+    qint64 liveBytes = 0;
+    bool dedicated = false;
+};
+
+} // namespace QNetworkIndexedDiskCacheStorage
+
+class QNetworkIndexedDiskCachePrivate : public QAbstractNetworkCachePrivate
+{
+    Q_DECLARE_PUBLIC(QNetworkIndexedDiskCache)
+public:
+    typedef QNetworkIndexedDiskCacheStorage::Entry Entry;
+    typedef QNetworkIndexedDiskCacheStorage::Segment Segment;
+    typedef QNetworkIndexedDiskCacheStorage::RecordHeader RecordHeader;
+
+    // an item between prepare() and insert()
+    struct PendingItem
+    {
+        QNetworkCacheMetaData metaData;
+        QByteArray metaDataBlob;
+        QBuffer buffer;
+        QTemporaryFile *file = nullptr;     // large bodies go into their own segment
+        bool compress = false;
+
+        ~PendingItem() { delete file; }
+    };
+
+    enum JournalOp : quint8 {
+        JournalInsert = 1,  // new location, most recently used
+        JournalMove,        // new location after compaction, same position in the LRU list
+        JournalTouch,       // most recently used
+        JournalRemove
+    };
+
+    QNetworkIndexedDiskCachePrivate()
+        : maximumCacheSize(1024 * 1024 * 50)
+    {}
+    ~QNetworkIndexedDiskCachePrivate();
+
+    static QByteArray cacheKey(const QUrl &url);
+    static bool canCompress(const QNetworkCacheMetaData &metaData);
+    static QByteArray serializeMetaData(const QNetworkCacheMetaData &metaData);
+
+    QString segmentFileName(quint32 segment, bool dedicated) const;
+    QString journalFileName() const;
+
+    void open();
+    void close();
+    bool replayJournal(bool *needsSnapshot);
+    void rebuildFromSegments();
+    void reconcileSegments();
+    void writeSnapshot();
+    void appendJournal(JournalOp op, const Entry *entry);
+
+    template <typename Visitor>
+    bool scanSegment(quint32 segment, bool dedicated, Visitor visitor) const;
+
+    Entry *lookup(const QByteArray &key, bool touch);
+    Entry *placeEntry(const QByteArray &key, quint32 segment, qint64 offset,
+                      const RecordHeader &header);
+    bool appendToCurrentSegment(const QByteArray &record, quint32 *segment, qint64 *offset);
+    bool writeDedicatedSegment(const QByteArray &record, quint32 *segment);
+    void storeItem(PendingItem *item);
+    void releaseRecord(quint32 segment, qint64 size);
+    void removeEntry(Entry *entry, bool writeJournal);
+    void expire();
+    void compactSegment(quint32 segment);
+    void removeAll();
+
+    void linkFront(Entry *entry);
+    void unlink(Entry *entry);
+
+    QString cacheDirectory;
+    QString storageDirectory;
+    qint64 maximumCacheSize;
+    qint64 currentCacheSize = 0;
+
+    QHash<QByteArray, Entry *> entries;
+    Entry *mostRecent = nullptr;
+    Entry *leastRecent = nullptr;
+
+    QHash<quint32, Segment> segments;
+    quint32 currentSegment = 0;
+    quint32 nextSegment = 1;
+    QFile currentSegmentFile;
+    QVector<quint32> pendingCompaction;
+
+    QFile journal;
+    qint64 journalRecords = 0;
+
+    QHash<QIODevice *, PendingItem *> inserting;
+
+    // metaData() is usually followed by data() for the same URL
+    QByteArray lastKey;
+    QNetworkCacheMetaData lastMetaData;
+};
+
+QT_END_NAMESPACE
+
+#endif // QNETWORKINDEXEDDISKCACHE_P_H
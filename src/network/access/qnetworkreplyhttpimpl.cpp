@@ -796,6 +796,12 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     const QVariant blob(manager->property(Http2::http2ParametersPropertyName));
     if (blob.isValid() && blob.canConvert<Http2::ProtocolParameters>())
         delegate->http2Parameters = blob.value<Http2::ProtocolParameters>();
+    // and the HTTP/1.1 connection pool settings
+    const int connectionsPerHost = request.attribute(QNetworkRequest::HttpConnectionsPerHostAttribute).toInt();
+    if (connectionsPerHost > 0 && connectionsPerHost != QHttpNetworkConnectionPrivate::defaultHttpChannelCount)
+        delegate->connectionsPerHost = qMin(connectionsPerHost, 0xffff);
+    delegate->connectionIdleTimeout
+            = qMax(0, request.attribute(QNetworkRequest::HttpConnectionIdleTimeoutAttribute).toInt());
 #ifndef QT_NO_BEARERMANAGEMENT
     delegate->networkSession = managerPrivate->getNetworkSession();
 #endif
@@ -850,10 +856,11 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
         QObject::connect(delegate, SIGNAL(downloadMetaData(QList<QPair<QByteArray,QByteArray> >,
                                                            int, QString, bool,
                                                            QSharedPointer<char>, qint64, qint64,
-                                                           bool)),
+                                                           bool, bool, qint64, int)),
                 q, SLOT(replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,
                                               int, QString, bool,
-                                              QSharedPointer<char>, qint64, qint64, bool)),
+                                              QSharedPointer<char>, qint64, qint64, bool,
+                                              bool, qint64, int)),
                 Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(downloadProgress(qint64,qint64)),
                 q, SLOT(replyDownloadProgressSlot(qint64,qint64)),
@@ -963,7 +970,10 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
                      QSharedPointer<char>(),
                      delegate->incomingContentLength,
                      delegate->removedContentLength,
-                     delegate->isSpdyUsed);
+                     delegate->isSpdyUsed,
+                     delegate->isConnectionReused,
+                     delegate->connectionWaitTime,
+                     delegate->queueDepth);
             replyDownloadData(delegate->synchronousDownloadData);
             httpError(delegate->incomingErrorCode, delegate->incomingErrorDetail);
         } else {
@@ -975,7 +985,10 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
                      QSharedPointer<char>(),
                      delegate->incomingContentLength,
                      delegate->removedContentLength,
-                     delegate->isSpdyUsed);
+                     delegate->isSpdyUsed,
+                     delegate->isConnectionReused,
+                     delegate->connectionWaitTime,
+                     delegate->queueDepth);
             replyDownloadData(delegate->synchronousDownloadData);
         }
 
@@ -1269,7 +1282,10 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData(const QList<QPair<QByte
                                                          QSharedPointer<char> db,
                                                          qint64 contentLength,
                                                          qint64 removedContentLength,
-                                                         bool spdyWasUsed)
+                                                         bool spdyWasUsed,
+                                                         bool connectionReused,
+                                                         qint64 connectionWaitTime,
+                                                         int queueDepth)
 {
     Q_Q(QNetworkReplyHttpImpl);
     Q_UNUSED(contentLength);
@@ -1305,6 +1321,11 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData(const QList<QPair<QByte
         q->setAttribute(QNetworkRequest::SpdyWasUsedAttribute, spdyWasUsed);
         q->setAttribute(QNetworkRequest::HTTP2WasUsedAttribute, false);
     }
+    if (!spdyWasUsed) {
+        q->setAttribute(QNetworkRequest::HttpConnectionWasReusedAttribute, connectionReused);
+        q->setAttribute(QNetworkRequest::HttpConnectionWaitTimeAttribute, connectionWaitTime);
+        q->setAttribute(QNetworkRequest::HttpQueueDepthAttribute, queueDepth);
+    }
 
     // reconstruct the HTTP header
     QList<QPair<QByteArray, QByteArray> > headerMap = hm;
@@ -331,6 +331,42 @@ QT_BEGIN_NAMESPACE
 
     \omitvalue ResourceTypeAttribute
 
+    \value HttpConnectionsPerHostAttribute
+        Requests only, type: QMetaType::Int (default: 6)
+        The number of HTTP/1.1 connections QNetworkAccessManager opens
+        in parallel to the host and port of the request. Requests beyond
+        that wait until one of the connections is free. Requests that ask
+        for different values do not share connections.
+        (This value was introduced in 5.14.)
+
+    \value HttpConnectionIdleTimeoutAttribute
+        Requests only, type: QMetaType::Int (default: 120)
+        The number of seconds the HTTP connections to the host and port
+        of the request are kept open for reuse after the last request
+        using them has finished. Requests that ask for different values
+        do not share connections.
+        (This value was introduced in 5.14.)
+
+    \value HttpConnectionWasReusedAttribute
+        Replies only, type: QMetaType::Bool
+        Indicates whether the request was sent over an HTTP/1.1
+        connection that had already carried an earlier request, as
+        opposed to one opened for it.
+        (This value was introduced in 5.14.)
+
+    \value HttpConnectionWaitTimeAttribute
+        Replies only, type: QMetaType::LongLong
+        The number of milliseconds the request was queued before an
+        HTTP/1.1 connection was free to send it.
+        (This value was introduced in 5.14.)
+
+    \value HttpQueueDepthAttribute
+        Replies only, type: QMetaType::Int
+        The number of requests to the same host and port that were
+        already waiting for a free HTTP/1.1 connection when this request
+        was queued.
+        (This value was introduced in 5.14.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
@@ -98,6 +98,11 @@ public:
         RedirectPolicyAttribute,
         Http2DirectAttribute,
         ResourceTypeAttribute, // internal
+        HttpConnectionsPerHostAttribute,
+        HttpConnectionIdleTimeoutAttribute,
+        HttpConnectionWasReusedAttribute,
+        HttpConnectionWaitTimeAttribute,
+        HttpQueueDepthAttribute,
 
         User = 1000,
         UserMax = 32767
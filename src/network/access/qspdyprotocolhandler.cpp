@@ -296,10 +296,9 @@ bool QSpdyProtocolHandler::sendRequest()
 
     int requestsToSend = qMin(m_channel->spdyRequestsToSend.size(), maxPossibleRequests);
 
-    QMultiMap<int, HttpMessagePair>::iterator it = m_channel->spdyRequestsToSend.begin();
-    // requests will be ordered by priority (see QMultiMap doc)
+    // requests are dequeued in priority order
     for (int a = 0; a < requestsToSend; ++a) {
-        HttpMessagePair currentPair = *it;
+        HttpMessagePair currentPair = m_channel->spdyRequestsToSend.dequeue();
         QHttpNetworkRequest currentRequest = currentPair.first;
         QHttpNetworkReply *currentReply = currentPair.second;
 
@@ -314,7 +313,6 @@ bool QSpdyProtocolHandler::sendRequest()
         connect(currentReply, SIGNAL(destroyed(QObject*)), this, SLOT(_q_replyDestroyed(QObject*)));
 
         sendSYN_STREAM(currentPair, streamID, /* associatedToStreamID = */ 0);
-        m_channel->spdyRequestsToSend.erase(it++);
     }
     m_channel->state = QHttpNetworkConnectionChannel::IdleState;
     return true;
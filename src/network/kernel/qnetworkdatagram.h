@@ -105,6 +105,8 @@ private:
     QNetworkDatagramPrivate *d;
     friend class QUdpSocket;
     friend class QSctpSocket;
+    friend class QAbstractSocketEngine;
+    friend class QNativeSocketEnginePrivate;
 
     explicit QNetworkDatagram(QNetworkDatagramPrivate &dd);
     QNetworkDatagram makeReply_helper(const QByteArray &data) const;
@@ -473,6 +473,7 @@
 #include <qpointer.h>
 #include <qtimer.h>
 #include <qelapsedtimer.h>
+#include <qfile.h>
 #include <qscopedvaluerollback.h>
 #include <qvarlengtharray.h>
 
@@ -569,6 +570,9 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       readBufferMaxSize(0),
       isBuffered(false),
       hasPendingData(false),
+      pendingFileOffset(0),
+      pendingFileBytes(0),
+      bytesBeforeFile(0),
       connectTimer(0),
       hostLookupId(-1),
       socketType(QAbstractSocket::UnknownSocketType),
@@ -599,6 +603,8 @@ void QAbstractSocketPrivate::resetSocketLayer()
 #endif
 
     hasPendingData = false;
+    pendingFile.clear();
+    pendingFileBytes = 0;
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -829,7 +835,7 @@ void QAbstractSocketPrivate::connectionNotification()
 bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
-    if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
+    if (!socketEngine || !socketEngine->isValid() || (!hasPendingWrites()
         && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
@@ -847,9 +853,16 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
+    if (pendingFileBytes > 0 && bytesBeforeFile == 0)
+        return writeFileToSocket();
+
     qint64 nextSize = writeBuffer.nextDataBlockSize();
     const char *ptr = writeBuffer.readPointer();
 
+    // data written after sendFile() has to wait for the file
+    if (pendingFileBytes > 0)
+        nextSize = qMin(nextSize, bytesBeforeFile);
+
     // Attempt to write it all in one chunk.
     qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
     if (written < 0) {
@@ -871,12 +884,65 @@ bool QAbstractSocketPrivate::writeToSocket()
     if (written > 0) {
         // Remove what we wrote so far.
         writeBuffer.free(written);
+        if (pendingFileBytes > 0)
+            bytesBeforeFile -= written;
 
         // Emit notifications.
         emitBytesWritten(written);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (!hasPendingWrites() && socketEngine && !socketEngine->bytesToWrite())
+        socketEngine->setWriteNotificationEnabled(false);
+    if (state == QAbstractSocket::ClosingState)
+        q->disconnectFromHost();
+
+    return written > 0;
+}
+
+/*! \internal
+
+    Writes as much of the file queued by sendFile() as the socket takes,
+    letting the socket engine copy it inside the kernel.
+
+    Emits bytesWritten().
+*/
+bool QAbstractSocketPrivate::writeFileToSocket()
+{
+    Q_Q(QAbstractSocket);
+    if (!pendingFile || !pendingFile->isOpen()) {
+        pendingFileBytes = 0;
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("File was closed before it was sent"));
+        q->abort();
+        return false;
+    }
+
+    qint64 written = socketEngine->sendFile(pendingFile->handle(), pendingFileOffset, pendingFileBytes);
+    if (written < 0) {
+#if defined (QABSTRACTSOCKET_DEBUG)
+        qDebug() << "QAbstractSocketPrivate::writeFileToSocket() write error, aborting."
+                 << socketEngine->errorString();
+#endif
+        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+        q->abort();
+        return false;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::writeFileToSocket() %lld bytes written to the network",
+           written);
+#endif
+
+    if (written > 0) {
+        pendingFileOffset += written;
+        pendingFileBytes -= written;
+        if (pendingFileBytes == 0)
+            pendingFile.clear();
+
+        emitBytesWritten(written);
+    }
+
+    if (!hasPendingWrites() && socketEngine && !socketEngine->bytesToWrite())
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
@@ -894,7 +960,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while ((!allWriteBuffersEmpty() || pendingFileBytes > 0) && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -1791,7 +1857,7 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    const qint64 pendingBytes = QIODevice::bytesToWrite() + d_func()->pendingFileBytes;
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -2254,7 +2320,7 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
 
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2306,7 +2372,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (!d->hasPendingWrites())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2323,7 +2389,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !d->readBufferMaxSize || d->buffer.size() < d->readBufferMaxSize,
-                                  !d->writeBuffer.isEmpty(),
+                                  d->hasPendingWrites(),
                                   qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2402,7 +2468,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2495,6 +2561,78 @@ bool QAbstractSocket::flush()
     return d_func()->flush();
 }
 
+/*!
+    \since 5.14
+
+    Queues \a length bytes of \a file, starting at \a offset, for
+    sending on the socket. If \a length is -1, everything from \a offset
+    to the end of the file is sent. Returns the number of bytes queued,
+    or -1 if an error occurred.
+
+    The data is sent after anything that was written before the call and
+    before anything written after it, and progress is reported through
+    the bytesWritten() signal as for write().
+
+    On Linux, a connected TCP socket sends the file with \c sendfile(),
+    so the data is copied from the file to the network inside the kernel
+    and never enters the socket's write buffer. In that case \a file
+    must stay open until its data has been written, that is, until
+    bytesToWrite() no longer counts it; the file's current position is
+    not used or changed. Otherwise, for instance for QSslSocket or when
+    connecting through a proxy, the data is read from \a file and
+    buffered as if passed to write().
+
+    \a file must be open for reading and must not be sequential.
+
+    \sa write(), bytesToWrite()
+*/
+qint64 QAbstractSocket::sendFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_D(QAbstractSocket);
+    if (!file || !file->isReadable() || file->isSequential()) {
+        qWarning("QAbstractSocket::sendFile: file must be open for reading and not sequential");
+        return -1;
+    }
+    const qint64 fileSize = file->size();
+    if (offset < 0 || offset > fileSize) {
+        qWarning("QAbstractSocket::sendFile: offset %lld is outside of the file", offset);
+        return -1;
+    }
+    if (length < 0 || length > fileSize - offset)
+        length = fileSize - offset;
+    if (length == 0)
+        return 0;
+
+    if (d->state == ConnectedState && isWritable() && d->pendingFileBytes == 0
+        && d->socketEngine && d->socketEngine->canSendFile() && file->handle() != -1) {
+        // make data written through the QFile visible to the kernel
+        if (file->isWritable())
+            file->flush();
+
+        d->pendingFile = file;
+        d->pendingFileOffset = offset;
+        d->pendingFileBytes = length;
+        d->bytesBeforeFile = d->writeBuffer.size();
+        d->socketEngine->setWriteNotificationEnabled(true);
+        return length;
+    }
+
+    // no kernel support: go through the write buffer like write() would
+    const qint64 oldPos = file->pos();
+    if (!file->seek(offset))
+        return -1;
+    qint64 remaining = length;
+    QByteArray chunk;
+    while (remaining > 0) {
+        chunk = file->read(qMin(remaining, qint64(QABSTRACTSOCKET_BUFFERSIZE)));
+        if (chunk.isEmpty() || write(chunk) != chunk.size())
+            break;
+        remaining -= chunk.size();
+    }
+    file->seek(oldPos);
+    return remaining == length ? qint64(-1) : length - remaining;
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -2548,7 +2686,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && !d->hasPendingWrites()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2779,7 +2917,7 @@ void QAbstractSocket::disconnectFromHost()
 
         // Wait for pending data to be written.
         if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
-            || d->socketEngine->bytesToWrite() > 0)) {
+            || d->pendingFileBytes > 0 || d->socketEngine->bytesToWrite() > 0)) {
             d->socketEngine->setWriteNotificationEnabled(true);
 
 #if defined(QABSTRACTSOCKET_DEBUG)
@@ -55,6 +55,7 @@
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qtimer.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
@@ -63,6 +64,7 @@
 QT_BEGIN_NAMESPACE
 
 class QHostInfo;
+class QFile;
 
 class QAbstractSocketPrivate : public QIODevicePrivate, public QAbstractSocketEngineReceiver
 {
@@ -140,6 +142,9 @@ public:
     void fetchConnectionParameters();
     bool readFromSocket();
     virtual bool writeToSocket();
+    bool writeFileToSocket();
+    inline bool hasPendingWrites() const
+    { return !writeBuffer.isEmpty() || pendingFileBytes > 0; }
     void emitReadyRead(int channel = 0);
     void emitBytesWritten(qint64 bytes, int channel = 0);
 
@@ -150,6 +155,13 @@ public:
     bool isBuffered;
     bool hasPendingData;
 
+    // range of a file queued by sendFile(); it is sent once the first
+    // bytesBeforeFile bytes of the write buffer have gone out
+    QPointer<QFile> pendingFile;
+    qint64 pendingFileOffset;
+    qint64 pendingFileBytes;
+    qint64 bytesBeforeFile;
+
     QTimer *connectTimer;
 
     int hostLookupId;
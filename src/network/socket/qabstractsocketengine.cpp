@@ -46,6 +46,7 @@
 #endif
 
 #include "qmutex.h"
+#include "qnetworkdatagram.h"
 #include "qnetworkproxy.h"
 
 QT_BEGIN_NAMESPACE
@@ -273,4 +274,86 @@ int QAbstractSocketEngine::outboundStreamCount() const
     return d_func()->outboundStreamCount;
 }
 
+/*
+    Returns \c true if sendFile() can copy data from a file descriptor
+    straight to the socket, without going through user space.
+
+    This implementation returns \c false; the caller then has to read
+    the file and write() its contents itself.
+*/
+bool QAbstractSocketEngine::canSendFile() const
+{
+    return false;
+}
+
+/*
+    Writes up to \a len bytes of the file open on \a fileDescriptor,
+    starting at \a offset, to the socket. Returns the number of bytes
+    written, which is 0 if the socket cannot take more data right now,
+    or -1 on error. The file's own position is not changed.
+
+    Only call this function if canSendFile() returns \c true.
+*/
+qint64 QAbstractSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 len)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(len);
+    setError(QAbstractSocket::UnsupportedSocketOperationError,
+             QLatin1String("Unsupported socket operation"));
+    return -1;
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*
+    Appends up to \a maxCount pending datagrams of at most \a maxSize
+    bytes each (the full datagram if \a maxSize is -1) to \a datagrams.
+    Returns the number of datagrams read, -2 if none was pending, or -1
+    on error.
+
+    This implementation reads one datagram at a time; engines that can
+    receive several with one system call reimplement it.
+*/
+int QAbstractSocketEngine::readDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount,
+                                         qint64 maxSize, PacketHeaderOptions options)
+{
+    int count = 0;
+    while (count < maxCount && hasPendingDatagrams()) {
+        const qint64 size = maxSize < 0 ? pendingDatagramSize() : maxSize;
+        if (size < 0)
+            break;
+        QNetworkDatagramPrivate *dd = new QNetworkDatagramPrivate(QByteArray(size, Qt::Uninitialized));
+        const qint64 readBytes = readDatagram(dd->data.data(), size, &dd->header, options);
+        if (readBytes < 0) {
+            delete dd;
+            if (count)
+                break;
+            return int(readBytes);
+        }
+        dd->data.truncate(readBytes);
+        datagrams->append(QNetworkDatagram(*dd));
+        ++count;
+    }
+    return count ? count : -2;
+}
+
+/*
+    Sends the \a count datagrams in \a datagrams, in order. Returns the
+    number of datagrams sent, which is smaller than \a count if the
+    engine would block or failed after sending some, -2 if it would block
+    before sending any, or -1 on error.
+*/
+int QAbstractSocketEngine::writeDatagrams(const QNetworkDatagram *datagrams, int count)
+{
+    int sent = 0;
+    for ( ; sent < count; ++sent) {
+        const QNetworkDatagramPrivate *dd = datagrams[sent].d;
+        const qint64 result = writeDatagram(dd->data.constData(), dd->data.size(), dd->header);
+        if (result < 0)
+            return sent ? sent : int(result);
+    }
+    return sent;
+}
+#endif // QT_NO_UDPSOCKET
+
 QT_END_NAMESPACE
@@ -64,6 +64,7 @@ class QAuthenticator;
 class QAbstractSocketEnginePrivate;
 #ifndef QT_NO_NETWORKINTERFACE
 class QNetworkInterface;
+class QNetworkDatagram;
 #endif
 class QNetworkProxy;
 
@@ -106,7 +107,8 @@ public:
         ReceivePacketInformation,
         ReceiveHopLimit,
         MaxStreamsSocketOption,
-        PathMtuInformation
+        PathMtuInformation,
+        PortReusable
     };
 
     enum PacketHeaderOption {
@@ -153,6 +155,10 @@ public:
 
     virtual bool hasPendingDatagrams() const = 0;
     virtual qint64 pendingDatagramSize() const = 0;
+
+    virtual int readDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount, qint64 maxlen = -1,
+                              PacketHeaderOptions = WantNone);
+    virtual int writeDatagrams(const QNetworkDatagram *datagrams, int count);
 #endif // QT_NO_UDPSOCKET
 
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = 0,
@@ -160,6 +166,9 @@ public:
     virtual qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &header) = 0;
     virtual qint64 bytesToWrite() const = 0;
 
+    virtual bool canSendFile() const;
+    virtual qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 len);
+
     virtual int option(SocketOption option) const = 0;
     virtual bool setOption(SocketOption option, int value) = 0;
 
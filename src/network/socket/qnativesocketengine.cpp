@@ -842,6 +842,54 @@ qint64 QNativeSocketEngine::pendingDatagramSize() const
 
     return d->nativePendingDatagramSize();
 }
+
+/*!
+    Appends up to \a maxCount pending datagrams to \a datagrams, each
+    truncated to \a maxSize bytes unless \a maxSize is -1. The IP header
+    fields are filled in according to \a options. Where the platform
+    supports it, the datagrams are received with as few system calls as
+    possible into a buffer that is reused between calls.
+
+    Returns the number of datagrams read, -2 if none was pending, or -1
+    if an error occurred.
+*/
+int QNativeSocketEngine::readDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount,
+                                       qint64 maxSize, PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#if QT_CONFIG(sendmmsg)
+    return d->nativeReceiveDatagrams(datagrams, maxCount, maxSize, options);
+#else
+    return QAbstractSocketEngine::readDatagrams(datagrams, maxCount, maxSize, options);
+#endif
+}
+
+/*!
+    Sends the \a count datagrams in \a datagrams, in order, and returns
+    the number of datagrams sent. This is less than \a count if the
+    socket buffer filled up or an error occurred after some datagrams
+    were sent. Returns -2 if no datagram could be sent without blocking,
+    or -1 if an error occurred.
+
+    \sa writeDatagram()
+*/
+int QNativeSocketEngine::writeDatagrams(const QNetworkDatagram *datagrams, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#if QT_CONFIG(sendmmsg)
+    return d->nativeSendDatagrams(datagrams, count);
+#else
+    return QAbstractSocketEngine::writeDatagrams(datagrams, count);
+#endif
+}
 #endif // QT_NO_UDPSOCKET
 
 /*!
@@ -918,6 +966,37 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    Returns \c true if sendFile() can copy file data to this socket
+    inside the kernel; this is the case for TCP sockets on Linux.
+*/
+bool QNativeSocketEngine::canSendFile() const
+{
+#if QT_CONFIG(sendfile)
+    Q_D(const QNativeSocketEngine);
+    return d->socketType == QAbstractSocket::TcpSocket;
+#else
+    return false;
+#endif
+}
+
+/*!
+    Writes up to \a len bytes of the file open on \a fileDescriptor,
+    starting at \a offset, to the socket without copying them through
+    user space. Returns the number of bytes written, or -1 if an error
+    occurred.
+*/
+qint64 QNativeSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 len)
+{
+#if QT_CONFIG(sendfile)
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeSendFile(fileDescriptor, offset, len);
+#else
+    return QAbstractSocketEngine::sendFile(fileDescriptor, offset, len);
+#endif
+}
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
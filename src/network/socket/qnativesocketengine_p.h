@@ -159,6 +159,10 @@ public:
 
     bool hasPendingDatagrams() const override;
     qint64 pendingDatagramSize() const override;
+
+    int readDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount, qint64 maxlen = -1,
+                      PacketHeaderOptions = WantNone) override;
+    int writeDatagrams(const QNetworkDatagram *datagrams, int count) override;
 #endif // QT_NO_UDPSOCKET
 
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = 0,
@@ -166,6 +170,9 @@ public:
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) override;
     qint64 bytesToWrite() const override;
 
+    bool canSendFile() const override;
+    qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 len) override;
+
 #if 0   // currently unused
     qint64 receiveBufferSize() const;
     void setReceiveBufferSize(qint64 bufferSize);
@@ -277,8 +284,19 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#if QT_CONFIG(sendmmsg)
+    int nativeReceiveDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount, qint64 maxLength,
+                               QAbstractSocketEngine::PacketHeaderOptions options);
+    int nativeSendDatagrams(const QNetworkDatagram *datagrams, int count);
+
+    // payload buffer of nativeReceiveDatagrams(), released by nativeClose()
+    QByteArray datagramBuffer;
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+#if QT_CONFIG(sendfile)
+    qint64 nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 length);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
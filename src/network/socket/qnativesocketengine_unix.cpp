@@ -46,6 +46,7 @@
 #include "qelapsedtimer.h"
 #include "qvarlengtharray.h"
 #include "qnetworkinterface.h"
+#include "qnetworkdatagram.h"
 #include <time.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -68,6 +69,9 @@
 #endif
 
 #include <netinet/tcp.h>
+#if QT_CONFIG(sendfile)
+#include <sys/sendfile.h>
+#endif
 #ifndef QT_NO_SCTP
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -240,6 +244,15 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
 #endif
         }
         break;
+
+    case QNativeSocketEngine::PortReusable:
+        // only where the kernel distributes the connections among the listeners
+#if defined(SO_REUSEPORT_LB)
+        n = SO_REUSEPORT_LB;
+#elif defined(SO_REUSEPORT) && defined(Q_OS_LINUX)
+        n = SO_REUSEPORT;
+#endif
+        break;
     }
 }
 
@@ -935,18 +948,94 @@ qint64 QNativeSocketEnginePrivate::nativePendingDatagramSize() const
     return qint64(recvResult);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
-                                                         QAbstractSocketEngine::PacketHeaderOptions options)
-{
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+// room for the ancillary data parsed by qt_socket_getPacketHeader(), in quintptrs
+static const size_t ReceiveControlWords = (CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
 #if !defined(IP_PKTINFO) && defined(IP_RECVIF) && defined(Q_OS_BSD4)
-                   + CMSG_SPACE(sizeof(sockaddr_dl))
+                                           + CMSG_SPACE(sizeof(sockaddr_dl))
+#endif
+#ifndef QT_NO_SCTP
+                                           + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+#endif
+                                           + sizeof(quintptr) - 1) / sizeof(quintptr);
+
+// room for the ancillary data written by qt_socket_setControlMessages(), in quintptrs
+static const size_t SendControlWords = (CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+#ifndef QT_NO_SCTP
+                                        + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+#endif
+                                        + sizeof(quintptr) - 1) / sizeof(quintptr);
+
+/*
+    Fills in the fields of \a header found in the ancillary data of the
+    received message \a msg.
+*/
+static void qt_socket_getPacketHeader(msghdr *msg, QIpPacketHeader *header)
+{
+    header->endOfRecord = (msg->msg_flags & MSG_EOR) != 0;
+
+    // parse the ancillary data
+    struct cmsghdr *cmsgptr;
+    for (cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != NULL;
+         cmsgptr = CMSG_NXTHDR(msg, cmsgptr)) {
+        if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
+            in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
+            header->ifindex = info->ipi6_ifindex;
+            if (header->ifindex)
+                header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
+        }
+
+#ifdef IP_PKTINFO
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
+            in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
+            header->ifindex = info->ipi_ifindex;
+        }
+#else
+#  ifdef IP_RECVDSTADDR
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
+            in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(addr->s_addr));
+        }
+#  endif
+#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
+            sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
+            header->ifindex = sdl->sdl_index;
+        }
+#  endif
 #endif
+
+        if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
+                && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
+                    || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
+            Q_STATIC_ASSERT(sizeof(header->hopLimit) == sizeof(int));
+            memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
+        }
+
 #ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+        if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
+            && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
+            sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
+
+            header->streamNumber = int(rcvInfo->sinfo_stream);
+        }
 #endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+    }
+}
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
+                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    // we use quintptr to force the alignment
+    quintptr cbuf[ReceiveControlWords];
 
     struct msghdr msg;
     struct iovec vec;
@@ -996,64 +1085,7 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
         Q_ASSERT(header);
         qt_socket_getPortAndAddress(&aa, &header->senderPort, &header->senderAddress);
         header->destinationPort = localPort;
-        header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
-
-        // parse the ancillary data
-        struct cmsghdr *cmsgptr;
-        for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != NULL;
-             cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
-            if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
-                in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
-                header->ifindex = info->ipi6_ifindex;
-                if (header->ifindex)
-                    header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
-            }
-
-#ifdef IP_PKTINFO
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
-                in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
-                header->ifindex = info->ipi_ifindex;
-            }
-#else
-#  ifdef IP_RECVDSTADDR
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
-                in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(addr->s_addr));
-            }
-#  endif
-#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
-                sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
-                header->ifindex = sdl->sdl_index;
-            }
-#  endif
-#endif
-
-            if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
-                    && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
-                        || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
-                Q_STATIC_ASSERT(sizeof(header->hopLimit) == sizeof(int));
-                memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
-            }
-
-#ifndef QT_NO_SCTP
-            if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
-                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
-                sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
-
-                header->streamNumber = int(rcvInfo->sinfo_stream);
-            }
-#endif
-        }
+        qt_socket_getPacketHeader(&msg, header);
     }
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
@@ -1068,37 +1100,19 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
     return qint64((maxSize || recvResult < 0) ? recvResult : Q_INT64_C(0));
 }
 
-qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+/*
+    Adds the ancillary data for the fields of \a header to \a msg, whose
+    msg_control must point to at least SendControlWords quintptrs, and
+    whose destination address, if any, must have been set already.
+*/
+static void qt_socket_setControlMessages(msghdr *msg, const QIpPacketHeader &header)
 {
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
-#ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
-#endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+    struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(msg->msg_control);
+    msg->msg_controllen = 0;
 
-    struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(cbuf);
-    struct msghdr msg;
-    struct iovec vec;
-    qt_sockaddr aa;
-
-    memset(&msg, 0, sizeof(msg));
-    memset(&aa, 0, sizeof(aa));
-    vec.iov_base = const_cast<char *>(data);
-    vec.iov_len = len;
-    msg.msg_iov = &vec;
-    msg.msg_iovlen = 1;
-    msg.msg_control = &cbuf;
-
-    if (header.destinationPort != 0) {
-        msg.msg_name = &aa.a;
-        setPortAndAddress(header.destinationPort, header.destinationAddress,
-                          &aa, &msg.msg_namelen);
-    }
-
-    if (msg.msg_namelen == sizeof(aa.a6)) {
+    if (msg->msg_namelen == sizeof(sockaddr_in6)) {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_HOPLIMIT;
@@ -1108,7 +1122,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         if (header.ifindex != 0 || !header.senderAddress.isNull()) {
             struct in6_pktinfo *data = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
             memset(data, 0, sizeof(*data));
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_PKTINFO;
@@ -1120,7 +1134,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         }
     } else {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IP;
             cmsgptr->cmsg_type = IP_TTL;
@@ -1142,7 +1156,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
             data->s_addr = htonl(header.senderAddress.toIPv4Address());
 #  endif
             cmsgptr->cmsg_level = IPPROTO_IP;
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
         }
@@ -1153,7 +1167,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     if (header.streamNumber != -1) {
         struct sctp_sndrcvinfo *data = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
         memset(data, 0, sizeof(*data));
-        msg.msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
+        msg->msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_level = IPPROTO_SCTP;
         cmsgptr->cmsg_type =  SCTP_SNDRCV;
@@ -1162,8 +1176,35 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     }
 #endif
 
-    if (msg.msg_controllen == 0)
-        msg.msg_control = 0;
+    if (msg->msg_controllen == 0)
+        msg->msg_control = nullptr;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+{
+    // we use quintptr to force the alignment
+    quintptr cbuf[SendControlWords];
+
+    struct msghdr msg;
+    struct iovec vec;
+    qt_sockaddr aa;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&aa, 0, sizeof(aa));
+    vec.iov_base = const_cast<char *>(data);
+    vec.iov_len = len;
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+    msg.msg_control = &cbuf;
+
+    if (header.destinationPort != 0) {
+        msg.msg_name = &aa.a;
+        setPortAndAddress(header.destinationPort, header.destinationAddress,
+                          &aa, &msg.msg_namelen);
+    }
+
+    qt_socket_setControlMessages(&msg, header);
+
     ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
 
     if (sentBytes < 0) {
@@ -1195,6 +1236,164 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+#if QT_CONFIG(sendmmsg)
+// the most datagrams handled by one recvmmsg() or sendmmsg() call
+static const int DatagramBatchSize = 64;
+// no UDP datagram is larger than this
+static const int MaxDatagramSize = 65536;
+
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount,
+                                                       qint64 maxSize,
+                                                       QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    struct mmsghdr msgs[DatagramBatchSize];
+    struct iovec vecs[DatagramBatchSize];
+    qt_sockaddr addresses[DatagramBatchSize];
+    // we use quintptr to force the alignment
+    quintptr cbufs[DatagramBatchSize][ReceiveControlWords];
+
+    // we need to receive at least one byte, even if our user isn't interested in it
+    const int slotSize = maxSize < 0 ? MaxDatagramSize : int(qBound<qint64>(1, maxSize, MaxDatagramSize));
+    const int bufferSize = qMin(maxCount, DatagramBatchSize) * slotSize;
+    // kept until the socket is closed, so that reading does not allocate
+    if (datagramBuffer.size() < bufferSize)
+        datagramBuffer.resize(bufferSize);
+    char *buffer = datagramBuffer.data();
+
+    const bool wantHeader = options != QAbstractSocketEngine::WantNone;
+    const bool wantControl = options & (QAbstractSocketEngine::WantDatagramHopLimit
+                                        | QAbstractSocketEngine::WantDatagramDestination
+                                        | QAbstractSocketEngine::WantStreamNumber);
+
+    int count = 0;
+    while (count < maxCount) {
+        const int batch = qMin(maxCount - count, DatagramBatchSize);
+        memset(msgs, 0, batch * sizeof(mmsghdr));
+        for (int i = 0; i < batch; ++i) {
+            struct msghdr &msg = msgs[i].msg_hdr;
+            vecs[i].iov_base = buffer + i * slotSize;
+            vecs[i].iov_len = slotSize;
+            msg.msg_iov = &vecs[i];
+            msg.msg_iovlen = 1;
+            if (wantHeader) {
+                msg.msg_name = &addresses[i];
+                msg.msg_namelen = sizeof(qt_sockaddr);
+            }
+            if (wantControl) {
+                msg.msg_control = cbufs[i];
+                msg.msg_controllen = sizeof(cbufs[i]);
+            }
+        }
+
+        const int received = qt_safe_recvmmsg(socketDescriptor, msgs, batch, 0);
+        if (received == -1) {
+            if (count)
+                break;
+            switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                // No datagram was available for reading
+                return -2;
+            case ECONNREFUSED:
+                setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
+                break;
+            default:
+                setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+            }
+            return -1;
+        }
+
+        for (int i = 0; i < received; ++i) {
+            const int size = maxSize ? int(qMin(msgs[i].msg_len, uint(slotSize))) : 0;
+            QNetworkDatagramPrivate *dd = new QNetworkDatagramPrivate(QByteArray(buffer + i * slotSize, size));
+            if (wantHeader) {
+                qt_socket_getPortAndAddress(&addresses[i], &dd->header.senderPort,
+                                            &dd->header.senderAddress);
+                dd->header.destinationPort = localPort;
+                qt_socket_getPacketHeader(&msgs[i].msg_hdr, &dd->header);
+            }
+            datagrams->append(QNetworkDatagram(*dd));
+        }
+        count += received;
+        // a short batch means the receive queue is empty
+        if (received < batch)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%d, %lli) == %d", maxCount, maxSize, count);
+#endif
+
+    return count;
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const QNetworkDatagram *datagrams, int count)
+{
+    struct mmsghdr msgs[DatagramBatchSize];
+    struct iovec vecs[DatagramBatchSize];
+    qt_sockaddr addresses[DatagramBatchSize];
+    // we use quintptr to force the alignment
+    quintptr cbufs[DatagramBatchSize][SendControlWords];
+
+    int sent = 0;
+    while (sent < count) {
+        const int batch = qMin(count - sent, DatagramBatchSize);
+        memset(msgs, 0, batch * sizeof(mmsghdr));
+        for (int i = 0; i < batch; ++i) {
+            const QNetworkDatagramPrivate *dd = datagrams[sent + i].d;
+            struct msghdr &msg = msgs[i].msg_hdr;
+            vecs[i].iov_base = const_cast<char *>(dd->data.constData());
+            vecs[i].iov_len = dd->data.size();
+            msg.msg_iov = &vecs[i];
+            msg.msg_iovlen = 1;
+            msg.msg_control = cbufs[i];
+            if (dd->header.destinationPort != 0) {
+                msg.msg_name = &addresses[i].a;
+                setPortAndAddress(dd->header.destinationPort, dd->header.destinationAddress,
+                                  &addresses[i], &msg.msg_namelen);
+            }
+            qt_socket_setControlMessages(&msg, dd->header);
+        }
+
+        const int result = qt_safe_sendmmsg(socketDescriptor, msgs, batch, 0);
+        if (result == -1) {
+            // sendmmsg() only fails if the first datagram of the batch could
+            // not be sent; after a partial send, the next call reports it
+            if (sent)
+                break;
+            switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                return -2;
+            case EMSGSIZE:
+                setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+                break;
+            case ECONNRESET:
+                setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+                break;
+            default:
+                setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
+            }
+            return -1;
+        }
+        sent += result;
+        // the next datagram would block or fail, let the caller find out which
+        if (result < batch)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%d) == %d", count, sent);
+#endif
+
+    return sent;
+}
+#endif // QT_CONFIG(sendmmsg)
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -1324,6 +1523,9 @@ void QNativeSocketEnginePrivate::nativeClose()
 #endif
 
     qt_safe_close(socketDescriptor);
+#if QT_CONFIG(sendmmsg)
+    datagramBuffer = QByteArray();
+#endif
 }
 
 qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
@@ -1360,6 +1562,55 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+#if QT_CONFIG(sendfile)
+qint64 QNativeSocketEnginePrivate::nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 len)
+{
+    Q_Q(QNativeSocketEngine);
+
+    // sendfile(2) is limited in the kernel to 2G - 4k
+    const qint64 SendfileSize = 0x7ffff000;
+
+    off_t fileOffset = offset;
+    qt_ignore_sigpipe();
+    ssize_t writtenBytes;
+    EINTR_LOOP(writtenBytes, ::sendfile(socketDescriptor, int(fileDescriptor), &fileOffset,
+                                        size_t(qMin(len, SendfileSize))));
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        case EINVAL:
+        case ENOSYS:
+            // the file cannot be mapped (e.g. a pipe or a special file)
+            setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::UnknownSocketError, WriteErrorString);
+            break;
+        }
+    } else if (writtenBytes == 0 && len > 0) {
+        // a full socket gives EAGAIN, so this means the file ended early
+        writtenBytes = -1;
+        setError(QAbstractSocket::UnknownSocketError, ReadErrorString);
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%d, %lld, %lld) == %i",
+           int(fileDescriptor), offset, len, int(writtenBytes));
+#endif
+
+    return qint64(writtenBytes);
+}
+#endif // QT_CONFIG(sendfile)
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
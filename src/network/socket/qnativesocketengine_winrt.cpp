@@ -1652,6 +1652,7 @@ int QNativeSocketEnginePrivate::option(QAbstractSocketEngine::SocketOption opt)
     case QAbstractSocketEngine::TypeOfServiceOption:
     case QAbstractSocketEngine::MaxStreamsSocketOption:
     case QAbstractSocketEngine::PathMtuInformation:
+    case QAbstractSocketEngine::PortReusable:
     default:
         return -1;
     }
@@ -1713,6 +1714,7 @@ bool QNativeSocketEnginePrivate::setOption(QAbstractSocketEngine::SocketOption o
     case QAbstractSocketEngine::TypeOfServiceOption:
     case QAbstractSocketEngine::MaxStreamsSocketOption:
     case QAbstractSocketEngine::PathMtuInformation:
+    case QAbstractSocketEngine::PortReusable:
     default:
         return false;
     }
@@ -77,6 +77,13 @@
     use waitForNewConnection(), which blocks until either a
     connection is available or a timeout expires.
 
+    A server that accepts more connections than one thread can handle can
+    run one QTcpServer per worker thread, all listening on the same
+    address and port with setPortSharingEnabled(). The operating system
+    then distributes the incoming connections among them, and each
+    connection is handled in the thread that accepted it, without handing
+    socket descriptors from one thread to another.
+
     \sa QTcpSocket, {Fortune Server Example}, {Threaded Fortune Server Example},
         {Loopback Example}, {Torrent Example}
 */
@@ -124,6 +131,7 @@ QTcpServerPrivate::QTcpServerPrivate()
  , socketEngine(0)
  , serverSocketError(QAbstractSocket::UnknownSocketError)
  , maxConnections(30)
+ , portSharing(false)
 {
 }
 
@@ -329,6 +337,12 @@ bool QTcpServer::listen(const QHostAddress &address, quint16 port)
 
     d->configureCreatedSocket();
 
+    if (d->portSharing && !d->socketEngine->setOption(QAbstractSocketEngine::PortReusable, 1)) {
+        d->serverSocketError = QAbstractSocket::UnsupportedSocketOperationError;
+        d->serverSocketErrorString = tr("Port sharing is not supported on this platform");
+        return false;
+    }
+
     if (!d->socketEngine->bind(addr, port)) {
         d->serverSocketError = d->socketEngine->error();
         d->serverSocketErrorString = d->socketEngine->errorString();
@@ -657,6 +671,45 @@ int QTcpServer::maxPendingConnections() const
     return d_func()->maxConnections;
 }
 
+/*!
+    \since 5.14
+
+    If \a enable is true, the next call to listen() allows other servers
+    that also enabled port sharing to listen on the same address and port,
+    and the operating system distributes the incoming connections among
+    them. By default, port sharing is disabled.
+
+    This lets several threads or processes accept connections in parallel:
+    create one QTcpServer in each worker thread, enable port sharing and
+    call listen() with the same address and port in every thread. To share
+    a port chosen by the system, pass the serverPort() of the first server
+    to listen() for the others. Only servers of the same user can share a
+    port.
+
+    Port sharing is supported on Linux and FreeBSD, using the
+    SO_REUSEPORT and SO_REUSEPORT_LB socket options; on other platforms,
+    listen() fails with QAbstractSocket::UnsupportedSocketOperationError.
+
+    \sa isPortSharingEnabled(), listen()
+*/
+void QTcpServer::setPortSharingEnabled(bool enable)
+{
+    d_func()->portSharing = enable;
+}
+
+/*!
+    \since 5.14
+
+    Returns \c true if port sharing is enabled for the next call to
+    listen(); otherwise returns \c false.
+
+    \sa setPortSharingEnabled()
+*/
+bool QTcpServer::isPortSharingEnabled() const
+{
+    return d_func()->portSharing;
+}
+
 /*!
     Returns an error code for the last error that occurred.
 
@@ -72,6 +72,10 @@
     \note An incoming datagram should be read when you receive the readyRead()
     signal, otherwise this signal will not be emitted for the next datagram.
 
+    Applications that handle many datagrams can use receiveDatagrams() and
+    writeDatagrams() to transfer several of them at once, which needs fewer
+    system calls and readyRead() notifications.
+
     Example:
 
     \snippet code/src_network_socket_qudpsocket.cpp 0
@@ -431,6 +435,59 @@ qint64 QUdpSocket::writeDatagram(const QNetworkDatagram &datagram)
     return sent;
 }
 
+/*!
+    \since 5.14
+
+    Sends all datagrams in \a datagrams, in order, as writeDatagram() would
+    send each of them, and returns the number of datagrams sent. Where the
+    operating system supports it, several datagrams are passed to it with a
+    single system call.
+
+    The number returned is smaller than the size of \a datagrams if the
+    socket's send buffer filled up, or if sending one of the datagrams
+    failed after the ones before it were sent; in the latter case, sending
+    the remaining datagrams again reports the error. The function returns
+    -1 if it could not send any datagram because of an error.
+
+    The socket is initialized for the destination of the first datagram, so
+    all datagrams should be sent to addresses of the same protocol.
+    The bytesWritten() signal is emitted once, with the total size of the
+    datagrams sent.
+
+    \sa receiveDatagrams(), writeDatagram()
+*/
+int QUdpSocket::writeDatagrams(const QVector<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%d)", datagrams.size());
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.first().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    int sent = d->socketEngine->writeDatagrams(datagrams.constData(), datagrams.size());
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent == -2) {
+        // the send buffer is full
+        sent = 0;
+    } else if (sent < 0) {
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+        return -1;
+    }
+
+    qint64 bytes = 0;
+    for (int i = 0; i < sent; ++i)
+        bytes += datagrams.at(i).d->data.size();
+    if (sent)
+        emit bytesWritten(bytes);
+    return sent;
+}
+
 /*!
     \since 5.8
 
@@ -476,6 +533,44 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 5.14
+
+    Receives up to \a maxCount pending datagrams, each no larger than \a
+    maxSize bytes, and returns them along with the header information
+    receiveDatagram() provides. Where the operating system supports it,
+    several datagrams are received with a single system call into a buffer
+    that the socket reuses, instead of first querying the size of each one.
+
+    Returns an empty vector if no datagram is pending or on failure.
+
+    If \a maxSize is too small, the rest of each larger datagram will be
+    lost. If \a maxSize is -1 (the default), the datagrams are read
+    entirely.
+
+    \sa writeDatagrams(), receiveDatagram(), hasPendingDatagrams()
+*/
+QVector<QNetworkDatagram> QUdpSocket::receiveDatagrams(int maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%d, %lld)", maxCount, maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QVector<QNetworkDatagram>());
+
+    QVector<QNetworkDatagram> result;
+    if (maxCount <= 0)
+        return result;
+    const int readCount = d->socketEngine->readDatagrams(&result, maxCount, maxSize,
+                                                         QAbstractSocketEngine::WantAll);
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    if (readCount == -1)
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+    return result;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
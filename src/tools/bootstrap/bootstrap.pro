@@ -83,6 +83,7 @@ SOURCES += \
            ../../corelib/tools/qlocale.cpp \
            ../../corelib/tools/qlocale_tools.cpp \
            ../../corelib/tools/qmap.cpp \
+           ../../corelib/tools/qmemoryarena.cpp \
            ../../corelib/tools/qregexp.cpp \
            ../../corelib/tools/qringbuffer.cpp \
            ../../corelib/tools/qpoint.cpp \
@@ -174,6 +174,9 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption projectOption(QStringLiteral("project"), QStringLiteral("Output a resource file containing all files from the current directory."));
     parser.addOption(projectOption);
 
+    QCommandLineOption pathIndexOption(QStringLiteral("path-index"), QStringLiteral("Add a hash index of all resource paths for faster lookup."));
+    parser.addOption(pathIndexOption);
+
     QCommandLineOption formatVersionOption(QStringLiteral("format-version"), QStringLiteral("The RCC format version to write"), QStringLiteral("number"));
     parser.addOption(formatVersionOption);
 
@@ -232,6 +235,8 @@ int runRcc(int argc, char *argv[])
         library.setUseNameSpace(!library.useNameSpace());
     if (parser.isSet(verboseOption))
         library.setVerbose(true);
+    if (parser.isSet(pathIndexOption))
+        library.setPathIndex(true);
 
     const bool list = parser.isSet(listOption);
     const bool map = parser.isSet(mapOption);
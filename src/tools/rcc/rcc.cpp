@@ -37,10 +37,13 @@
 #include <qfile.h>
 #include <qiodevice.h>
 #include <qlocale.h>
+#include <qset.h>
 #include <qstack.h>
+#include <qvarlengtharray.h>
 #include <qxmlstream.h>
 
 #include <algorithm>
+#include <numeric>
 
 #if QT_CONFIG(zstd)
 #  include <zstd.h>
@@ -106,7 +109,8 @@ public:
         NoFlags = 0x00,
         Compressed = 0x01,
         Directory = 0x02,
-        CompressedZstd = 0x04
+        CompressedZstd = 0x04,
+        PathIndex = 0x08        // root only
     };
 
     RCCFileInfo(const QString &name = QString(), const QFileInfo &fileInfo = QFileInfo(),
@@ -445,6 +449,7 @@ RCCResourceLibrary::RCCResourceLibrary(quint8 formatVersion)
     m_dataOffset(0),
     m_overallFlags(0),
     m_useNameSpace(CONSTANT_USENAMESPACE),
+    m_pathIndex(false),
     m_errorDevice(0),
     m_outDevice(0),
     m_formatVersion(formatVersion)
@@ -1147,6 +1152,99 @@ struct qt_rcc_compare_hash
     }
 };
 
+// must match qresource.cpp
+static uint qt_resource_path_hash(QStringView path, uint seed)
+{
+    uint h = 2166136261u ^ seed;
+    for (QChar c : path)
+        h = (h ^ c.unicode()) * 16777619u;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+/*
+    Builds a perfect hash of the full paths (without leading slash) of the
+    tree nodes, using "hash and displace": the keys are distributed into
+    buckets by their unseeded hash, and for each bucket, largest first, we
+    search a seed that sends all its keys to free slots.
+
+    The index is a list of 32-bit words:
+        slot count, bucket count,
+        one seed per bucket,
+        one (node, unseeded hash) pair per slot, node 0 marking a free slot,
+        the parent of every node, used by QResource to verify a match.
+*/
+static QVector<quint32> buildPathIndex(const QStringList &keys, const QVector<int> &keyNodes,
+                                       const QVector<int> &parents)
+{
+    const int keyCount = keys.size();
+    QVector<uint> hashes(keyCount);
+    for (int i = 0; i < keyCount; ++i)
+        hashes[i] = qt_resource_path_hash(keys.at(i), 0);
+
+    const int bucketCount = qMax(1, keyCount / 4);
+    QVector<QVector<int>> buckets(bucketCount);
+    for (int i = 0; i < keyCount; ++i)
+        buckets[int(hashes.at(i) % uint(bucketCount))].append(i);
+    QVector<int> order(bucketCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](int a, int b) {
+        return buckets.at(a).size() > buckets.at(b).size();
+    });
+
+    for (uint slotCount = uint(keyCount + keyCount / 4 + 1); slotCount < uint(4 * keyCount + 16);
+         slotCount += slotCount / 8) {
+        QVector<quint32> seeds(bucketCount, 0);
+        QVector<int> slotKeys(int(slotCount), -1);
+        QVarLengthArray<uint, 32> taken;
+        bool ok = true;
+        for (int b : qAsConst(order)) {
+            const QVector<int> &bucket = buckets.at(b);
+            if (bucket.isEmpty())
+                break;
+            quint32 seed = 1;
+            for ( ; seed < (1u << 16); ++seed) {
+                taken.clear();
+                for (int key : bucket) {
+                    const uint slot = qt_resource_path_hash(keys.at(key), seed) % slotCount;
+                    if (slotKeys.at(int(slot)) != -1 || std::find(taken.cbegin(), taken.cend(), slot) != taken.cend())
+                        break;
+                    taken.append(slot);
+                }
+                if (taken.size() == bucket.size())
+                    break;
+            }
+            if (seed == (1u << 16)) {
+                ok = false;
+                break;
+            }
+            seeds[b] = seed;
+            for (int i = 0; i < bucket.size(); ++i)
+                slotKeys[int(taken.at(i))] = bucket.at(i);
+        }
+        if (!ok)
+            continue;
+
+        QVector<quint32> index;
+        index.reserve(2 + bucketCount + 2 * int(slotCount) + parents.size());
+        index << slotCount << quint32(bucketCount) << seeds;
+        for (int key : qAsConst(slotKeys)) {
+            if (key == -1)
+                index << 0 << 0;
+            else
+                index << quint32(keyNodes.at(key)) << hashes.at(key);
+        }
+        for (int parent : parents)
+            index << quint32(parent);
+        return index;
+    }
+    return QVector<quint32>();
+}
+
 bool RCCResourceLibrary::writeDataStructure()
 {
     if (m_format == C_Code || m_format == Pass1)
@@ -1158,6 +1256,19 @@ bool RCCResourceLibrary::writeDataStructure()
     if (!m_root)
         return false;
 
+    // for the path index: the node index and path of every directory, the
+    // parent of every node, and each distinct path (the first locale wins)
+    struct IndexedDirectory { int node; QString path; };
+    QHash<const RCCFileInfo *, IndexedDirectory> directories;
+    QVector<int> parents;
+    QStringList keys;
+    QVector<int> keyNodes;
+    QSet<QString> seenKeys;
+    if (m_pathIndex) {
+        directories.insert(m_root, IndexedDirectory{0, QString()});
+        parents.append(0);
+    }
+
     //calculate the child offsets (flat)
     pending.push(m_root);
     int offset = 1;
@@ -1172,12 +1283,36 @@ bool RCCResourceLibrary::writeDataStructure()
         //write out the actual data now
         for (int i = 0; i < m_children.size(); ++i) {
             RCCFileInfo *child = m_children.at(i);
+            if (m_pathIndex) {
+                const IndexedDirectory parent = directories.value(file);
+                const QString key = parent.node ? parent.path + QLatin1Char('/') + child->m_name
+                                                : child->m_name;
+                if (child->m_flags & RCCFileInfo::Directory)
+                    directories.insert(child, IndexedDirectory{offset, key});
+                if (!seenKeys.contains(key)) {
+                    seenKeys.insert(key);
+                    keys.append(key);
+                    keyNodes.append(offset);
+                }
+                parents.append(parent.node);
+            }
             ++offset;
             if (child->m_flags & RCCFileInfo::Directory)
                 pending.push(child);
         }
     }
 
+    QVector<quint32> index;
+    if (m_pathIndex) {
+        index = buildPathIndex(keys, keyNodes, parents);
+        if (index.isEmpty()) {
+            m_errorDevice->write("RCC: Warning: Unable to build the path index\n");
+        } else {
+            m_root->m_flags |= RCCFileInfo::PathIndex;
+            m_root->m_nameOffset = offset * (14 + (m_formatVersion >= 2 ? 8 : 0));
+        }
+    }
+
     //write out the structure (ie iterate again!)
     pending.push(m_root);
     m_root->writeDataInfo(*this);
@@ -1196,6 +1331,20 @@ bool RCCResourceLibrary::writeDataStructure()
                 pending.push(child);
         }
     }
+
+    if (!index.isEmpty()) {
+        const bool text = m_format == C_Code || m_format == Pass1;
+        if (text)
+            writeString("  // path index\n  ");
+        for (int i = 0; i < index.size(); ++i) {
+            writeNumber4(index.at(i));
+            if (text && i % 4 == 3)
+                writeString("\n  ");
+        }
+        if (text)
+            writeChar('\n');
+    }
+
     if (m_format == C_Code || m_format == Pass1)
         writeString("\n};\n\n");
 
@@ -102,6 +102,9 @@ public:
     void setResourceRoot(const QString &root) { m_resourceRoot = root; }
     QString resourceRoot() const { return m_resourceRoot; }
 
+    void setPathIndex(bool b) { m_pathIndex = b; }
+    bool pathIndex() const { return m_pathIndex; }
+
     void setUseNameSpace(bool v) { m_useNameSpace = v; }
     bool useNameSpace() const { return m_useNameSpace; }
 
@@ -163,6 +166,7 @@ private:
     int m_dataOffset;
     quint32 m_overallFlags;
     bool m_useNameSpace;
+    bool m_pathIndex;
     QStringList m_failedResources;
     QIODevice *m_errorDevice;
     QIODevice *m_outDevice;